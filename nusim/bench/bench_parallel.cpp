@@ -0,0 +1,147 @@
+/// \file
+/// \brief Benchmark of the parallel update phase of a nusim tick against the thread count:
+/// the physics step with obstacle collisions, plus filling the transforms, spread over a
+/// WorkerPool. Prints the time per tick and the speedup over one thread, and checks that every
+/// thread count ends in exactly the same state as one thread.
+///
+/// It also counts the heap allocations of the ticks after the first, on every thread, which
+/// must be zero, and exits with 1 if they are not. The tick_allocations test checks the whole
+/// tick, publishing included, on one thread.
+///
+/// Needs no roscore: nothing is published.
+///
+/// Usage: rosrun nusim bench_parallel [max threads] [ticks]
+/// The default max threads is the hardware thread count, and at least 2.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ros/time.h"
+#include "nusim/fleet.hpp"
+#include "nusim/worker_pool.hpp"
+
+namespace{
+    /// \brief heap allocations so far, counted by the operator new below
+    std::atomic<long unsigned int> allocations{0};
+
+    /// \brief robots per range handed to a worker thread, as in the node
+    constexpr std::size_t robots_per_chunk = 64;
+
+    /// \brief a fleet of n robots on a grid, each driving its own circle, among a few obstacles
+    void build(nusim::Fleet & fleet, long unsigned int n){
+        for(long unsigned int i = 0; i < n; i++){
+            const std::size_t r = fleet.add("robot" + std::to_string(i), 0.5*(i%256), 0.5*(i/256), 0.0);
+            fleet.state(r).v = 0.2;
+            fleet.state(r).w = 0.5 + 0.001*(i%100);
+        }
+        for(int k = 0; k < 16; k++){
+            fleet.add_obstacle({4.0*k, 0.5*k + 0.2, 0.1});
+        }
+    }
+
+    /// \brief one tick of the node without its publish calls: the parallel update phase,
+    /// then the joint states stamped on the calling thread
+    void tick(nusim::Fleet & fleet, nusim::WorkerPool & pool, const ros::Time & stamp){
+        pool.run(fleet.size(), robots_per_chunk, [&](std::size_t begin, std::size_t end){
+            fleet.step(begin, end, 1.0/5000.0);
+            fleet.fill_transforms(begin, end, stamp);
+        });
+        for(std::size_t i = 0; i < fleet.size(); i++){
+            fleet.joint_state(i, stamp);
+        }
+    }
+
+    /// \brief run ticks on a pool, after one untimed tick to warm up
+    /// \param allocs - set to the heap allocations of the timed ticks
+    /// \returns the mean time per tick, in microseconds
+    double us_per_tick(nusim::Fleet & fleet, nusim::WorkerPool & pool, long unsigned int ticks, long unsigned int & allocs){
+        const ros::Time stamp(1.0);
+        tick(fleet, pool, stamp);
+        const long unsigned int before = allocations.load();
+        const auto start = std::chrono::steady_clock::now();
+        for(long unsigned int t = 1; t < ticks; t++){
+            tick(fleet, pool, stamp);
+        }
+        const auto stop = std::chrono::steady_clock::now();
+        allocs = allocations.load() - before;
+        return std::chrono::duration<double, std::micro>(stop - start).count()/std::max(ticks - 1, 1lu);
+    }
+
+    /// \brief whether two fleets are in bit-for-bit the same state
+    bool same(nusim::Fleet & a, nusim::Fleet & b){
+        for(std::size_t i = 0; i < a.size(); i++){
+            const nusim::RobotState & s = a.state(i);
+            const nusim::RobotState & t = b.state(i);
+            if(std::memcmp(&s.x, &t.x, sizeof(double)) || std::memcmp(&s.y, &t.y, sizeof(double))
+               || std::memcmp(&s.theta, &t.theta, sizeof(double)) || s.collided != t.collided){
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char * argv[]){
+
+    //At least two threads by default, so a single-core machine still shows what the pool costs
+    const unsigned hardware = std::thread::hardware_concurrency();
+    const unsigned max_threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : std::max(2u, hardware);
+    const long unsigned int ticks = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200;
+
+    long unsigned int allocs = 0;
+    long unsigned int total_allocs = 0;
+    std::printf("%u hardware threads, %lu ticks per run\n", hardware, ticks);
+    std::printf("%8s %8s %12s %9s %10s %12s %8s\n", "robots", "threads", "us/tick", "speedup", "collided", "identical", "allocs");
+    for(long unsigned int n = 1000; n <= 100000; n *= 10){
+        nusim::Fleet reference;
+        build(reference, n);
+        nusim::WorkerPool serial(1);
+        const double base = us_per_tick(reference, serial, ticks, allocs);
+        total_allocs += allocs;
+        std::size_t collided = 0;
+        for(std::size_t i = 0; i < reference.size(); i++){
+            collided += reference.state(i).collided;
+        }
+        std::printf("%8lu %8u %12.1f %9.2f %10zu %12s %8lu\n", n, 1u, base, 1.0, collided, "-", allocs);
+
+        //Doubling thread counts, and the largest
+        for(unsigned threads = 2; threads <= max_threads; threads = threads == max_threads ? threads + 1 : std::min(2*threads, max_threads)){
+            nusim::Fleet fleet;
+            build(fleet, n);
+            nusim::WorkerPool pool(threads);
+            const double us = us_per_tick(fleet, pool, ticks, allocs);
+            total_allocs += allocs;
+            std::printf("%8lu %8u %12.1f %9.2f %10s %12s %8lu\n",
+                        n, threads, us, base/us, "", same(reference, fleet) ? "yes" : "NO", allocs);
+        }
+    }
+    if(total_allocs != 0){
+        std::printf("%lu heap allocations in steady-state ticks, expected none\n", total_allocs);
+        return 1;
+    }
+    return 0;
+}
+
+// Counting replacements for the global allocation functions
+void * operator new(std::size_t size){
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if(void * p = std::malloc(size ? size : 1)){
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void * p) noexcept{
+    std::free(p);
+}
+
+void operator delete(void * p, std::size_t) noexcept{
+    std::free(p);
+}
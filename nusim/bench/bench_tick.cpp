@@ -0,0 +1,69 @@
+/// \file
+/// \brief Benchmark of the cost of one nusim tick against the number of robots: the physics
+/// step, filling the transforms, and broadcasting them in one sendTransform call against one
+/// call per robot (what one node per robot amounts to).
+///
+/// Needs a running roscore, as the broadcaster advertises /tf.
+///
+/// Usage: rosrun nusim bench_tick [max robots] [ticks]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "ros/ros.h"
+#include "tf2_ros/transform_broadcaster.h"
+#include "nusim/fleet.hpp"
+
+namespace{
+    /// \brief time a callable over a number of ticks
+    /// \returns the mean time per tick, in microseconds
+    template<class F>
+    double us_per_tick(long unsigned int ticks, F && f){
+        const auto start = std::chrono::steady_clock::now();
+        for(long unsigned int t = 0; t < ticks; t++){
+            f();
+        }
+        const auto stop = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::micro>(stop - start).count()/ticks;
+    }
+}
+
+int main(int argc, char * argv[]){
+
+    ros::init(argc, argv, "bench_tick");
+    ros::NodeHandle nh;
+    const long unsigned int max_robots = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+    const long unsigned int ticks = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000;
+
+    tf2_ros::TransformBroadcaster b;
+    std::printf("%8s %10s %10s %12s %12s %10s\n", "robots", "step us", "fill us", "batched us", "per-robot us", "us/robot");
+    for(long unsigned int n = 1; n <= max_robots; n *= 10){
+        //Robots on a grid, each driving its own circle
+        nusim::Fleet fleet;
+        for(long unsigned int i = 0; i < n; i++){
+            const std::size_t r = fleet.add("robot" + std::to_string(i), 0.5*(i%32), 0.5*(i/32), 0.0);
+            fleet.state(r).v = 0.1;
+            fleet.state(r).w = 0.2 + 0.001*i;
+        }
+
+        const double step = us_per_tick(ticks, [&]{
+            fleet.step(1.0/5000.0);
+        });
+        const double fill = us_per_tick(ticks, [&]{
+            fleet.transforms(ros::Time::now());
+        });
+        const double batched = us_per_tick(ticks, [&]{
+            b.sendTransform(fleet.transforms(ros::Time::now()));
+        });
+        const double per_robot = us_per_tick(ticks, [&]{
+            for(const geometry_msgs::TransformStamped & ts : fleet.transforms(ros::Time::now())){
+                b.sendTransform(ts);
+            }
+        });
+        std::printf("%8lu %10.2f %10.2f %12.2f %12.2f %10.3f\n",
+                    n, step, fill, batched, per_robot, (step + batched)/n);
+    }
+    return 0;
+}
@@ -0,0 +1,184 @@
+#ifndef FLEET_INCLUDE_GUARD_HPP
+#define FLEET_INCLUDE_GUARD_HPP
+/// \file
+/// \brief The robots of one simulation, stored contiguously and stepped together.
+///
+/// The per-robot state the physics touches every step lives in one array. The outgoing
+/// messages are built once when a robot is added: the names in them never change, and every
+/// publish only rewrites stamps and poses, so the transforms of the whole fleet go out as
+/// one /tf message. Nothing after add() allocates.
+///
+/// Stepping and filling the messages work on ranges of robots, so that a WorkerPool can
+/// split them across threads. A robot's update reads the obstacles and writes only its own
+/// state and messages, so the results do not depend on how the robots are split.
+
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "ros/time.h"
+#include "geometry_msgs/TransformStamped.h"
+#include "tf2_msgs/TFMessage.h"
+#include "sensor_msgs/JointState.h"
+
+namespace nusim
+{
+
+    /// \brief the simulated state of one robot
+    struct RobotState
+    {
+        /// \brief x position in the world frame
+        double x = 0.0;
+
+        /// \brief y position in the world frame
+        double y = 0.0;
+
+        /// \brief heading in the world frame, in [-pi, pi]
+        double theta = 0.0;
+
+        /// \brief forward velocity, m/s
+        double v = 0.0;
+
+        /// \brief angular velocity, rad/s
+        double w = 0.0;
+
+        /// \brief whether the last step ran into an obstacle (and was undone)
+        bool collided = false;
+    };
+
+    /// \brief a cylindrical obstacle
+    struct Obstacle
+    {
+        /// \brief x position in the world frame
+        double x;
+
+        /// \brief y position in the world frame
+        double y;
+
+        /// \brief radius
+        double r;
+    };
+
+    /// \brief N robots, each with frames <name>-base_footprint and joints <name>-wheel_left_joint
+    /// and <name>-wheel_right_joint
+    class Fleet
+    {
+    public:
+        /// \brief add a robot at rest
+        /// \param name - the robot name (its color), the prefix of its frame and joint names
+        /// \param x - start x position in the world frame
+        /// \param y - start y position in the world frame
+        /// \param theta - start heading in the world frame
+        /// \returns the index of the robot
+        std::size_t add(const std::string & name, double x, double y, double theta);
+
+        /// \brief the number of robots
+        std::size_t size() const
+        {
+            return states.size();
+        }
+
+        /// \brief the index of a robot
+        /// \param name - the robot name
+        /// \returns its index, or size() if there is no robot of that name
+        std::size_t find(const std::string & name) const;
+
+        /// \brief the name of a robot
+        const std::string & name(std::size_t i) const
+        {
+            return names[i];
+        }
+
+        /// \brief the state of a robot
+        RobotState & state(std::size_t i)
+        {
+            return states[i];
+        }
+
+        /// \brief add an obstacle the robots collide with
+        void add_obstacle(const Obstacle & obstacle)
+        {
+            obstacles.push_back(obstacle);
+        }
+
+        /// \brief set the radius of every robot's collision circle
+        void set_robot_radius(double r)
+        {
+            robot_radius = r;
+        }
+
+        /// \brief put every robot back at its start pose, at rest
+        void reset();
+
+        /// \brief advance robots by one physics step along their velocities
+        /// A robot whose step would end inside an obstacle stays where it was.
+        /// \param begin - the first robot
+        /// \param end - one past the last robot
+        /// \param dt - the step, in seconds
+        void step(std::size_t begin, std::size_t end, double dt);
+
+        /// \brief advance every robot by one physics step
+        /// \param dt - the step, in seconds
+        void step(double dt)
+        {
+            step(0, size(), dt);
+        }
+
+        /// \brief write the poses of robots into their transforms
+        /// \param begin - the first robot
+        /// \param end - one past the last robot
+        /// \param stamp - the time to stamp them with
+        void fill_transforms(std::size_t begin, std::size_t end, const ros::Time & stamp);
+
+        /// \brief the world to base_footprint transform of every robot, for one sendTransform call
+        /// \returns the transforms as last filled
+        const std::vector<geometry_msgs::TransformStamped> & transforms() const
+        {
+            return tf_msg.transforms;
+        }
+
+        /// \brief the transforms as last filled, as the message published on /tf
+        const tf2_msgs::TFMessage & tf_message() const
+        {
+            return tf_msg;
+        }
+
+        /// \brief fill every transform and return them
+        /// \param stamp - the time to stamp them with
+        const std::vector<geometry_msgs::TransformStamped> & transforms(const ros::Time & stamp)
+        {
+            fill_transforms(0, size(), stamp);
+            return tf_msg.transforms;
+        }
+
+        /// \brief the joint states of a robot
+        /// \param i - the robot index
+        /// \param stamp - the time to stamp them with
+        const sensor_msgs::JointState & joint_state(std::size_t i, const ros::Time & stamp);
+
+    private:
+        /// \brief the state of every robot, stepped together
+        std::vector<RobotState> states;
+
+        /// \brief where reset() puts every robot
+        std::vector<RobotState> starts;
+
+        /// \brief the robot names
+        std::vector<std::string> names;
+
+        /// \brief the obstacles
+        std::vector<Obstacle> obstacles;
+
+        /// \brief the radius of every robot's collision circle
+        double robot_radius = 0.105;
+
+        /// \brief the transforms of every robot, frame names filled in, in the message /tf carries
+        tf2_msgs::TFMessage tf_msg;
+
+        /// \brief the joint state message of every robot, joint names filled in
+        std::vector<sensor_msgs::JointState> joints;
+    };
+
+}
+
+#endif
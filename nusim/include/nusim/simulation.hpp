@@ -0,0 +1,160 @@
+#ifndef SIMULATION_INCLUDE_GUARD_HPP
+#define SIMULATION_INCLUDE_GUARD_HPP
+/// \file
+/// \brief One tick of the nusim node: the physics step of the fleet and the outputs due on it.
+///
+/// The simulation advances in fixed steps at a physics rate. Each output is published every
+/// n-th step, n chosen from its own rate, so raising the physics rate does not raise the
+/// message load. Every stats period the tick logs, per stream, how often it published, how
+/// long publishing took, and the CPU time saved against publishing on every step.
+///
+/// Every message is built in the constructor, names included, and a tick only writes stamps,
+/// poses and counters into it, so a tick does not allocate. roscpp skips serialization on a
+/// topic with no subscribers; with subscribers it serializes into a buffer it allocates.
+/// The tick_allocations test checks this, publishing included.
+
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+#include "ros/ros.h"
+#include "rosgraph_msgs/Clock.h"
+#include "std_msgs/UInt64.h"
+#include "visualization_msgs/MarkerArray.h"
+#include "nusim/fleet.hpp"
+#include "nusim/worker_pool.hpp"
+
+namespace nusim
+{
+
+    /// \brief what paces the physics steps
+    enum class Mode
+    {
+        realtime, ///< one step every 1/rate seconds of wall time, messages stamped with wall time
+        freerun,  ///< steps as fast as the CPU allows, stamped with simulation time
+        lockstep  ///< steps only when asked, stamped with simulation time
+    };
+
+    /// \brief an output produced every decimation-th physics step, and what it cost
+    struct Stream
+    {
+        /// \brief the name in the timing report
+        const char * name;
+
+        /// \brief physics steps between publishes, 0 if the stream is off
+        long unsigned int decimation;
+
+        /// \brief publishes since the last report
+        long unsigned int count = 0;
+
+        /// \brief seconds spent publishing since the last report
+        double busy = 0.0;
+
+        /// \brief the longest publish since the last report, in seconds
+        double worst = 0.0;
+    };
+
+    /// \brief physics steps between publishes for a publish rate
+    /// \param physics_rate - steps per second
+    /// \param publish_rate - publishes per second, 0 or less for none
+    /// \returns the decimation, at least 1, or 0 for none
+    long unsigned int decimation(double physics_rate, double publish_rate);
+
+    /// \brief publishes per second of each output, 0 for none
+    struct PublishRates
+    {
+        /// \brief the world to <name>-base_footprint transforms
+        double tf;
+
+        /// \brief the joint states of every robot
+        double joint_states;
+
+        /// \brief the timestep
+        double timestep;
+
+        /// \brief the obstacle markers, 0 to publish them once, latched
+        double markers;
+
+        /// \brief /clock, in simulated time (not published in realtime mode)
+        double clock;
+    };
+
+    /// \brief the publishers, messages and counters of a running simulation
+    class Simulation
+    {
+    public:
+        /// \brief advertise every output and publish the markers once
+        /// \param nh - the node's private handle; the timestep and markers are advertised under it
+        /// \param fleet - the robots, all added
+        /// \param pool - the threads that step them
+        /// \param mode - what paces the steps, which decides the stamps and whether /clock is published
+        /// \param rate - physics steps per second
+        /// \param rates - publishes per second of each output
+        /// \param stats_period - seconds between timing reports, 0 for none
+        /// \param markers - the obstacle markers, published on ~obstacles
+        Simulation(ros::NodeHandle & nh, Fleet & fleet, WorkerPool & pool, Mode mode, int rate,
+                   const PublishRates & rates, double stats_period, const visualization_msgs::MarkerArray & markers);
+
+        /// \brief run one physics step of every robot and publish what is due on it
+        void tick();
+
+        /// \brief run the queued ROS callbacks, timed as a stream of its own
+        void spin_once();
+
+        /// \brief the timestep the next tick publishes: the steps since the start or the last reset
+        long unsigned int timestep() const
+        {
+            return counter;
+        }
+
+        /// \brief put the timestep back to 0 and every robot at its start; the clock keeps running
+        void reset();
+
+    private:
+        /// \brief the stamp for the messages of the current step
+        ros::Time stamp() const;
+
+        /// \brief log the statistics of every stream and start new ones
+        /// \param seconds - wall time since the last report
+        void report(double seconds);
+
+        enum {PHYSICS, TF, JOINTS, TIMESTEP, MARKERS, CLOCK, CALLBACKS, STREAMS};
+
+        Fleet & fleet;
+        WorkerPool & pool;
+        Mode mode;
+        int rate;
+        double stats_period;
+
+        /// \brief every output and the physics step itself
+        Stream streams[STREAMS];
+
+        /// \brief the timestep, sent back to 0 by reset()
+        long unsigned int counter = 0;
+
+        /// \brief steps since start; reset() does not send it back, so the clock never runs backwards
+        long unsigned int steps_total = 0;
+
+        /// \brief steps_total at the last report
+        long unsigned int reported_at = 0;
+
+        /// \brief wall time of the last report
+        std::chrono::steady_clock::time_point report_start;
+
+        ros::Publisher tf_pub;
+        ros::Publisher marker_pub;
+        ros::Publisher count_pub;
+        ros::Publisher clock_pub;
+        std::vector<ros::Publisher> joint_pubs;
+
+        /// \brief the markers, restamped when republished
+        visualization_msgs::MarkerArray marker_array;
+
+        /// \brief messages reused by every publish: a tick only writes the fields that change
+        rosgraph_msgs::Clock clock;
+        std_msgs::UInt64 num;
+    };
+
+}
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef WORKER_POOL_INCLUDE_GUARD_HPP
+#define WORKER_POOL_INCLUDE_GUARD_HPP
+/// \file
+/// \brief A fixed pool of threads that splits a range of work items with work stealing.
+///
+/// run() cuts [0, n) into chunks and gives every thread (the calling one included) an equal
+/// share. A thread takes chunks from the front of its own share. Once that is empty, it steals
+/// the back half of the largest share left. Chunks are uneven in cost when robots collide or
+/// publish; stealing is there to keep the threads busy to the end of the tick. No speedup has
+/// been measured yet: the one recorded run, in the README, is on a single hardware thread.
+///
+/// Which thread runs an item changes from run to run, so the work must not depend on it:
+/// each item may only write its own outputs. Then the results are the same for any thread count.
+///
+/// Workers spin for a short while between runs and then sleep on a condition variable, so
+/// back-to-back ticks do not pay for a wake-up. run() does not allocate.
+
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace nusim
+{
+
+    /// \brief threads that run a function over ranges of items
+    class WorkerPool
+    {
+    public:
+        /// \brief start the threads
+        /// \param thread_count - threads to run on, the caller of run() included; 0 for one per hardware thread
+        explicit WorkerPool(unsigned thread_count = 0);
+
+        /// \brief stop and join the threads
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool &) = delete;
+        WorkerPool & operator=(const WorkerPool &) = delete;
+
+        /// \brief the number of threads, the caller of run() included
+        unsigned size() const
+        {
+            return count;
+        }
+
+        /// \brief call f(begin, end) over [0, n) in ranges of at most chunk items, and return when all are done
+        /// A run has at most 2^32 - 1 ranges, as their indices are packed in 32 bits; if n/chunk is
+        /// larger than that, the ranges are made just long enough to fit.
+        /// \param n - the number of items
+        /// \param chunk - the items per range, at least 1
+        /// \param f - a callable taking (std::size_t begin, std::size_t end); called from several threads at once
+        template<class F>
+        void run(std::size_t n, std::size_t chunk, F && f)
+        {
+            using Fn = typename std::remove_reference<F>::type;
+            run_erased(n, chunk, [](void * context, std::size_t begin, std::size_t end){
+                (*static_cast<Fn *>(context))(begin, end);
+            }, &f);
+        }
+
+    private:
+        /// \brief the chunks left in one thread's share, [begin, end) packed in one word so
+        /// that the owner and thieves can take from it with a single compare-and-swap
+        struct alignas(64) Share
+        {
+            std::atomic<std::uint64_t> range{0};
+        };
+
+        /// \brief run() without the template
+        void run_erased(std::size_t n, std::size_t chunk, void (*call)(void *, std::size_t, std::size_t), void * context);
+
+        /// \brief take chunks until none are left anywhere, starting with thread self's share
+        void drain(unsigned self);
+
+        /// \brief what a worker thread does: wait for a run, drain, report, repeat
+        void work(unsigned self);
+
+        /// \brief the number of threads, the caller of run() included
+        unsigned count;
+
+        /// \brief every thread's share; share 0 is the caller's
+        std::unique_ptr<Share[]> shares;
+
+        /// \brief the worker threads (size() - 1 of them)
+        std::vector<std::thread> threads;
+
+        /// \brief the function of the current run
+        void (*call)(void *, std::size_t, std::size_t) = nullptr;
+
+        /// \brief the callable it calls
+        void * context = nullptr;
+
+        /// \brief the number of items of the current run
+        std::size_t items = 0;
+
+        /// \brief the items per chunk of the current run
+        std::size_t chunk_items = 1;
+
+        /// \brief incremented to start a run
+        std::atomic<std::uint64_t> generation{0};
+
+        /// \brief workers done with the current run
+        std::atomic<unsigned> finished{0};
+
+        /// \brief set to stop the workers
+        std::atomic<bool> stopping{false};
+
+        /// \brief guards the sleep of workers that have stopped spinning
+        std::mutex mutex;
+
+        /// \brief wakes the sleeping workers for a run or to stop
+        std::condition_variable wake;
+    };
+
+}
+
+#endif
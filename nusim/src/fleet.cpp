@@ -0,0 +1,92 @@
+#include "nusim/fleet.hpp"
+#include <cmath>
+
+/// \file
+/// \brief Implementation file for the simulated fleet
+
+namespace nusim
+{
+    std::size_t Fleet::add(const std::string & name, double x, double y, double theta){
+        RobotState start;
+        start.x = x;
+        start.y = y;
+        start.theta = std::remainder(theta, 2.0*M_PI);
+        states.push_back(start);
+        starts.push_back(start);
+        names.push_back(name);
+
+        geometry_msgs::TransformStamped ts;
+        ts.header.frame_id = "world";
+        ts.child_frame_id = name + "-base_footprint";
+        ts.transform.translation.z = 0.0;
+        ts.transform.rotation.x = 0.0;
+        ts.transform.rotation.y = 0.0;
+        tf_msg.transforms.push_back(ts);
+
+        sensor_msgs::JointState state;
+        state.name = {name + "-wheel_left_joint", name + "-wheel_right_joint"};
+        state.position = {0.0, 0.0};
+        state.velocity = {0.0, 0.0};
+        state.effort = {0.0, 0.0};
+        joints.push_back(state);
+        return states.size() - 1;
+    }
+
+    std::size_t Fleet::find(const std::string & name) const{
+        for(std::size_t i = 0; i < names.size(); i++){
+            if(names[i] == name){
+                return i;
+            }
+        }
+        return names.size();
+    }
+
+    void Fleet::reset(){
+        states = starts;
+    }
+
+    void Fleet::step(std::size_t begin, std::size_t end, double dt){
+        for(std::size_t i = begin; i < end; i++){
+            RobotState & r = states[i];
+
+            //Exact for a constant twist: the chord of the arc, along the mean heading
+            const double half = 0.5*r.w*dt;
+            const double chord = std::abs(half) < 1e-9 ? r.v*dt : r.v*dt*std::sin(half)/half;
+            const double x = r.x + chord*std::cos(r.theta + half);
+            const double y = r.y + chord*std::sin(r.theta + half);
+
+            r.collided = false;
+            for(const Obstacle & o : obstacles){
+                const double reach = robot_radius + o.r;
+                if((x - o.x)*(x - o.x) + (y - o.y)*(y - o.y) < reach*reach){
+                    r.collided = true;
+                    break;
+                }
+            }
+            if(!r.collided){
+                r.x = x;
+                r.y = y;
+                r.theta = std::remainder(r.theta + 2.0*half, 2.0*M_PI);
+            }
+        }
+    }
+
+    void Fleet::fill_transforms(std::size_t begin, std::size_t end, const ros::Time & stamp){
+        for(std::size_t i = begin; i < end; i++){
+            geometry_msgs::TransformStamped & ts = tf_msg.transforms[i];
+            ts.header.stamp = stamp;
+            ts.transform.translation.x = states[i].x;
+            ts.transform.translation.y = states[i].y;
+
+            //A rotation about z only: the half angle gives the quaternion directly, without setRPY
+            const double half = 0.5*states[i].theta;
+            ts.transform.rotation.z = std::sin(half);
+            ts.transform.rotation.w = std::cos(half);
+        }
+    }
+
+    const sensor_msgs::JointState & Fleet::joint_state(std::size_t i, const ros::Time & stamp){
+        joints[i].header.stamp = stamp;
+        return joints[i];
+    }
+}
@@ -1,65 +1,143 @@
 
 
+#include <cmath>
+#include <string>
 #include "ros/ros.h"
-#include "std_msgs/UInt64.h"
+#include "ros/callback_queue.h"
 #include "std_srvs/Empty.h"
 #include "nusim/Tele.h"
-#include "sensor_msgs/JointState.h"
-#include "tf2/LinearMath/Quaternion.h"
-#include "tf2_ros/transform_broadcaster.h"
-#include "geometry_msgs/TransformStamped.h"
+#include "nusim/Step.h"
+#include "geometry_msgs/Twist.h"
 #include "visualization_msgs/Marker.h"
 #include "visualization_msgs/MarkerArray.h"
+#include "nusim/fleet.hpp"
+#include "nusim/simulation.hpp"
+#include "nusim/worker_pool.hpp"
 
 /// \file
 /// \brief This node runs the nusimulator. It loads in robot and obstacles into RVIZ
 ///
+/// Any number of robots run in the one node. They are stepped together, each along the
+/// velocities last sent on its cmd_vel topic, and the transforms of all of them go out in one
+/// /tf message per publish.
+///
+/// The per-step work of the robots (kinematics, obstacle collisions, and filling in their
+/// transforms when those are due) is split across ~threads threads. Each robot writes only
+/// its own state and messages, so the simulation is the same for any thread count.
+///
+/// The simulation advances in fixed steps at ~rate. Each output is published every n-th step,
+/// n chosen from its own rate, so raising the physics rate does not raise the message load.
+/// Every ~stats_period seconds the node logs, per stream, how often it published, how long
+/// publishing took, and the CPU time saved against publishing on every step.
+///
+/// ~mode chooses what paces the steps:
+///     realtime - one step every 1/rate seconds of wall time, messages stamped with wall time
+///     freerun - steps as fast as the CPU allows
+///     lockstep - steps only inside step service calls, and otherwise sleeps on the callback queue
+/// In freerun and lockstep the node publishes /clock, the simulation time (steps/rate), and
+/// stamps its messages with it; other nodes need /use_sim_time set to follow it, which the
+/// launch file does for those modes only.
+/// The timing report gives the real-time factor: simulated seconds per wall second.
+///
+/// Every message is built before the loop, names included, and each tick only writes stamps,
+/// poses and counters into it, so a tick does not allocate while nothing subscribes; once a
+/// node subscribes, roscpp serializes each message it is sent into a buffer it allocates.
+/// The tick_allocations test checks the tick, publishing included.
+///
 /// PARAMETERS:
-///     ~rate (integer): publishing rate
+///     ~robots/names (string list): robot names (colors), prefixing their frames, joints and topics
+///     ~robots/x0, ~robots/y0, ~robots/theta0 (double lists): start pose of each robot
+///     ~x0, ~y0, ~theta0 (double): start pose of a single robot named red, when ~robots/names is not set
+///     ~rate (integer): physics step rate
+///     ~threads (integer): threads for the per-step robot updates, 0 for one per core (default 1)
+///     ~robot_radius (double): radius of a robot's collision circle (default 0.105)
+///     ~publish_rates/tf (double): rate of the world to <name>-base_footprint transforms, default ~rate
+///     ~publish_rates/joint_states (double): rate of the joint states, default ~rate
+///     ~publish_rates/timestep (double): rate of the timestep, default ~rate
+///     ~publish_rates/markers (double): rate of the obstacle markers, 0 (default) to publish them once, latched
+///     ~stats_period (double): seconds between timing reports, 0 for none (default 5)
+///     ~mode (string): realtime (default), freerun or lockstep
+///     ~obstacles/x, ~obstacles/y, ~obstacles/r (double lists): cylindrical obstacles the robots collide with
+///     ~publish_rates/clock (double): rate of /clock in simulated time, default 1000 (freerun and lockstep only)
 /// PUBLISHES:
-///     ~timestep (std_msgs::UInt64): simulation timestep
-///     /red/joint_states (sensor_msgs::JointState): turtlebot jointstates
-///     transform_broadcaster between world and red:basefootprint
+///     /clock (rosgraph_msgs::Clock): simulation time (freerun and lockstep only)
+///     ~timestep (std_msgs::UInt64): simulation timestep, the number of physics steps before the latest one (from 0)
+///     /<name>/joint_states (sensor_msgs::JointState): turtlebot jointstates, per robot
+///     /tf (tf2_msgs::TFMessage): the transforms between world and <name>-base_footprint, for every robot
 /// SUBSCRIBES:
-///     No subscribers
+///     /<name>/cmd_vel (geometry_msgs::Twist): velocity of each robot, linear.x forward (m/s) and
+///         angular.z turning (rad/s), held until the next command; reset stops every robot
 /// SERVICES:
 ///     reset (std_srvs::Empty): This service resets the simulation
-///     tele (nusim::Tele): This service teleports the robot to x,y,theta defined by user
+///     tele (nusim::Tele): This service teleports a robot (the first if none is named) to x,y,theta defined by user
+///     step (nusim::Step): In lockstep mode, run a number of physics steps and return the timestep reached
 
 
 
 
 namespace{
-    int counter = 0;
-   
-    double x;
-    double y;
-    double theta;
-    
-    double xorigin;
-    double theta0;
-    double yorigin;
+    nusim::Mode mode = nusim::Mode::realtime;
+
+    /// \brief the simulated robots
+    nusim::Fleet fleet;
+
+    /// \brief the publishers and counters, set up by main()
+    nusim::Simulation * simulation = nullptr;
+
+    /// \brief the cmd_vel input of one robot
+    /// Callbacks run on the main thread between ticks, so they never race the worker threads.
+    struct VelocityInput
+    {
+        /// \brief the robot's index in the fleet
+        std::size_t robot;
+
+        /// \brief drive the robot at linear.x forward and angular.z turning
+        void command(const geometry_msgs::Twist::ConstPtr & twist){
+            nusim::RobotState & state = fleet.state(robot);
+            state.v = twist->linear.x;
+            state.w = twist->angular.z;
+        }
+    };
 }
 
     /// \brief reset simulation to start
     /// \returns boolean true upon completion of service
 bool reset(std_srvs::Empty::Request& , std_srvs::Empty::Response& ){
 
-    counter = 0;
-    x = xorigin;
-    y = yorigin;
-    theta = theta0;
+    simulation->reset();
+    return true;
+}
+
+    /// \brief run physics steps in lockstep mode, publishing as in the other modes
+    /// The steps run inside the call, so the caller gets its response once they are done.
+    /// \param request - the number of steps to run
+    /// \param response - the timestep after they have run: the one the next step will publish
+    /// \returns false outside lockstep mode
+bool step(nusim::Step::Request& request, nusim::Step::Response& response){
+
+    if(mode != nusim::Mode::lockstep){
+        return false;
+    }
+    for(long unsigned int k = 0; k < request.steps && ros::ok(); k++){
+        simulation->tick();
+    }
+    response.timestep = simulation->timestep();
     return true;
 }
 
-    /// \brief teleport the robot to an x,y,theta position in the world frame
-    /// \param request - x,y, theta coordinates to teleport to
-    /// \returns the angle in degrees
+    /// \brief teleport a robot to an x,y,theta position in the world frame
+    /// \param request - x,y, theta coordinates to teleport to, and the robot name (empty for the first)
+    /// \returns false if there is no robot of that name
 bool tele(nusim::Tele::Request& request, nusim::Tele::Response& ){
 
-    x = request.x;
-    y = request.y;
-    theta = request.t;
+    const std::size_t i = request.robot.empty() ? 0 : fleet.find(request.robot);
+    if(i >= fleet.size()){
+        return false;
+    }
+    nusim::RobotState & robot = fleet.state(i);
+    robot.x = request.x;
+    robot.y = request.y;
+    robot.theta = std::remainder(request.t, 2.0*M_PI);
     return true;
 }
 
@@ -72,6 +150,10 @@ int main(int argc, char * argv[]){
 
 
     int f;
+    int threads;
+    double robot_radius;
+    double stats_period;
+    std::string mode_name;
 
     long unsigned int i;
 
@@ -89,12 +171,50 @@ int main(int argc, char * argv[]){
 
     //Load in parameters from basic_world.yaml
     nh.param("rate", f, 500);
-    nh.param("x0", xorigin, 0.0);
-    nh.param("theta0", theta0, 0.0);
-    nh.param("y0",yorigin,0.0);
+
+    //Robots: a list, or the single red robot of the original parameters
+    vector<string> robot_names;
+    vector<double> robot_x, robot_y, robot_theta;
+    if(nh.getParam("robots/names", robot_names)){
+        nh.getParam("robots/x0", robot_x);
+        nh.getParam("robots/y0", robot_y);
+        nh.getParam("robots/theta0", robot_theta);
+        robot_x.resize(robot_names.size(), 0.0);
+        robot_y.resize(robot_names.size(), 0.0);
+        robot_theta.resize(robot_names.size(), 0.0);
+    } else {
+        robot_names = {"red"};
+        robot_x.resize(1);
+        robot_y.resize(1);
+        robot_theta.resize(1);
+        nh.param("x0", robot_x[0], 0.0);
+        nh.param("theta0", robot_theta[0], 0.0);
+        nh.param("y0", robot_y[0], 0.0);
+    }
+    for(i=0;i<robot_names.size();i++){
+        fleet.add(robot_names[i], robot_x[i], robot_y[i], robot_theta[i]);
+    }
+    nh.param("threads", threads, 1);
+    nh.param("robot_radius", robot_radius, 0.105);
+    fleet.set_robot_radius(robot_radius);
+    nh.param("stats_period", stats_period, 5.0);
+    nh.param("mode", mode_name, std::string("realtime"));
+    if(mode_name == "freerun"){
+        mode = nusim::Mode::freerun;
+    } else if(mode_name == "lockstep"){
+        mode = nusim::Mode::lockstep;
+    } else if(mode_name != "realtime"){
+        ROS_WARN("unknown mode %s, running in realtime", mode_name.c_str());
+    }
     nh.getParam("obstacles/x",o_x); //noservice needed, just read from the yaml file and create from the yaml
     nh.getParam("obstacles/y",o_y);
     nh.getParam("obstacles/r",o_r);        
+    for(i=0;i<o_x.size() && i<o_y.size() && i<o_r.size();i++){
+        fleet.add_obstacle({o_x[i], o_y[i], o_r[i]});
+    }
+
+    nusim::WorkerPool pool(threads > 0 ? threads : 0);
+    ROS_INFO("stepping %zu robots on %u threads", fleet.size(), pool.size());
 
     ros::Duration life(0);
 
@@ -132,20 +252,25 @@ int main(int argc, char * argv[]){
     }
 
 
-    x = xorigin;
-    y = yorigin;
-    theta = theta0;
-
-    ros::Publisher m_pub;
-    m_pub = nh.advertise<visualization_msgs::MarkerArray>("obstacles", 10, true);
-
-    m_pub.publish(m_array);
+    //One cmd_vel input per robot; reserved first, since the subscribers keep pointers into it
+    vector<VelocityInput> inputs;
+    vector<ros::Subscriber> cmd_subs;
+    inputs.reserve(fleet.size());
+    for(i=0;i<fleet.size();i++){
+        inputs.push_back({i});
+        cmd_subs.push_back(nh.subscribe("/" + fleet.name(i) + "/cmd_vel", 10, &VelocityInput::command, &inputs[i]));
+    }
 
-    ros::Publisher count_pub;
-    count_pub = nh.advertise<std_msgs::UInt64>("timestep", 10);
+    //Publish rates, decimated from the physics rate; by default everything but the markers publishes every step
+    nusim::PublishRates rates;
+    nh.param("publish_rates/tf", rates.tf, static_cast<double>(f));
+    nh.param("publish_rates/joint_states", rates.joint_states, static_cast<double>(f));
+    nh.param("publish_rates/timestep", rates.timestep, static_cast<double>(f));
+    nh.param("publish_rates/markers", rates.markers, 0.0);
+    nh.param("publish_rates/clock", rates.clock, 1000.0);
 
-    ros::Publisher joint_pub;
-    joint_pub = nh.advertise<sensor_msgs::JointState>("/red/joint_states", 10);
+    nusim::Simulation sim(nh, fleet, pool, mode, f, rates, stats_period, m_array);
+    simulation = &sim;
 
     ros::ServiceServer srv_reset;
     srv_reset = nh.advertiseService("reset", reset);
@@ -153,57 +278,27 @@ int main(int argc, char * argv[]){
     ros::ServiceServer srv_tele;
     srv_tele = nh.advertiseService("tele", tele);
 
-
-    //Source (01/17) start: https://github.com/wsnewman/davinci_wsn/blob/master/wsn_move_davinci_rviz/src/davinci_joint_state_publisher.cpp
-    sensor_msgs::JointState state;
-    state.name.push_back("red-wheel_left_joint");
-    state.name.push_back("red-wheel_right_joint");
-
-    state.position.push_back(0.0);
-    state.position.push_back(0.0);
-
-    state.velocity.push_back(0.0);
-    state.velocity.push_back(0.0);
-
-    state.effort.push_back(0.0);
-    state.effort.push_back(0.0);
-    //source end
-
-    tf2_ros::TransformBroadcaster b;
-    geometry_msgs::TransformStamped ts;
+    ros::ServiceServer srv_step;
+    srv_step = nh.advertiseService("step", step);
 
     ros::Rate rate(f);
 
     while(ros::ok()){
 
-        //Continuously broadcast transform
-        ts.header.stamp = ros::Time::now();
-        ts.header.frame_id = "world";
-        ts.child_frame_id = "red-base_footprint";
-        ts.transform.translation.x = x;
-        ts.transform.translation.y = y;
-        ts.transform.translation.z = 0;
-        tf2::Quaternion ang;
-        ang.setRPY(0,0,theta);
-        ts.transform.rotation.x = ang.x();
-        ts.transform.rotation.y = ang.y();
-        ts.transform.rotation.z = ang.z();;
-        ts.transform.rotation.w = ang.w();
-        b.sendTransform(ts);
-
-        state.header.stamp = ros::Time::now();
-
-        std_msgs::UInt64 num;
-        num.data = counter;
-        
-        //Publish joint states and timer
-        count_pub.publish(num);
-        counter++;
+        //In lockstep, block on the callback queue: the steps run inside the step service call.
+        //A queued callback wakes the wait at once, and shutdown disables the queue, which ends it;
+        //the timeout is only a bound in case it does not.
+        if(mode == nusim::Mode::lockstep){
+            ros::getGlobalCallbackQueue()->callAvailable(ros::WallDuration(1.0));
+            continue;
+        }
 
-        joint_pub.publish(state);
+        sim.tick();
+        sim.spin_once();
 
-        ros::spinOnce();
-        rate.sleep();
+        if(mode == nusim::Mode::realtime){
+            rate.sleep();
+        }
 
     }
     
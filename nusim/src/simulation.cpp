@@ -0,0 +1,177 @@
+#include "nusim/simulation.hpp"
+#include <algorithm>
+#include <cmath>
+#include "sensor_msgs/JointState.h"
+#include "tf2_msgs/TFMessage.h"
+
+/// \file
+/// \brief Implementation file for one tick of the simulation
+
+namespace
+{
+    /// \brief robots per range handed to a worker thread
+    constexpr std::size_t robots_per_chunk = 64;
+
+    /// \brief whether a stream publishes on a step
+    bool due(const nusim::Stream & stream, long unsigned int step){
+        return stream.decimation != 0 && step % stream.decimation == 0;
+    }
+
+    /// \brief run a publish and add its time to the stream statistics
+    template<class F>
+    void timed(nusim::Stream & stream, F && publish){
+        const auto start = std::chrono::steady_clock::now();
+        publish();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        stream.count++;
+        stream.busy += seconds;
+        stream.worst = std::max(stream.worst, seconds);
+    }
+}
+
+namespace nusim
+{
+    long unsigned int decimation(double physics_rate, double publish_rate){
+        if(publish_rate <= 0.0){
+            return 0;
+        }
+        return std::max(1l, std::lround(physics_rate/publish_rate));
+    }
+
+    Simulation::Simulation(ros::NodeHandle & nh, Fleet & fleet, WorkerPool & pool, Mode mode, int rate,
+                           const PublishRates & rates, double stats_period, const visualization_msgs::MarkerArray & markers)
+    : fleet(fleet),
+      pool(pool),
+      mode(mode),
+      rate(rate),
+      stats_period(stats_period),
+      streams{
+        {"physics", 1},
+        {"tf", decimation(rate, rates.tf)},
+        {"joint_states", decimation(rate, rates.joint_states)},
+        {"timestep", decimation(rate, rates.timestep)},
+        {"markers", decimation(rate, rates.markers)},
+        {"clock", mode == Mode::realtime ? 0 : decimation(rate, rates.clock)},
+        {"callbacks", 1}
+      },
+      report_start(std::chrono::steady_clock::now()),
+      marker_array(markers)
+    {
+        //The topic and queue of tf2_ros::TransformBroadcaster, whose sendTransform copies the
+        //transforms into a new message on every call; the fleet keeps that message instead
+        tf_pub = nh.advertise<tf2_msgs::TFMessage>("/tf", 100);
+
+        marker_pub = nh.advertise<visualization_msgs::MarkerArray>("obstacles", 10, true);
+        marker_pub.publish(marker_array);
+
+        count_pub = nh.advertise<std_msgs::UInt64>("timestep", 10);
+
+        joint_pubs.reserve(fleet.size());
+        for(std::size_t i = 0; i < fleet.size(); i++){
+            joint_pubs.push_back(nh.advertise<sensor_msgs::JointState>("/" + fleet.name(i) + "/joint_states", 10));
+        }
+
+        if(mode != Mode::realtime){
+            clock_pub = nh.advertise<rosgraph_msgs::Clock>("/clock", 10);
+        }
+    }
+
+    ros::Time Simulation::stamp() const{
+        //Wall time in realtime mode, simulation time otherwise
+        return mode == Mode::realtime ? ros::Time::now() : ros::Time(steps_total/static_cast<double>(rate));
+    }
+
+    void Simulation::tick(){
+
+        //Fixed physics step of every robot along its commanded velocities, spread over the pool;
+        //the transforms are filled in on the same pass when due
+        const long unsigned int step = steps_total + 1;
+        const bool fill_tf = due(streams[TF], step);
+        timed(streams[PHYSICS], [&]{
+            steps_total++;
+            const ros::Time now = fill_tf ? stamp() : ros::Time();
+            pool.run(fleet.size(), robots_per_chunk, [&](std::size_t begin, std::size_t end){
+                fleet.step(begin, end, 1.0/rate);
+                if(fill_tf){
+                    fleet.fill_transforms(begin, end, now);
+                }
+            });
+        });
+
+        if(due(streams[CLOCK], step)){
+            timed(streams[CLOCK], [&]{
+                clock.clock = stamp();
+                clock_pub.publish(clock);
+            });
+        }
+
+        if(due(streams[TF], step)){
+            timed(streams[TF], [&]{
+                tf_pub.publish(fleet.tf_message());
+            });
+        }
+
+        if(due(streams[JOINTS], step)){
+            timed(streams[JOINTS], [&]{
+                const ros::Time now = stamp();
+                for(std::size_t r = 0; r < fleet.size(); r++){
+                    joint_pubs[r].publish(fleet.joint_state(r, now));
+                }
+            });
+        }
+
+        //As before the physics step, the timestep counts from 0: it is published, then advanced
+        if(due(streams[TIMESTEP], step)){
+            timed(streams[TIMESTEP], [&]{
+                num.data = counter;
+                count_pub.publish(num);
+            });
+        }
+        counter++;
+
+        if(due(streams[MARKERS], step)){
+            timed(streams[MARKERS], [&]{
+                const ros::Time now = stamp();
+                for(visualization_msgs::Marker & marker : marker_array.markers){
+                    marker.header.stamp = now;
+                }
+                marker_pub.publish(marker_array);
+            });
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        const double elapsed = std::chrono::duration<double>(now - report_start).count();
+        if(stats_period > 0.0 && elapsed >= stats_period){
+            report(elapsed);
+            reported_at = steps_total;
+            report_start = now;
+        }
+    }
+
+    void Simulation::spin_once(){
+        timed(streams[CALLBACKS], []{
+            ros::spinOnce();
+        });
+    }
+
+    void Simulation::reset(){
+        counter = 0;
+        fleet.reset();
+    }
+
+    void Simulation::report(double seconds){
+        const long unsigned int steps = steps_total - reported_at;
+        ROS_INFO("%lu physics steps in %.2f s (%.0f Hz), real-time factor %.2f",
+                 steps, seconds, steps/seconds, steps/static_cast<double>(rate)/seconds);
+        for(Stream & s : streams){
+            const double mean = s.count ? s.busy/s.count : 0.0;
+            //What the skipped steps would have cost at the mean publish time
+            const double saved = s.decimation ? mean*(steps - s.count)/seconds : 0.0;
+            ROS_INFO("  %-12s %8.1f Hz %8.2f us mean %8.2f us max %7.2f ms/s CPU, %7.2f ms/s saved",
+                     s.name, s.count/seconds, mean*1e6, s.worst*1e6, s.busy/seconds*1e3, saved*1e3);
+            s.count = 0;
+            s.busy = 0.0;
+            s.worst = 0.0;
+        }
+    }
+}
@@ -0,0 +1,150 @@
+#include "nusim/worker_pool.hpp"
+#include <algorithm>
+
+/// \file
+/// \brief Implementation file for the work-stealing worker pool
+
+namespace nusim
+{
+    namespace
+    {
+        /// \brief times a worker polls for the next run before it goes to sleep
+        constexpr int spin_limit = 2000;
+
+        /// \brief the most chunks a run can have: a packed range holds chunk indices in 32 bits
+        constexpr std::uint64_t max_chunks = 0xffffffffu;
+
+        /// \brief pack a range of chunks into one word
+        std::uint64_t pack(std::uint64_t begin, std::uint64_t end){
+            return (begin << 32) | end;
+        }
+
+        /// \brief the first chunk of a packed range
+        std::uint64_t first(std::uint64_t range){
+            return range >> 32;
+        }
+
+        /// \brief one past the last chunk of a packed range
+        std::uint64_t last(std::uint64_t range){
+            return range & 0xffffffffu;
+        }
+    }
+
+    WorkerPool::WorkerPool(unsigned thread_count)
+        : count(thread_count ? thread_count : std::max(1u, std::thread::hardware_concurrency())),
+          shares(new Share[count])
+    {
+        threads.reserve(count - 1);
+        for(unsigned t = 1; t < count; t++){
+            threads.emplace_back(&WorkerPool::work, this, t);
+        }
+    }
+
+    WorkerPool::~WorkerPool(){
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping.store(true);
+            generation.fetch_add(1, std::memory_order_release);
+        }
+        wake.notify_all();
+        for(std::thread & thread : threads){
+            thread.join();
+        }
+    }
+
+    void WorkerPool::run_erased(std::size_t n, std::size_t chunk, void (*f)(void *, std::size_t, std::size_t), void * c){
+        if(n == 0){
+            return;
+        }
+        chunk = std::max<std::size_t>(chunk, 1);
+        // Larger chunks if there would be more than fit in a packed range
+        if(n/chunk + (n%chunk != 0) > max_chunks){
+            chunk = n/max_chunks + (n%max_chunks != 0);
+        }
+        call = f;
+        context = c;
+        items = n;
+        chunk_items = chunk;
+
+        // Equal shares of the chunks, in order
+        const std::uint64_t chunks = (n + chunk - 1)/chunk;
+        for(unsigned t = 0; t < count; t++){
+            shares[t].range.store(pack(chunks*t/count, chunks*(t + 1)/count), std::memory_order_relaxed);
+        }
+        finished.store(0, std::memory_order_relaxed);
+        if(count > 1){
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                generation.fetch_add(1, std::memory_order_release);
+            }
+            wake.notify_all();
+        }
+
+        drain(0);
+        while(finished.load(std::memory_order_acquire) != count - 1){
+            std::this_thread::yield();
+        }
+    }
+
+    void WorkerPool::drain(unsigned self){
+        std::atomic<std::uint64_t> & own = shares[self].range;
+        for(;;){
+            // Chunks from the front of the own share; thieves take from the back
+            std::uint64_t range = own.load(std::memory_order_acquire);
+            while(first(range) < last(range)){
+                if(own.compare_exchange_weak(range, pack(first(range) + 1, last(range)), std::memory_order_acq_rel)){
+                    const std::size_t begin = first(range)*chunk_items;
+                    call(context, begin, std::min(items, begin + chunk_items));
+                    range = own.load(std::memory_order_acquire);
+                }
+            }
+
+            // Out of work: steal the back half of the largest share
+            unsigned victim = self;
+            std::uint64_t most = 0;
+            for(unsigned t = 0; t < count; t++){
+                const std::uint64_t r = shares[t].range.load(std::memory_order_relaxed);
+                if(last(r) > first(r) && last(r) - first(r) > most){
+                    most = last(r) - first(r);
+                    victim = t;
+                }
+            }
+            if(most == 0){
+                return;
+            }
+            std::uint64_t r = shares[victim].range.load(std::memory_order_acquire);
+            if(last(r) <= first(r)){
+                continue;
+            }
+            const std::uint64_t split = last(r) - (last(r) - first(r) + 1)/2;
+            if(shares[victim].range.compare_exchange_strong(r, pack(first(r), split), std::memory_order_acq_rel)){
+                own.store(pack(split, last(r)), std::memory_order_release);
+            }
+        }
+    }
+
+    void WorkerPool::work(unsigned self){
+        std::uint64_t seen = 0;
+        for(;;){
+            // Poll for a while: the next tick is usually close
+            std::uint64_t current = generation.load(std::memory_order_acquire);
+            for(int spin = 0; current == seen && spin < spin_limit; spin++){
+                std::this_thread::yield();
+                current = generation.load(std::memory_order_acquire);
+            }
+            if(current == seen){
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&]{
+                    return generation.load(std::memory_order_acquire) != seen;
+                });
+                current = generation.load(std::memory_order_acquire);
+            }
+            if(stopping.load()){
+                return;
+            }
+            seen = current;
+            drain(self);
+            finished.fetch_add(1, std::memory_order_release);
+        }
+    }
+}
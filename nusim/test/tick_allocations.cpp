@@ -0,0 +1,100 @@
+/// \file
+/// \brief Checks that a tick of the simulation, publishing included, does not allocate.
+///
+/// Every output publishes on every step, on a fleet of robots driving among obstacles. The
+/// ticks run on a pool of one thread, so all of their work happens on the test thread, and
+/// only that thread's allocations are counted: roscpp's own threads allocate as they please.
+/// Nothing subscribes to the topics, so roscpp does not serialize what is published.
+///
+/// Run by rostest, which brings up the master: rostest nusim tick_allocations.test
+
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <gtest/gtest.h>
+#include "ros/ros.h"
+#include "visualization_msgs/MarkerArray.h"
+#include "nusim/fleet.hpp"
+#include "nusim/simulation.hpp"
+#include "nusim/worker_pool.hpp"
+
+namespace{
+    /// \brief whether this thread's allocations are counted
+    thread_local bool counting = false;
+
+    /// \brief allocations counted so far, all on the test thread
+    long unsigned int allocations = 0;
+
+    /// \brief the heap allocations of ticks after a warm-up
+    /// \param mode - what paces the steps, which decides the stamps and whether /clock is published
+    /// \param ticks - the ticks to count over
+    long unsigned int tick_allocations(nusim::Mode mode, long unsigned int ticks){
+        ros::NodeHandle nh("~");
+
+        nusim::Fleet fleet;
+        for(long unsigned int i = 0; i < 200; i++){
+            const std::size_t r = fleet.add("robot" + std::to_string(i), 0.5*(i%16), 0.5*(i/16), 0.0);
+            fleet.state(r).v = 0.2;
+            fleet.state(r).w = 0.5 + 0.01*(i%10);
+        }
+        visualization_msgs::MarkerArray markers;
+        for(int k = 0; k < 8; k++){
+            fleet.add_obstacle({1.0*k, 0.5*k + 0.2, 0.1});
+            visualization_msgs::Marker m;
+            m.header.frame_id = "world";
+            m.id = k;
+            markers.markers.push_back(m);
+        }
+        nusim::WorkerPool pool(1);
+
+        //Everything every step but the markers, which are published once, latched
+        const int rate = 1000;
+        const nusim::PublishRates rates{rate, rate, rate, 0.0, rate};
+        nusim::Simulation sim(nh, fleet, pool, mode, rate, rates, 0.0, markers);
+
+        for(int t = 0; t < 10; t++){
+            sim.tick();
+        }
+
+        allocations = 0;
+        counting = true;
+        for(long unsigned int t = 0; t < ticks; t++){
+            sim.tick();
+        }
+        counting = false;
+        return allocations;
+    }
+}
+
+TEST(TickAllocations, Realtime){
+    EXPECT_EQ(tick_allocations(nusim::Mode::realtime, 1000), 0u);
+}
+
+TEST(TickAllocations, Freerun){
+    EXPECT_EQ(tick_allocations(nusim::Mode::freerun, 1000), 0u);
+}
+
+int main(int argc, char * argv[]){
+    testing::InitGoogleTest(&argc, argv);
+    ros::init(argc, argv, "tick_allocations");
+    return RUN_ALL_TESTS();
+}
+
+// Counting replacements for the global allocation functions
+void * operator new(std::size_t size){
+    if(counting){
+        allocations++;
+    }
+    if(void * p = std::malloc(size ? size : 1)){
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void * p) noexcept{
+    std::free(p);
+}
+
+void operator delete(void * p, std::size_t) noexcept{
+    std::free(p);
+}
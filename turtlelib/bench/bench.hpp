@@ -0,0 +1,154 @@
+#ifndef BENCH_INCLUDE_GUARD_HPP
+#define BENCH_INCLUDE_GUARD_HPP
+/// \file
+/// \brief Small helpers shared by the turtlelib benchmarks.
+///
+/// This header replaces the global operator new/delete so that heap allocations can be
+/// counted. Include it from exactly one translation unit of each benchmark executable.
+
+#include<atomic>
+#include<chrono>
+#include<cstddef>
+#include<cstdio>
+#include<cstdlib>
+#include<new>
+
+#ifdef __linux__
+#include<linux/perf_event.h>
+#include<sys/ioctl.h>
+#include<sys/syscall.h>
+#include<unistd.h>
+#endif
+
+namespace bench
+{
+    /// \brief number of calls to operator new since program start
+    inline std::atomic<std::size_t> allocations{0};
+
+    /// \brief read the allocation counter
+    /// \return the number of heap allocations performed so far
+    inline std::size_t allocation_count()
+    {
+        return allocations.load(std::memory_order_relaxed);
+    }
+
+    /// \brief keep the compiler from optimizing away a computed value
+    /// \param value - the value to keep alive
+    template<class T>
+    inline void do_not_optimize(T const & value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /// \brief time a callable over a number of iterations
+    /// \param iterations - how many times to call f
+    /// \param f - the callable, invoked with the iteration index
+    /// \return the average time per call, in nanoseconds
+    template<class F>
+    double ns_per_op(std::size_t iterations, F && f)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for(std::size_t i = 0; i < iterations; i++){
+            f(i);
+        }
+        const auto stop = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(stop - start).count()/iterations;
+    }
+
+    /// \brief counts instructions retired by this thread with a Linux perf counter
+    /// valid() is false where perf events are unavailable (non-Linux, containers, perf_event_paranoid)
+    class InstructionCounter
+    {
+    public:
+        InstructionCounter()
+        {
+#ifdef __linux__
+            perf_event_attr attr{};
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+        }
+
+        ~InstructionCounter()
+        {
+#ifdef __linux__
+            if(fd >= 0){
+                close(fd);
+            }
+#endif
+        }
+
+        InstructionCounter(const InstructionCounter &) = delete;
+        InstructionCounter & operator=(const InstructionCounter &) = delete;
+
+        /// \brief whether the counter could be opened
+        bool valid() const
+        {
+            return fd >= 0;
+        }
+
+        /// \brief count the instructions executed by a callable
+        /// \param f - the callable
+        /// \return instructions retired, or 0 if the counter is not valid
+        template<class F>
+        long long count(F && f)
+        {
+            if(!valid()){
+                f();
+                return 0;
+            }
+#ifdef __linux__
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            f();
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            long long value = 0;
+            if(read(fd, &value, sizeof(value)) != sizeof(value)){
+                return 0;
+            }
+            return value;
+#else
+            return 0;
+#endif
+        }
+
+    private:
+        int fd = -1;
+    };
+
+    /// \brief print one benchmark result line
+    /// \param name - what was measured
+    /// \param ns - average nanoseconds per operation
+    /// \param allocs - heap allocations per operation
+    inline void report(const char * name, double ns, double allocs)
+    {
+        std::printf("%-40s %10.2f ns/op %10.3f allocs/op\n", name, ns, allocs);
+    }
+}
+
+// Counting replacements for the global allocation functions
+void * operator new(std::size_t size)
+{
+    bench::allocations.fetch_add(1, std::memory_order_relaxed);
+    if(void * p = std::malloc(size ? size : 1)){
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void * p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void * p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+#endif
@@ -0,0 +1,141 @@
+/// \file
+/// \brief Benchmark of angle normalization: the loop of repeated 2PI steps it replaced,
+/// std::remainder, normalize_angle, and the batch kernels at every instruction set, on angles
+/// just out of range and on angles far out of range; and of the batch degree conversions.
+///
+/// Usage: bench_angle [angles per frame] [frames]
+
+#include<cmath>
+#include<cstdio>
+#include<cstdlib>
+#include<vector>
+#include "turtlelib/batch2d.hpp"
+#include "bench.hpp"
+
+namespace
+{
+    /// \brief print a throughput line (angles per second)
+    void report_rate(const char * name, double ns_per_frame, std::size_t n)
+    {
+        std::printf("%-32s %10.1f Mangle/s\n", name, n/ns_per_frame*1e3);
+    }
+
+    /// \brief the previous wrap: step by 2PI until in range, as many steps as turns out of range
+    double wrap_loop(double rad)
+    {
+        while(rad > turtlelib::PI){
+            rad -= 2.0*turtlelib::PI;
+        }
+        while(rad <= -turtlelib::PI){
+            rad += 2.0*turtlelib::PI;
+        }
+        return rad;
+    }
+
+    /// \brief time every way of normalizing the angles in
+    void run(const char * name, const std::vector<double> & in, std::size_t frames, bool with_loop)
+    {
+        const std::size_t n = in.size();
+        std::vector<double> out(n);
+        std::vector<float> in_f(in.begin(), in.end());
+        std::vector<float> out_f(n);
+        std::printf("%s\n", name);
+
+        if(with_loop){
+            const double loop = bench::ns_per_op(frames, [&](std::size_t){
+                for(std::size_t i = 0; i < n; i++){
+                    out[i] = wrap_loop(in[i]);
+                }
+                bench::do_not_optimize(out.data());
+            });
+            report_rate("  while loop", loop, n);
+        } else {
+            std::printf("  %-30s %10s\n", "while loop", "(skipped)");
+        }
+
+        const double remainder = bench::ns_per_op(frames, [&](std::size_t){
+            for(std::size_t i = 0; i < n; i++){
+                out[i] = std::remainder(in[i], 2.0*turtlelib::PI);
+            }
+            bench::do_not_optimize(out.data());
+        });
+        report_rate("  std::remainder", remainder, n);
+
+        const double scalar = bench::ns_per_op(frames, [&](std::size_t){
+            for(std::size_t i = 0; i < n; i++){
+                out[i] = turtlelib::normalize_angle(in[i]);
+            }
+            bench::do_not_optimize(out.data());
+        });
+        report_rate("  normalize_angle", scalar, n);
+
+        const turtlelib::SimdLevel levels[] = {turtlelib::SimdLevel::scalar, turtlelib::SimdLevel::sse2, turtlelib::SimdLevel::avx2};
+        for(const turtlelib::SimdLevel requested : levels){
+            const turtlelib::SimdLevel level = turtlelib::set_simd_level(requested);
+            if(level != requested){
+                continue;
+            }
+            const double batch = bench::ns_per_op(frames, [&](std::size_t){
+                turtlelib::normalize_angle(in.data(), out.data(), n);
+                bench::do_not_optimize(out.data());
+            });
+            const double batch_f = bench::ns_per_op(frames, [&](std::size_t){
+                turtlelib::normalize_angle(in_f.data(), out_f.data(), n);
+                bench::do_not_optimize(out_f.data());
+            });
+            char label[32];
+            std::snprintf(label, sizeof(label), "  batch [%s]", turtlelib::to_string(level));
+            report_rate(label, batch, n);
+            std::snprintf(label, sizeof(label), "  batch float [%s]", turtlelib::to_string(level));
+            report_rate(label, batch_f, n);
+        }
+        turtlelib::set_simd_level(turtlelib::detected_simd_level());
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    const std::size_t frames = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 200;
+
+    std::printf("%zu angles per frame, %zu frames, detected %s\n",
+                n, frames, turtlelib::to_string(turtlelib::detected_simd_level()));
+
+    //Headings after one composition: within a turn of the interval
+    std::vector<double> near(n);
+    for(std::size_t i = 0; i < n; i++){
+        near[i] = 2.0*turtlelib::PI*std::sin(0.37*i);
+    }
+    run("within one turn", near, frames, true);
+
+    //Accumulated headings, up to a thousand turns out
+    std::vector<double> far(n);
+    for(std::size_t i = 0; i < n; i++){
+        far[i] = 6283.0*std::sin(0.37*i);
+    }
+    run("up to 1000 turns", far, frames, true);
+
+    //The loop would take days here, the others take the same time as above
+    std::vector<double> huge(n);
+    for(std::size_t i = 0; i < n; i++){
+        huge[i] = 1e12*std::sin(0.37*i);
+    }
+    run("up to 1e11 turns", huge, frames, false);
+
+    //Degrees
+    std::vector<double> out(n);
+    const double loop = bench::ns_per_op(frames, [&](std::size_t){
+        for(std::size_t i = 0; i < n; i++){
+            out[i] = turtlelib::deg2rad(far[i]);
+        }
+        bench::do_not_optimize(out.data());
+    });
+    const double batch = bench::ns_per_op(frames, [&](std::size_t){
+        turtlelib::deg2rad(far.data(), out.data(), n);
+        bench::do_not_optimize(out.data());
+    });
+    std::printf("degrees\n");
+    report_rate("  deg2rad loop", loop, n);
+    report_rate("  deg2rad batch", batch, n);
+    return 0;
+}
@@ -0,0 +1,253 @@
+/// \file
+/// \brief Benchmark of the batch point and twist kernels against the per-element operators,
+/// of the single precision point and twist kernels against the double precision ones, and of the batch
+/// vector functions (normalize, magnitude, dot, angle) against per-element loops.
+///
+/// Usage: bench_batch2d [elements per frame] [frames]
+
+#include<cmath>
+#include<cstdio>
+#include<cstdlib>
+#include<vector>
+#include "turtlelib/batch2d.hpp"
+#include "bench.hpp"
+
+namespace
+{
+    /// \brief print a throughput line (elements per second)
+    void report_rate(const char * name, double ns_per_frame, std::size_t points)
+    {
+        std::printf("%-32s %10.1f Melem/s\n", name, points/ns_per_frame*1e3);
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    const std::size_t frames = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 200;
+
+    const turtlelib::Transform2D tf({0.3, -0.1}, 0.25);
+
+    std::vector<turtlelib::Vector2D> in(n);
+    std::vector<turtlelib::Vector2D> out(n);
+    std::vector<double> xs(n), ys(n), xs_out(n), ys_out(n);
+    for(std::size_t i = 0; i < n; i++){
+        in[i] = {std::cos(0.001*i)*(1.0 + i%7), std::sin(0.001*i)*(1.0 + i%7)};
+        xs[i] = in[i].x;
+        ys[i] = in[i].y;
+    }
+
+    std::printf("%zu elements per frame, %zu frames, detected %s\n",
+                n, frames, turtlelib::to_string(turtlelib::detected_simd_level()));
+
+    std::vector<turtlelib::Twist2D> twists(n);
+    std::vector<turtlelib::Twist2D> twists_out(n);
+    for(std::size_t i = 0; i < n; i++){
+        twists[i] = turtlelib::Twist2D{{0.01*(i%13), 0.2 + 0.001*(i%100), -0.05}};
+    }
+
+    const double per_point = bench::ns_per_op(frames, [&](std::size_t){
+        for(std::size_t i = 0; i < n; i++){
+            out[i] = tf(in[i]);
+        }
+        bench::do_not_optimize(out.data());
+    });
+    report_rate("per-point operator()", per_point, n);
+
+    const double per_twist = bench::ns_per_op(frames, [&](std::size_t){
+        for(std::size_t i = 0; i < n; i++){
+            twists_out[i] = tf(twists[i]);
+        }
+        bench::do_not_optimize(twists_out.data());
+    });
+    report_rate("per-twist operator()", per_twist, n);
+
+    const turtlelib::SimdLevel levels[] = {turtlelib::SimdLevel::scalar, turtlelib::SimdLevel::sse2, turtlelib::SimdLevel::avx2};
+    for(const turtlelib::SimdLevel requested : levels){
+        const turtlelib::SimdLevel level = turtlelib::set_simd_level(requested);
+        if(level != requested){
+            continue;
+        }
+
+        const double aos = bench::ns_per_op(frames, [&](std::size_t){
+            turtlelib::transform_points(tf, in.data(), out.data(), n);
+            bench::do_not_optimize(out.data());
+        });
+        const double soa = bench::ns_per_op(frames, [&](std::size_t){
+            turtlelib::transform_points(tf, xs.data(), ys.data(), xs_out.data(), ys_out.data(), n);
+            bench::do_not_optimize(xs_out.data());
+        });
+
+        const double tw = bench::ns_per_op(frames, [&](std::size_t){
+            turtlelib::transform_twists(tf, twists.data(), twists_out.data(), n);
+            bench::do_not_optimize(twists_out.data());
+        });
+
+        std::printf("[%s]\n", turtlelib::to_string(level));
+        report_rate("  batch AoS", aos, n);
+        report_rate("  batch SoA", soa, n);
+        report_rate("  batch twists", tw, n);
+    }
+
+    // Same points in single precision
+    const turtlelib::Transform2Df tf_f({0.3f, -0.1f}, 0.25f);
+    std::vector<turtlelib::Vector2Df> in_f(n);
+    std::vector<turtlelib::Vector2Df> out_f(n);
+    std::vector<float> xs_f(n), ys_f(n), xs_out_f(n), ys_out_f(n);
+    for(std::size_t i = 0; i < n; i++){
+        in_f[i] = {static_cast<float>(in[i].x), static_cast<float>(in[i].y)};
+        xs_f[i] = in_f[i].x;
+        ys_f[i] = in_f[i].y;
+    }
+    std::vector<turtlelib::Twist2Df> twists_f(n), twists_out_f(n);
+    for(std::size_t i = 0; i < n; i++){
+        twists_f[i] = {{static_cast<float>(twists[i].tw[0]), static_cast<float>(twists[i].tw[1]), static_cast<float>(twists[i].tw[2])}};
+    }
+
+    for(const turtlelib::SimdLevel requested : levels){
+        const turtlelib::SimdLevel level = turtlelib::set_simd_level(requested);
+        if(level != requested){
+            continue;
+        }
+
+        const double aos_d = bench::ns_per_op(frames, [&](std::size_t){
+            turtlelib::transform_points(tf, in.data(), out.data(), n);
+            bench::do_not_optimize(out.data());
+        });
+        const double aos_f = bench::ns_per_op(frames, [&](std::size_t){
+            turtlelib::transform_points(tf_f, in_f.data(), out_f.data(), n);
+            bench::do_not_optimize(out_f.data());
+        });
+        const double soa_d = bench::ns_per_op(frames, [&](std::size_t){
+            turtlelib::transform_points(tf, xs.data(), ys.data(), xs_out.data(), ys_out.data(), n);
+            bench::do_not_optimize(xs_out.data());
+        });
+        const double soa_f = bench::ns_per_op(frames, [&](std::size_t){
+            turtlelib::transform_points(tf_f, xs_f.data(), ys_f.data(), xs_out_f.data(), ys_out_f.data(), n);
+            bench::do_not_optimize(xs_out_f.data());
+        });
+        const double tw_d = bench::ns_per_op(frames, [&](std::size_t){
+            turtlelib::transform_twists(tf, twists.data(), twists_out.data(), n);
+            bench::do_not_optimize(twists_out.data());
+        });
+        const double tw_f = bench::ns_per_op(frames, [&](std::size_t){
+            turtlelib::transform_twists(tf_f, twists_f.data(), twists_out_f.data(), n);
+            bench::do_not_optimize(twists_out_f.data());
+        });
+
+        std::printf("[%s] float vs double\n", turtlelib::to_string(level));
+        report_rate("  AoS double", aos_d, n);
+        report_rate("  AoS float", aos_f, n);
+        report_rate("  SoA double", soa_d, n);
+        report_rate("  SoA float", soa_f, n);
+        report_rate("  twists double", tw_d, n);
+        report_rate("  twists float", tw_f, n);
+    }
+
+    // Vector functions against per-element loops
+    std::vector<turtlelib::Vector2D> other(n);
+    std::vector<double> values(n);
+    for(std::size_t i = 0; i < n; i++){
+        other[i] = {-in[i].y + 0.1*(i%3), in[i].x};
+    }
+    std::vector<turtlelib::Vector2Df> other_f(n);
+    std::vector<float> values_f(n);
+    for(std::size_t i = 0; i < n; i++){
+        other_f[i] = {static_cast<float>(other[i].x), static_cast<float>(other[i].y)};
+    }
+    turtlelib::set_simd_level(turtlelib::detected_simd_level());
+
+    const double loop_normalize_old = bench::ns_per_op(frames, [&](std::size_t){
+        // The previous normalize(): two divisions and two square roots, and the signs lost
+        for(std::size_t i = 0; i < n; i++){
+            const double x = in[i].x;
+            const double y = in[i].y;
+            out[i] = {std::sqrt((x*x)/(x*x + y*y)), std::sqrt((y*y)/(x*x + y*y))};
+        }
+        bench::do_not_optimize(out.data());
+    });
+    const double loop_normalize = bench::ns_per_op(frames, [&](std::size_t){
+        for(std::size_t i = 0; i < n; i++){
+            out[i] = in[i].normalize();
+        }
+        bench::do_not_optimize(out.data());
+    });
+    const double loop_magnitude = bench::ns_per_op(frames, [&](std::size_t){
+        for(std::size_t i = 0; i < n; i++){
+            values[i] = turtlelib::magnitude(in[i]);
+        }
+        bench::do_not_optimize(values.data());
+    });
+    const double loop_dot = bench::ns_per_op(frames, [&](std::size_t){
+        for(std::size_t i = 0; i < n; i++){
+            values[i] = turtlelib::dot(in[i], other[i]);
+        }
+        bench::do_not_optimize(values.data());
+    });
+    const double loop_angle = bench::ns_per_op(frames, [&](std::size_t){
+        for(std::size_t i = 0; i < n; i++){
+            values[i] = turtlelib::angle(in[i], other[i]);
+        }
+        bench::do_not_optimize(values.data());
+    });
+    std::printf("per-element loops\n");
+    report_rate("  normalize (previous)", loop_normalize_old, n);
+    report_rate("  normalize", loop_normalize, n);
+    report_rate("  magnitude", loop_magnitude, n);
+    report_rate("  dot", loop_dot, n);
+    report_rate("  angle", loop_angle, n);
+
+    for(const turtlelib::SimdLevel requested : levels){
+        const turtlelib::SimdLevel level = turtlelib::set_simd_level(requested);
+        if(level != requested){
+            continue;
+        }
+
+        const double normalize = bench::ns_per_op(frames, [&](std::size_t){
+            turtlelib::normalize(in.data(), out.data(), n);
+            bench::do_not_optimize(out.data());
+        });
+        const double magnitude = bench::ns_per_op(frames, [&](std::size_t){
+            turtlelib::magnitude(in.data(), values.data(), n);
+            bench::do_not_optimize(values.data());
+        });
+        const double dot = bench::ns_per_op(frames, [&](std::size_t){
+            turtlelib::dot(in.data(), other.data(), values.data(), n);
+            bench::do_not_optimize(values.data());
+        });
+        const double angle = bench::ns_per_op(frames, [&](std::size_t){
+            turtlelib::angle(in.data(), other.data(), values.data(), n);
+            bench::do_not_optimize(values.data());
+        });
+
+        const double normalize_f = bench::ns_per_op(frames, [&](std::size_t){
+            turtlelib::normalize(in_f.data(), out_f.data(), n);
+            bench::do_not_optimize(out_f.data());
+        });
+        const double magnitude_f = bench::ns_per_op(frames, [&](std::size_t){
+            turtlelib::magnitude(in_f.data(), values_f.data(), n);
+            bench::do_not_optimize(values_f.data());
+        });
+        const double dot_f = bench::ns_per_op(frames, [&](std::size_t){
+            turtlelib::dot(in_f.data(), other_f.data(), values_f.data(), n);
+            bench::do_not_optimize(values_f.data());
+        });
+        const double angle_f = bench::ns_per_op(frames, [&](std::size_t){
+            turtlelib::angle(in_f.data(), other_f.data(), values_f.data(), n);
+            bench::do_not_optimize(values_f.data());
+        });
+
+        std::printf("[%s] vector batch\n", turtlelib::to_string(level));
+        report_rate("  normalize", normalize, n);
+        report_rate("  magnitude", magnitude, n);
+        report_rate("  dot", dot, n);
+        report_rate("  angle", angle, n);
+        report_rate("  normalize float", normalize_f, n);
+        report_rate("  magnitude float", magnitude_f, n);
+        report_rate("  dot float", dot_f, n);
+        report_rate("  angle float", angle_f, n);
+    }
+    turtlelib::set_simd_level(turtlelib::detected_simd_level());
+
+    return 0;
+}
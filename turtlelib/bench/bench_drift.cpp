@@ -0,0 +1,91 @@
+/// \file
+/// \brief Benchmark of rotation drift over long composition chains.
+///
+/// Composes the same increment many times with plain operator*= and with PoseAccumulator
+/// at several re-projection intervals. Reports the cost per composition and, at each decade,
+/// how far the rotation is from SO(2) (|cos^2 + sin^2 - 1|), and the heading and position errors
+/// against the closed form, computed in long double.
+///
+/// Usage: bench_drift [compositions]
+
+#include<cmath>
+#include<cstdio>
+#include<cstdlib>
+#include "turtlelib/trajectory.hpp"
+#include "bench.hpp"
+
+namespace
+{
+    /// \brief one increment: a small step along a circle
+    const double step_x = 0.01;
+    const double step_th = 0.0012345;
+
+    /// \brief exact pose after n identical increments: p = (I - R(n th))(I - R(th))^-1 [x 0]
+    void exact_position(std::size_t n, long double & px, long double & py)
+    {
+        const long double th = step_th;
+        const long double c = std::cos(n*th);
+        const long double s = std::sin(n*th);
+        // (I - R(th))^-1 = 1/(2 - 2cos th) * [1 - cos th, -sin th; sin th, 1 - cos th]
+        const long double d = 2.0L - 2.0L*std::cos(th);
+        const long double ux = step_x*(1.0L - std::cos(th))/d;
+        const long double uy = step_x*std::sin(th)/d;
+        px = (1.0L - c)*ux + s*uy;
+        py = -s*ux + (1.0L - c)*uy;
+    }
+
+    /// \brief print the error of a pose after n compositions
+    void report_error(const char * name, std::size_t n, const turtlelib::Transform2D & pose)
+    {
+        long double px = 0.0L;
+        long double py = 0.0L;
+        exact_position(n, px, py);
+        const double c = pose.rotation_cos();
+        const double s = pose.rotation_sin();
+        const double norm_err = std::fabs(c*c + s*s - 1.0);
+        // Stored heading, compared on the circle
+        const long double th_err = std::remainder(pose.rotation() - n*static_cast<long double>(step_th), 2.0L*turtlelib::PI);
+        const double pos_err = static_cast<double>(std::hypot(pose.translation().x - px, pose.translation().y - py));
+        std::printf("  %-24s n=%-10zu |c^2+s^2-1| %.2e   heading error %.2e rad   position error %.2e m\n",
+                    name, n, norm_err, static_cast<double>(std::fabs(th_err)), pos_err);
+    }
+
+    /// \brief compose n increments, reporting the error at every power of ten
+    template<class Acc, class Pose>
+    double run(const char * name, std::size_t n, Acc & acc, Pose && pose)
+    {
+        const turtlelib::Transform2D inc({step_x, 0.0}, step_th);
+        double ns = 0.0;
+        std::size_t done = 0;
+        for(std::size_t checkpoint = 1000000; done < n; checkpoint *= 10){
+            const std::size_t stop = checkpoint < n ? checkpoint : n;
+            ns += bench::ns_per_op(stop - done, [&](std::size_t){
+                acc*=inc;
+                bench::do_not_optimize(acc);
+            })*(stop - done);
+            done = stop;
+            report_error(name, done, pose(acc));
+        }
+        return ns/n;
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+
+    turtlelib::Transform2D plain;
+    const double plain_ns = run("operator*=", n, plain, [](const turtlelib::Transform2D & t){ return t; });
+    bench::report("operator*=", plain_ns, 0.0);
+
+    const std::size_t intervals[] = {1, 64, 1024, 65536};
+    for(const std::size_t interval : intervals){
+        char name[64];
+        std::snprintf(name, sizeof(name), "PoseAccumulator(%zu)", interval);
+        turtlelib::PoseAccumulator acc(interval);
+        const double ns = run(name, n, acc, [](const turtlelib::PoseAccumulator & a){ return a.pose(); });
+        bench::report(name, ns, 0.0);
+    }
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+/// \file
+/// \brief Benchmark of FrameGraph lookups against a string-keyed tree walked on every lookup
+/// (what a tf2-style buffer without caching does), on a typical scene: world, odom,
+/// base_footprint, base_scan, two wheels and a few dozen obstacles under world.
+///
+/// Each simulated tick moves the robot (one edge update) and then looks up every obstacle in
+/// the scanner frame, as a fake laser or a collision check would.
+///
+/// Usage: bench_frame_graph [obstacles] [ticks]
+
+#include<cstdio>
+#include<cstdlib>
+#include<string>
+#include<unordered_map>
+#include<vector>
+#include "turtlelib/frame_graph.hpp"
+#include "bench.hpp"
+
+namespace
+{
+    /// \brief frames keyed by name, each holding its parent's name; nothing cached
+    class StringTree
+    {
+    public:
+        void set_transform(const std::string & parent, const std::string & child, const turtlelib::Transform2D & tf)
+        {
+            edges[child] = {parent, tf};
+        }
+
+        bool lookup(const std::string & a, const std::string & b, turtlelib::Transform2D & tf) const
+        {
+            turtlelib::Transform2D root_a, root_b;
+            std::string root_name_a, root_name_b;
+            from_root(a, root_a, root_name_a);
+            from_root(b, root_b, root_name_b);
+            if(root_name_a != root_name_b){
+                return false;
+            }
+            tf = root_a.inv()*root_b;
+            return true;
+        }
+
+    private:
+        struct Edge
+        {
+            std::string parent;
+            turtlelib::Transform2D tf;
+        };
+
+        /// \brief compose the edges from a frame up to its root
+        void from_root(const std::string & frame, turtlelib::Transform2D & tf, std::string & root) const
+        {
+            tf = turtlelib::Transform2D{};
+            root = frame;
+            for(auto edge = edges.find(root); edge != edges.end(); edge = edges.find(root)){
+                tf = edge->second.tf*tf;
+                root = edge->second.parent;
+            }
+        }
+
+        std::unordered_map<std::string, Edge> edges;
+    };
+
+    /// \brief print a line of ns per tick and per lookup
+    void report(const char * name, double ns_per_tick, std::size_t lookups)
+    {
+        std::printf("%-34s %9.1f ns/tick %8.1f ns/lookup\n", name, ns_per_tick, ns_per_tick/lookups);
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    const std::size_t obstacles = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 40;
+    const std::size_t ticks = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000;
+
+    // The same scene in both
+    StringTree strings;
+    turtlelib::FrameGraph graph;
+    std::vector<std::string> obstacle_names;
+    const auto add = [&](const std::string & parent, const std::string & child, const turtlelib::Transform2D & tf){
+        strings.set_transform(parent, child, tf);
+        graph.set_transform(parent, child, tf);
+    };
+    add("world", "odom", turtlelib::Transform2D{{0.2, -0.1}, 0.05});
+    add("odom", "red-base_footprint", turtlelib::Transform2D{});
+    add("red-base_footprint", "red-base_scan", turtlelib::Transform2D{{-0.032, 0.0}, 0.0});
+    add("red-base_footprint", "red-wheel_left_link", turtlelib::Transform2D{{0.0, 0.08}, 0.0});
+    add("red-base_footprint", "red-wheel_right_link", turtlelib::Transform2D{{0.0, -0.08}, 0.0});
+    for(std::size_t i = 0; i < obstacles; i++){
+        obstacle_names.push_back("obstacle" + std::to_string(i));
+        add("world", obstacle_names.back(), turtlelib::Transform2D{{0.1*i, 1.0 - 0.05*i}, 0.0});
+    }
+    const turtlelib::FrameId odom = graph.find("odom");
+    const turtlelib::FrameId base = graph.find("red-base_footprint");
+    const turtlelib::FrameId scan = graph.find("red-base_scan");
+    std::vector<turtlelib::FrameId> obstacle_ids;
+    for(const std::string & name : obstacle_names){
+        obstacle_ids.push_back(graph.find(name));
+    }
+
+    const turtlelib::Transform2D step({0.001, 0.0}, 0.002);
+    std::printf("%zu frames, %zu obstacle lookups per tick, %zu ticks\n", graph.size(), obstacles, ticks);
+
+    turtlelib::Transform2D pose, tf;
+    const double string_ns = bench::ns_per_op(ticks, [&](std::size_t){
+        pose*=step;
+        strings.set_transform("odom", "red-base_footprint", pose);
+        for(const std::string & name : obstacle_names){
+            strings.lookup("red-base_scan", name, tf);
+            bench::do_not_optimize(tf);
+        }
+    });
+    report("string-keyed tree walk", string_ns, obstacles);
+
+    pose = turtlelib::Transform2D{};
+    const double by_name_ns = bench::ns_per_op(ticks, [&](std::size_t){
+        pose*=step;
+        graph.set_transform("odom", "red-base_footprint", pose);
+        for(const std::string & name : obstacle_names){
+            graph.lookup("red-base_scan", name, tf);
+            bench::do_not_optimize(tf);
+        }
+    });
+    report("FrameGraph by name", by_name_ns, obstacles);
+
+    pose = turtlelib::Transform2D{};
+    const std::size_t before = bench::allocation_count();
+    const double by_id_ns = bench::ns_per_op(ticks, [&](std::size_t){
+        pose*=step;
+        graph.set_transform(odom, base, pose);
+        for(const turtlelib::FrameId id : obstacle_ids){
+            graph.lookup(scan, id, tf);
+            bench::do_not_optimize(tf);
+        }
+    });
+    const std::size_t allocations = bench::allocation_count() - before;
+    report("FrameGraph by id", by_id_ns, obstacles);
+
+    // Updates only: the subtree is already stale after the first, so the rest stop at once
+    const double update_ns = bench::ns_per_op(ticks, [&](std::size_t){
+        pose*=step;
+        graph.set_transform(odom, base, pose);
+    });
+    std::printf("%-34s %9.1f ns/update\n", "FrameGraph update, no lookups", update_ns);
+    std::printf("%-34s %9zu\n", "allocations in the by-id loop", allocations);
+    return 0;
+}
@@ -0,0 +1,147 @@
+/// \file
+/// \brief Benchmark of the pose stream codec: compression ratio, encode and decode throughput,
+/// and random access, on a smooth synthetic trajectory and on a recorded one.
+///
+/// The recorded trajectory is simulated odometry written through PoseLogWriter and read back
+/// with PoseLogReader: a random walk of velocity commands, integrated at 600 Hz, with
+/// timestamp jitter and sensor noise on the pose, as a localization estimate would have.
+///
+/// Usage: bench_pose_codec [poses] [file]
+
+#include<algorithm>
+#include<cmath>
+#include<cstdio>
+#include<cstdlib>
+#include<random>
+#include<string>
+#include<vector>
+#include "turtlelib/pose_codec.hpp"
+#include "turtlelib/pose_log.hpp"
+#include "bench.hpp"
+
+namespace
+{
+    /// \brief a 600 Hz trajectory along a smooth analytic path
+    std::vector<turtlelib::StampedPose> synthetic(std::size_t n)
+    {
+        std::vector<turtlelib::StampedPose> poses(n);
+        for(std::size_t i = 0; i < n; i++){
+            const double t = i/600.0;
+            poses[i] = {static_cast<std::int64_t>(i)*1666667, turtlelib::detail::wrap_angle(0.3*t),
+                        3.0*std::cos(0.3*t) + 0.01*t, 3.0*std::sin(0.3*t)};
+        }
+        return poses;
+    }
+
+    /// \brief log simulated odometry to path and read it back
+    std::vector<turtlelib::StampedPose> recorded(std::size_t n, const std::string & path)
+    {
+        std::mt19937_64 rng(42);
+        std::normal_distribution<double> accel(0.0, 0.02);
+        std::normal_distribution<double> jitter(0.0, 50e3);
+        std::normal_distribution<double> position_noise(0.0, 1e-3);
+        std::normal_distribution<double> angle_noise(0.0, 1e-3);
+
+        std::remove(path.c_str());
+        turtlelib::PoseLogWriter writer;
+        if(writer.open(path.c_str()) != std::errc{}){
+            return {};
+        }
+        turtlelib::Transform2D pose;
+        turtlelib::Twist2D command{{0.0, 0.2, 0.0}};
+        const double dt = 1.0/600.0;
+        for(std::size_t i = 0; i < n; i++){
+            command.tw[0] = std::clamp(command.tw[0] + accel(rng)*dt*10.0, -1.0, 1.0);
+            command.tw[1] = std::clamp(command.tw[1] + accel(rng)*dt, 0.0, 0.5);
+            pose *= turtlelib::integrate_twist(command, dt);
+            const turtlelib::Transform2D measured({pose.translation().x + position_noise(rng),
+                                                   pose.translation().y + position_noise(rng)},
+                                                  pose.rotation() + angle_noise(rng));
+            const std::int64_t stamp = static_cast<std::int64_t>(i)*1666667 + static_cast<std::int64_t>(jitter(rng));
+            writer.append(turtlelib::make_record(stamp, measured, command));
+        }
+        writer.close();
+
+        turtlelib::PoseLogReader reader;
+        std::vector<turtlelib::StampedPose> poses;
+        if(reader.open(path.c_str()) == std::errc{}){
+            poses.reserve(reader.size());
+            for(const turtlelib::PoseRecord & r : reader){
+                poses.push_back({r.stamp_ns, r.theta, r.x, r.y});
+            }
+        }
+        std::remove(path.c_str());
+        return poses;
+    }
+
+    void run(const char * name, const std::vector<turtlelib::StampedPose> & poses, const turtlelib::PoseCodecConfig & config)
+    {
+        const std::size_t n = poses.size();
+        const double raw_bytes = static_cast<double>(n*sizeof(turtlelib::StampedPose));
+
+        std::vector<std::uint8_t> bytes;
+        const double encode_ns = bench::ns_per_op(1, [&](std::size_t){
+            turtlelib::PoseEncoder encoder(config);
+            encoder.append(poses.data(), n);
+            bytes = encoder.finish();
+        });
+
+        turtlelib::PoseDecoder decoder;
+        decoder.open(bytes.data(), bytes.size());
+        std::vector<turtlelib::StampedPose> decoded(n);
+        const double decode_ns = bench::ns_per_op(3, [&](std::size_t){
+            decoder.decode(0, n, decoded.data());
+            bench::do_not_optimize(decoded.back());
+        });
+
+        double max_error = 0.0;
+        for(std::size_t i = 0; i < n; i++){
+            max_error = std::max({max_error, std::abs(decoded[i].x - poses[i].x), std::abs(decoded[i].y - poses[i].y)});
+        }
+
+        // One pose at a time from random places: a block is decoded up to the pose
+        std::mt19937_64 rng(7);
+        std::uniform_int_distribution<std::size_t> index(0, n - 1);
+        turtlelib::StampedPose pose;
+        const std::size_t lookups = 100000;
+        const double random_ns = bench::ns_per_op(lookups, [&](std::size_t){
+            decoder.decode(index(rng), 1, &pose);
+            bench::do_not_optimize(pose);
+        });
+
+        std::printf("%s: %zu poses, %.1e m / %.1e rad, %u poses per block\n", name, n,
+                    config.position_resolution, config.angle_resolution, config.block_size);
+        std::printf("  %-24s %8.2f bytes/pose  ratio %5.1fx vs %zu-byte poses, %5.1fx vs %zu-byte log records\n",
+                    "size", static_cast<double>(bytes.size())/n, raw_bytes/bytes.size(), sizeof(turtlelib::StampedPose),
+                    static_cast<double>(n*sizeof(turtlelib::PoseRecord))/bytes.size(), sizeof(turtlelib::PoseRecord));
+        std::printf("  %-24s %8.1f MB/s %8.2f ns/pose\n", "encode", raw_bytes/encode_ns*1e3, encode_ns/n);
+        std::printf("  %-24s %8.1f MB/s %8.2f ns/pose\n", "decode (sequential)", raw_bytes/decode_ns*1e3, decode_ns/n);
+        std::printf("  %-24s %8.1f ns/pose\n", "decode (random pose)", random_ns);
+        std::printf("  %-24s %8.2e m\n", "max position error", max_error);
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2160000;
+    const std::string path = argc > 2 ? argv[2] : "/tmp/bench_pose_codec.bin";
+
+    turtlelib::PoseCodecConfig config;
+    const std::vector<turtlelib::StampedPose> smooth = synthetic(n);
+    run("synthetic", smooth, config);
+    config.block_size = 128;
+    run("synthetic", smooth, config);
+
+    const std::vector<turtlelib::StampedPose> odometry = recorded(n, path);
+    if(odometry.empty()){
+        std::printf("cannot write %s\n", path.c_str());
+        return 1;
+    }
+    config.block_size = 1024;
+    run("recorded", odometry, config);
+    // Quantizing below the noise only stores the noise
+    config.position_resolution = 1e-3;
+    config.angle_resolution = 1e-3;
+    run("recorded", odometry, config);
+    return 0;
+}
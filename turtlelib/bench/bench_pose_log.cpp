@@ -0,0 +1,89 @@
+/// \file
+/// \brief Benchmark of the binary pose log: appending records, and scanning them through the
+/// memory mapping (from the page cache), against the text format for size.
+///
+/// Usage: bench_pose_log [records] [file]
+
+#include<cstdio>
+#include<cstdlib>
+#include<string>
+#include "turtlelib/pose_log.hpp"
+#include "turtlelib/text_io.hpp"
+#include "bench.hpp"
+
+int main(int argc, char * argv[])
+{
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000000;
+    const std::string path = argc > 2 ? argv[2] : "/tmp/bench_pose_log.bin";
+    std::remove(path.c_str());
+
+    // A 600 Hz odometry stream along a wandering path
+    auto record = [](std::size_t i){
+        const double t = i/600.0;
+        return turtlelib::make_record(static_cast<std::int64_t>(i)*1666667,
+                                      turtlelib::Transform2D({0.2*t, std::sin(0.1*t)}, 0.3*std::sin(0.05*t)),
+                                      turtlelib::Twist2D{{0.015*std::cos(0.05*t), 0.2, 0.0}});
+    };
+    const double bytes = static_cast<double>(n*sizeof(turtlelib::PoseRecord));
+
+    turtlelib::PoseLogWriter writer;
+    if(writer.open(path.c_str()) != std::errc{}){
+        std::printf("cannot open %s\n", path.c_str());
+        return 1;
+    }
+    std::vector<turtlelib::PoseRecord> records(n);
+    for(std::size_t i = 0; i < n; i++){
+        records[i] = record(i);
+    }
+    const double write_ns = bench::ns_per_op(1, [&](std::size_t){
+        for(const turtlelib::PoseRecord & r : records){
+            writer.append(r);
+        }
+        writer.close();
+    });
+    std::printf("%zu records, %.1f MB (%zu bytes/record)\n", n, bytes/1e6, sizeof(turtlelib::PoseRecord));
+    std::printf("%-32s %8.1f MB/s %8.2f ns/record\n", "append", bytes/write_ns*1e3, write_ns/n);
+
+    turtlelib::PoseLogReader reader;
+    double open_ns = bench::ns_per_op(1, [&](std::size_t){
+        reader.open(path.c_str());
+    });
+    std::printf("%-32s %8.1f us\n", "open (mmap)", open_ns/1e3);
+
+    // First pass faults the pages in from the page cache, the second reads mapped memory
+    const char * passes[] = {"scan x, y (first pass)", "scan x, y (mapped)"};
+    for(const char * name : passes){
+        double sum = 0.0;
+        const double scan_ns = bench::ns_per_op(1, [&](std::size_t){
+            for(const turtlelib::PoseRecord & r : reader){
+                sum += r.x + r.y;
+            }
+        });
+        bench::do_not_optimize(sum);
+        std::printf("%-32s %8.1f MB/s %8.2f ns/record\n", name, bytes/scan_ns*1e3, scan_ns/reader.size());
+    }
+
+    double heading = 0.0;
+    const double pose_ns = bench::ns_per_op(1, [&](std::size_t){
+        for(const turtlelib::PoseRecord & r : reader){
+            heading += r.pose().rotation_cos();
+        }
+    });
+    bench::do_not_optimize(heading);
+    std::printf("%-32s %8.1f MB/s %8.2f ns/record\n", "scan pose() (Transform2D)", bytes/pose_ns*1e3, pose_ns/reader.size());
+
+    // The same poses and twists as text, for size
+    std::size_t text_bytes = 0;
+    char buf[2*turtlelib::max_record_chars];
+    for(const turtlelib::PoseRecord & r : reader){
+        char * p = turtlelib::format(buf, buf + sizeof(buf), r.pose()).ptr;
+        p = turtlelib::format(p, buf + sizeof(buf), r.twist()).ptr;
+        text_bytes += p - buf;
+    }
+    std::printf("text of the same poses and twists, without timestamps: %.1f MB (%.0f bytes/record)\n",
+                text_bytes/1e6, static_cast<double>(text_bytes)/n);
+
+    reader.close();
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,214 @@
+/// \file
+/// \brief Benchmark of Transform2D composition, inversion and application.
+///
+/// Compares the flat cos/sin/x/y layout against the previous nested std::vector layout
+/// and reports heap allocations per operation. Also compares a chained application
+/// evaluated through temporaries with the fused TransformProduct expression (chain()), and
+/// the stored rotation angle with recovering it by atan2.
+
+#include<cstdio>
+#include<cstdlib>
+#include<vector>
+#include "turtlelib/rigid2d.hpp"
+#include "bench.hpp"
+
+namespace
+{
+    /// \brief the previous Transform2D storage, kept only as a baseline for comparison
+    /// Members are noipa so that, like the library, every operation is a real call.
+    class LegacyTransform2D
+    {
+    public:
+        __attribute__((noipa)) LegacyTransform2D(turtlelib::Vector2D trans, double radians)
+        {
+            t = {
+                {cos(radians),-sin(radians),trans.x},
+                {sin(radians),cos(radians),trans.y},
+                {0.0,0.0,1.0}
+            };
+        }
+
+        __attribute__((noipa)) LegacyTransform2D & operator*=(const LegacyTransform2D & rhs)
+        {
+            std::vector<std::vector<double>> temp = t;
+            for(int i=0;i<3;i++){
+                for(int j=0;j<3;j++){
+                    t[i][j] = 0;
+                    for(int k=0;k<3;k++){
+                        t[i][j] = t[i][j] + temp[i][k]*rhs.t[k][j];
+                    }
+                }
+            }
+            return *this;
+        }
+
+        __attribute__((noipa)) LegacyTransform2D inv() const
+        {
+            LegacyTransform2D t_inv({0.0, 0.0}, 0.0);
+            t_inv.t[0][0] = t[0][0];
+            t_inv.t[1][1] = t[1][1];
+            t_inv.t[0][1] = t[1][0];
+            t_inv.t[1][0] = t[0][1];
+            t_inv.t[0][2] = -(t[0][0]*t[0][2] + t[1][0]*t[1][2]);
+            t_inv.t[1][2] = -(t[1][1]*t[1][2] + t[0][1]*t[0][2]);
+            return t_inv;
+        }
+
+        __attribute__((noipa)) turtlelib::Vector2D operator()(turtlelib::Vector2D v) const
+        {
+            return {v.x*t[0][0] + v.y*t[0][1] + t[0][2], v.x*t[1][0] + v.y*t[1][1] + t[1][2]};
+        }
+
+        double x() const
+        {
+            return t[0][2];
+        }
+
+    private:
+        std::vector<std::vector<double>> t;
+    };
+
+    LegacyTransform2D operator*(LegacyTransform2D lhs, const LegacyTransform2D & rhs)
+    {
+        lhs*=rhs;
+        return lhs;
+    }
+
+    /// \brief run one measurement and print ns/op and allocations/op
+    template<class F>
+    double run(const char * name, std::size_t n, F && f)
+    {
+        const std::size_t before = bench::allocation_count();
+        const double ns = bench::ns_per_op(n, f);
+        const double allocs = static_cast<double>(bench::allocation_count() - before)/n;
+        bench::report(name, ns, allocs);
+        return ns;
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+
+    const turtlelib::Transform2D step({0.01, 0.002}, 0.001);
+    const LegacyTransform2D legacy_step({0.01, 0.002}, 0.001);
+
+    turtlelib::Transform2D acc;
+    LegacyTransform2D legacy_acc({0.0, 0.0}, 0.0);
+
+    std::printf("Transform2D layout: %zu bytes, legacy layout: %zu bytes + 4 heap blocks\n",
+                sizeof(turtlelib::Transform2D), sizeof(LegacyTransform2D));
+
+    const double flat_compose = run("flat operator*=", n, [&](std::size_t){
+        acc*=step;
+        bench::do_not_optimize(acc);
+    });
+    const double legacy_compose = run("legacy operator*=", n, [&](std::size_t){
+        legacy_acc*=legacy_step;
+        bench::do_not_optimize(legacy_acc);
+    });
+
+    const double flat_mul = run("flat operator*", n, [&](std::size_t){
+        acc = acc*step;
+        bench::do_not_optimize(acc);
+    });
+    const double legacy_mul = run("legacy operator*", n, [&](std::size_t){
+        legacy_acc = legacy_acc*legacy_step;
+        bench::do_not_optimize(legacy_acc);
+    });
+
+    const double flat_inv = run("flat inv()", n, [&](std::size_t){
+        turtlelib::Transform2D t = acc.inv();
+        bench::do_not_optimize(t);
+    });
+    const double legacy_inv = run("legacy inv()", n, [&](std::size_t){
+        LegacyTransform2D t = legacy_acc.inv();
+        bench::do_not_optimize(t);
+    });
+
+    turtlelib::Vector2D v{1.0, 2.0};
+    const double flat_apply = run("flat operator()(Vector2D)", n, [&](std::size_t){
+        v = step(v);
+        bench::do_not_optimize(v);
+    });
+    turtlelib::Vector2D lv{1.0, 2.0};
+    const double legacy_apply = run("legacy operator()(Vector2D)", n, [&](std::size_t){
+        lv = legacy_step(lv);
+        bench::do_not_optimize(lv);
+    });
+
+    std::printf("\nspeedup: compose %.1fx, multiply %.1fx, inverse %.1fx, apply %.1fx\n",
+                legacy_compose/flat_compose, legacy_mul/flat_mul,
+                legacy_inv/flat_inv, legacy_apply/flat_apply);
+    std::printf("final x (flat/legacy): %f %f\n", acc.translation().x, legacy_acc.x());
+
+    // Chained application t_ab*t_bc*t_cd(v): materializing each product versus the fused expression.
+    // The transforms change every iteration, as they do when frames move, so nothing can be hoisted.
+    const std::size_t frames = 1024;
+    std::vector<turtlelib::Transform2D> t_ab, t_bc, t_cd;
+    for(std::size_t i = 0; i < frames; i++){
+        t_ab.emplace_back(turtlelib::Vector2D{0.0, 1.0 + 1e-3*i}, 0.3 + 1e-4*i);
+        t_bc.emplace_back(turtlelib::Vector2D{1.0, 0.5}, -0.2 - 1e-4*i);
+        t_cd.emplace_back(turtlelib::Vector2D{-0.032, 1e-3*i}, 0.05);
+    }
+    std::vector<turtlelib::Vector2D> points(frames, turtlelib::Vector2D{0.5, -0.25});
+    turtlelib::Vector2D p;
+
+    auto eager = [&](std::size_t i){
+        const std::size_t k = i%frames;
+        turtlelib::Transform2D t_ac = t_ab[k];
+        t_ac*=t_bc[k];
+        turtlelib::Transform2D t_ad = t_ac;
+        t_ad*=t_cd[k];
+        p = t_ad(points[k]);
+        bench::do_not_optimize(p);
+    };
+    auto fused = [&](std::size_t i){
+        const std::size_t k = i%frames;
+        p = turtlelib::chain(t_ab[k], t_bc[k], t_cd[k])(points[k]);
+        bench::do_not_optimize(p);
+    };
+
+    std::printf("\n");
+    const double eager_ns = run("chain, temporaries", n, eager);
+    const double fused_ns = run("chain, fused expression", n, fused);
+    // Per chained application: two compositions (8 mul + 6 add each, plus the angle sum and its wrap test)
+    // and one application (4 mul + 4 add), against three applications
+    std::printf("floating-point operations per chained application: temporaries 38 (+2 compares), fused 24\n");
+
+    bench::InstructionCounter counter;
+    if(counter.valid()){
+        const long long eager_ins = counter.count([&]{ for(std::size_t i = 0; i < n; i++){ eager(i); } });
+        const long long fused_ins = counter.count([&]{ for(std::size_t i = 0; i < n; i++){ fused(i); } });
+        std::printf("instructions per chained application: temporaries %.1f, fused %.1f\n",
+                    static_cast<double>(eager_ins)/n, static_cast<double>(fused_ins)/n);
+    } else {
+        std::printf("instruction counter unavailable (perf_event_open failed)\n");
+    }
+    std::printf("chain speedup %.2fx\n", eager_ns/fused_ns);
+
+    // A controller tick reads the heading of every robot, then moves a twist into the world frame.
+    // The transforms are the varying chain operands, so the angle cannot be hoisted.
+    const turtlelib::Twist2D body{{0.5, 0.2, 0.0}};
+    double heading = 0.0;
+    turtlelib::Twist2D world;
+    std::printf("\n");
+    const double stored_ns = run("rotation() + adjoint, stored angle", n, [&](std::size_t i){
+        const turtlelib::Transform2D & tf = t_ab[i%frames];
+        heading = tf.rotation();
+        world = tf(body);
+        bench::do_not_optimize(heading);
+        bench::do_not_optimize(world);
+    });
+    const double atan2_ns = run("rotation() + adjoint, atan2 + sin/cos", n, [&](std::size_t i){
+        // What rotation() and the adjoint cost when the angle is recovered from the matrix
+        const turtlelib::Transform2D & tf = t_ab[i%frames];
+        heading = std::atan2(tf.rotation_sin(), tf.rotation_cos());
+        world = turtlelib::Transform2D(tf.translation(), heading)(body);
+        bench::do_not_optimize(heading);
+        bench::do_not_optimize(world);
+    });
+    std::printf("stored angle speedup %.2fx\n", atan2_ns/stored_ns);
+
+    return 0;
+}
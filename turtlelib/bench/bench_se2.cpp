@@ -0,0 +1,82 @@
+/// \file
+/// \brief Benchmark of exact twist integration (integrate_twist) against an Euler step.
+///
+/// A constant twist is followed at the nusim rate, so the exact trajectory is a circle.
+/// Reports the final pose error of both integrators and their cost per step.
+///
+/// Usage: bench_se2 [rate in Hz] [seconds]
+
+#include<cmath>
+#include<cstdio>
+#include<cstdlib>
+#include<vector>
+#include "turtlelib/batch2d.hpp"
+#include "bench.hpp"
+
+namespace
+{
+    /// \brief pose in the world frame as updated by the Euler integrator
+    struct EulerPose
+    {
+        double theta = 0.0;
+        double x = 0.0;
+        double y = 0.0;
+    };
+
+    /// \brief one forward Euler step of a body twist
+    EulerPose euler_step(EulerPose p, const turtlelib::Twist2D & twist, double dt)
+    {
+        const double c = std::cos(p.theta);
+        const double s = std::sin(p.theta);
+        p.x += (c*twist.xdot() - s*twist.ydot())*dt;
+        p.y += (s*twist.xdot() + c*twist.ydot())*dt;
+        p.theta += twist.thetadot()*dt;
+        return p;
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    const double rate = argc > 1 ? std::atof(argv[1]) : 600.0;
+    const double seconds = argc > 2 ? std::atof(argv[2]) : 600.0;
+    const std::size_t steps = static_cast<std::size_t>(rate*seconds);
+    const double dt = 1.0/rate;
+
+    // 0.22 m/s forward while turning at 1.5 rad/s: a circle of radius 0.1467 m
+    const turtlelib::Twist2D twist{{1.5, 0.22, 0.0}};
+    const double total = steps*dt;
+    const double r = twist.xdot()/twist.thetadot();
+    const double x_true = r*std::sin(twist.thetadot()*total);
+    const double y_true = r*(1.0 - std::cos(twist.thetadot()*total));
+
+    std::printf("%zu steps at %.0f Hz (%.0f s)\n", steps, rate, seconds);
+
+    turtlelib::Transform2D exact;
+    const double exact_ns = bench::ns_per_op(steps, [&](std::size_t){
+        exact*=turtlelib::integrate_twist(twist, dt);
+        bench::do_not_optimize(exact);
+    });
+
+    EulerPose euler;
+    const double euler_ns = bench::ns_per_op(steps, [&](std::size_t){
+        euler = euler_step(euler, twist, dt);
+        bench::do_not_optimize(euler);
+    });
+
+    std::vector<turtlelib::Twist2D> twists(steps, twist);
+    std::vector<turtlelib::Transform2D> poses(steps);
+    const double batch_ns = bench::ns_per_op(1, [&](std::size_t){
+        turtlelib::integrate_twist_sequence(turtlelib::Transform2D{}, twists.data(), poses.data(), steps, dt);
+        bench::do_not_optimize(poses.data());
+    })/steps;
+
+    const double exact_err = std::hypot(exact.translation().x - x_true, exact.translation().y - y_true);
+    const double batch_err = std::hypot(poses.back().translation().x - x_true, poses.back().translation().y - y_true);
+    const double euler_err = std::hypot(euler.x - x_true, euler.y - y_true);
+
+    std::printf("%-28s %10.2f ns/step   position error %.3e m\n", "integrate_twist", exact_ns, exact_err);
+    std::printf("%-28s %10.2f ns/step   position error %.3e m\n", "integrate_twist_sequence", batch_ns, batch_err);
+    std::printf("%-28s %10.2f ns/step   position error %.3e m\n", "Euler", euler_ns, euler_err);
+
+    return 0;
+}
@@ -0,0 +1,173 @@
+/// \file
+/// \brief Benchmark of reading and writing a text pose log: parse() and format() on a buffer,
+/// the stream operators built on them, and the previous iostream implementations.
+///
+/// Usage: bench_text_io [poses]
+
+#include<cstdio>
+#include<cstdlib>
+#include<sstream>
+#include<string>
+#include<vector>
+#include "turtlelib/text_io.hpp"
+#include "bench.hpp"
+
+namespace
+{
+    /// \brief the previous operator>>(std::istream &, Transform2D &), kept only as a baseline
+    void legacy_read(std::istream & is, turtlelib::Transform2D & tf)
+    {
+        double angle = 0.0;
+        double num;
+        turtlelib::Vector2D v;
+        int i = 0;
+        std::string temp;
+        if(is.peek() == 'd'){
+            while(i < 3){
+                is >> temp;
+                if(std::stringstream(temp) >> num){
+                    if(i == 0){
+                        angle = num;
+                    }
+                    if(i == 1){
+                        v.x = num;
+                    }
+                    if(i == 2){
+                        v.y = num;
+                    }
+                    i++;
+                }
+            }
+            tf = turtlelib::Transform2D(v, turtlelib::deg2rad(angle));
+        } else {
+            is >> angle >> v.x >> v.y;
+            tf = turtlelib::Transform2D(v, turtlelib::deg2rad(angle));
+        }
+        // The old reader left the newline in the stream
+        is.get();
+    }
+
+    /// \brief the previous operator<<(std::ostream &, const Transform2D &), at round-trip precision
+    void legacy_write(std::ostream & os, const turtlelib::Transform2D & tf)
+    {
+        const turtlelib::Vector2D v = tf.translation();
+        os << "deg: " << turtlelib::rad2deg(tf.rotation()) << " x: " << v.x << " y: " << v.y << "\n";
+    }
+
+    /// \brief print one throughput line
+    void report_rate(const char * name, double ns, std::size_t bytes, std::size_t poses, std::size_t allocs)
+    {
+        std::printf("%-34s %8.1f MB/s %8.1f ns/pose %8.2f allocs/pose\n",
+                    name, bytes/ns*1e3, ns/poses, static_cast<double>(allocs)/poses);
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+
+    // A pose log in the labelled format, at full double precision
+    std::string text;
+    char line[128];
+    for(std::size_t i = 0; i < n; i++){
+        const int len = std::snprintf(line, sizeof(line), "deg: %.17g x: %.17g y: %.17g\n",
+                                      0.0123*i - 90.0, 1e-3*i, -2.5 + 7e-5*i);
+        text.append(line, len);
+    }
+    std::printf("%zu poses, %.1f MB\n", n, text.size()/1e6);
+
+    double check = 0.0;
+    std::size_t before = bench::allocation_count();
+    const double parse_ns = bench::ns_per_op(1, [&](std::size_t){
+        const char * last = text.data() + text.size();
+        turtlelib::Transform2D tf;
+        for(const char * p = turtlelib::skip_space(text.data(), last); p != last; p = turtlelib::skip_space(p, last)){
+            const std::from_chars_result result = turtlelib::parse(p, last, tf);
+            if(result.ec != std::errc{}){
+                std::printf("parse error at offset %td\n", result.ptr - text.data());
+                break;
+            }
+            check += tf.translation().x;
+            p = result.ptr;
+        }
+    });
+    report_rate("parse()", parse_ns, text.size(), n, bench::allocation_count() - before);
+
+    std::istringstream stream(text);
+    before = bench::allocation_count();
+    const double stream_ns = bench::ns_per_op(1, [&](std::size_t){
+        turtlelib::Transform2D tf;
+        while(stream >> tf){
+            check -= tf.translation().x;
+        }
+    });
+    report_rate("operator>>", stream_ns, text.size(), n, bench::allocation_count() - before);
+
+    std::istringstream legacy_stream(text);
+    before = bench::allocation_count();
+    const double legacy_ns = bench::ns_per_op(1, [&](std::size_t){
+        turtlelib::Transform2D tf;
+        for(std::size_t i = 0; i < n; i++){
+            legacy_read(legacy_stream, tf);
+            check += tf.translation().x;
+        }
+    });
+    report_rate("previous operator>> (stringstream)", legacy_ns, text.size(), n, bench::allocation_count() - before);
+
+    bench::do_not_optimize(check);
+    std::printf("speedup over the previous operator>>: parse() %.1fx, operator>> %.1fx\n\n",
+                legacy_ns/parse_ns, legacy_ns/stream_ns);
+
+    // Writing the same poses back out
+    std::vector<turtlelib::Transform2D> poses(n);
+    {
+        const char * last = text.data() + text.size();
+        const char * p = text.data();
+        for(turtlelib::Transform2D & tf : poses){
+            p = turtlelib::parse(p, last, tf).ptr;
+        }
+    }
+
+    // format() into a reusable 64 KiB buffer, flushed whenever it fills, as a log writer would
+    std::string out;
+    out.reserve(2*text.size());
+    std::vector<char> buf(65536);
+    before = bench::allocation_count();
+    const double format_ns = bench::ns_per_op(1, [&](std::size_t){
+        std::size_t done = 0;
+        while(done < n){
+            std::size_t written = 0;
+            const std::to_chars_result result = turtlelib::format(buf.data(), buf.data() + buf.size(),
+                                                                  poses.data() + done, n - done, written);
+            out.append(buf.data(), result.ptr - buf.data());
+            done += written;
+        }
+    });
+    report_rate("format()", format_ns, out.size(), n, bench::allocation_count() - before);
+    const std::size_t format_bytes = out.size();
+
+    std::ostringstream os;
+    before = bench::allocation_count();
+    const double insert_ns = bench::ns_per_op(1, [&](std::size_t){
+        for(const turtlelib::Transform2D & tf : poses){
+            os << tf;
+        }
+    });
+    report_rate("operator<<", insert_ns, format_bytes, n, bench::allocation_count() - before);
+
+    std::ostringstream legacy_os;
+    legacy_os.precision(17);
+    before = bench::allocation_count();
+    const double legacy_write_ns = bench::ns_per_op(1, [&](std::size_t){
+        for(const turtlelib::Transform2D & tf : poses){
+            legacy_write(legacy_os, tf);
+        }
+    });
+    report_rate("previous operator<< (precision 17)", legacy_write_ns, format_bytes, n, bench::allocation_count() - before);
+    bench::do_not_optimize(os.str().size() + legacy_os.str().size());
+
+    std::printf("speedup over the previous operator<<: format() %.1fx, operator<< %.1fx\n",
+                legacy_write_ns/format_ns, legacy_write_ns/insert_ns);
+
+    return 0;
+}
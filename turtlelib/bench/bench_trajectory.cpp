@@ -0,0 +1,86 @@
+/// \file
+/// \brief Benchmark of parallel trajectory reconstruction against the serial operator*= fold,
+/// and of TrajectoryIndex relative-pose queries against composing the span by hand.
+///
+/// Usage: bench_trajectory [increments] [max threads]
+
+#include<algorithm>
+#include<cmath>
+#include<cstdio>
+#include<cstdlib>
+#include<thread>
+#include<vector>
+#include "turtlelib/trajectory.hpp"
+#include "bench.hpp"
+
+int main(int argc, char * argv[])
+{
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    const unsigned max_threads = argc > 2 ? std::atoi(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<turtlelib::Transform2D> increments;
+    increments.reserve(n);
+    for(std::size_t i = 0; i < n; i++){
+        increments.emplace_back(turtlelib::Vector2D{0.01, 1e-4*(i%7)}, 0.002*std::sin(1e-4*i));
+    }
+    std::vector<turtlelib::Transform2D> serial(n);
+    std::vector<turtlelib::Transform2D> poses(n);
+
+    const double serial_ns = bench::ns_per_op(1, [&](std::size_t){
+        turtlelib::Transform2D pose;
+        for(std::size_t i = 0; i < n; i++){
+            pose*=increments[i];
+            serial[i] = pose;
+        }
+        bench::do_not_optimize(serial.data());
+    });
+    std::printf("%zu increments, %u hardware threads\n", n, std::thread::hardware_concurrency());
+    std::printf("%-20s %8.1f ms %8.1f Mposes/s\n", "serial fold", serial_ns*1e-6, n/serial_ns*1e3);
+
+    for(unsigned threads = 1; threads <= max_threads; threads++){
+        const double ns = bench::ns_per_op(1, [&](std::size_t){
+            turtlelib::build_trajectory(increments.data(), poses.data(), n, threads);
+            bench::do_not_optimize(poses.data());
+        });
+
+        double max_err = 0.0;
+        for(std::size_t i = 0; i < n; i++){
+            max_err = std::max(max_err, std::fabs(poses[i].translation().x - serial[i].translation().x));
+            max_err = std::max(max_err, std::fabs(poses[i].translation().y - serial[i].translation().y));
+        }
+        std::printf("%2u threads %9s %8.1f ms %8.1f Mposes/s  speedup %.2fx  max |diff| %.2e\n",
+                    threads, "", ns*1e-6, n/ns*1e3, serial_ns/ns, max_err);
+    }
+
+    // Relative-pose queries over the same increments
+    const double build_ns = bench::ns_per_op(1, [&](std::size_t){
+        turtlelib::TrajectoryIndex index(increments.data(), n);
+        bench::do_not_optimize(index.size());
+    });
+    turtlelib::TrajectoryIndex index;
+    const double append_ns = bench::ns_per_op(n, [&](std::size_t i){
+        index.append(increments[i]);
+    });
+    std::printf("\nTrajectoryIndex build %.1f ms, append %.1f ns/increment\n", build_ns*1e-6, append_ns);
+
+    const std::size_t queries = 20000;
+    for(std::size_t span = 10; span <= n; span *= 100){
+        const double indexed = bench::ns_per_op(queries, [&](std::size_t q){
+            const std::size_t i = (q*7919)%(n - span + 1);
+            turtlelib::Transform2D t = index.relative(i, i + span);
+            bench::do_not_optimize(t);
+        });
+        const std::size_t direct_queries = std::max<std::size_t>(1, queries*10/span);
+        const double direct = bench::ns_per_op(direct_queries, [&](std::size_t q){
+            const std::size_t i = (q*7919)%(n - span + 1);
+            turtlelib::Transform2D t;
+            for(std::size_t k = i; k < i + span; k++){
+                t*=increments[k];
+            }
+            bench::do_not_optimize(t);
+        });
+        std::printf("span %9zu: index %8.1f ns/query, direct composition %12.1f ns/query\n", span, indexed, direct);
+    }
+
+    return 0;
+}
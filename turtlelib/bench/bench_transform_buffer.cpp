@@ -0,0 +1,145 @@
+/// \file
+/// \brief Contention benchmark of TransformBuffer: one writer pushing as fast as it can while
+/// N readers look up recent times, against the same ring guarded by a std::mutex.
+/// Reports pushes and lookups per second, and the slowest push, which is where a lock held by
+/// readers shows up as writer stalls.
+///
+/// Usage: bench_transform_buffer [max readers] [milliseconds per run]
+
+#include<algorithm>
+#include<atomic>
+#include<chrono>
+#include<cstdio>
+#include<cstdlib>
+#include<mutex>
+#include<thread>
+#include<vector>
+#include "turtlelib/transform_buffer.hpp"
+#include "bench.hpp"
+
+namespace
+{
+    /// \brief the time between samples: a 1 kHz simulator
+    constexpr std::int64_t period = 1000000;
+
+    /// \brief the same ring and lookup as TransformBuffer, with one lock around everything
+    class LockedBuffer
+    {
+    public:
+        explicit LockedBuffer(std::size_t capacity) : ring(capacity) {}
+
+        std::errc push(std::int64_t stamp_ns, const turtlelib::Transform2D & tf)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ring[head % ring.size()] = {stamp_ns, tf};
+            head++;
+            return std::errc{};
+        }
+
+        std::errc lookup(std::int64_t stamp_ns, turtlelib::Transform2D & tf) const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            const std::size_t begin = head > ring.size() ? head - ring.size() : 0;
+            if(head < 2 || stamp_ns < at(begin).stamp_ns || stamp_ns >= at(head - 1).stamp_ns){
+                return std::errc::result_out_of_range;
+            }
+            std::size_t lo = begin;
+            std::size_t hi = head - 1;
+            while(hi - lo > 1){
+                const std::size_t mid = lo + (hi - lo)/2;
+                (at(mid).stamp_ns <= stamp_ns ? lo : hi) = mid;
+            }
+            const Sample & a = at(lo);
+            const Sample & b = at(hi);
+            const double u = static_cast<double>(stamp_ns - a.stamp_ns)/static_cast<double>(b.stamp_ns - a.stamp_ns);
+            tf = a.tf*turtlelib::integrate_twist(turtlelib::log(a.tf.inv()*b.tf), u);
+            return std::errc{};
+        }
+
+    private:
+        struct Sample
+        {
+            std::int64_t stamp_ns;
+            turtlelib::Transform2D tf;
+        };
+
+        const Sample & at(std::size_t k) const
+        {
+            return ring[k % ring.size()];
+        }
+
+        std::vector<Sample> ring;
+        std::size_t head = 0;
+        mutable std::mutex mutex;
+    };
+
+    /// \brief one writer and some readers on a buffer for a while
+    template<class Buffer>
+    void run(const char * name, unsigned readers, std::chrono::milliseconds duration)
+    {
+        Buffer buffer(4096);
+        std::atomic<std::int64_t> latest{0};
+        std::atomic<bool> done{false};
+        std::vector<std::size_t> lookups(readers, 0);
+        std::vector<std::thread> threads;
+        for(unsigned r = 0; r < readers; r++){
+            threads.emplace_back([&, r]{
+                std::int64_t offset = 12345*(r + 1);
+                std::size_t count = 0;
+                while(!done.load(std::memory_order_relaxed)){
+                    // Anywhere in the last second, like tf consumers catching up on messages
+                    offset = (offset + 7777777) % 1000000000;
+                    turtlelib::Transform2D tf;
+                    if(buffer.lookup(latest.load(std::memory_order_relaxed) - offset, tf) == std::errc{}){
+                        count++;
+                    }
+                    bench::do_not_optimize(tf);
+                }
+                lookups[r] = count;
+            });
+        }
+
+        const turtlelib::Twist2D twist{{0.5, 0.3, 0.0}};
+        const turtlelib::Transform2D step = turtlelib::integrate_twist(twist, period*1e-9);
+        turtlelib::Transform2D pose;
+        std::size_t pushes = 0;
+        double slowest = 0.0;
+        const auto start = std::chrono::steady_clock::now();
+        auto now = start;
+        while(now - start < duration){
+            pose*=step;
+            buffer.push(static_cast<std::int64_t>(pushes)*period, pose);
+            latest.store(static_cast<std::int64_t>(pushes)*period, std::memory_order_relaxed);
+            pushes++;
+            const auto after = std::chrono::steady_clock::now();
+            slowest = std::max(slowest, std::chrono::duration<double, std::nano>(after - now).count());
+            now = after;
+        }
+        done = true;
+        for(std::thread & t : threads){
+            t.join();
+        }
+
+        const double seconds = std::chrono::duration<double>(now - start).count();
+        std::size_t total = 0;
+        for(const std::size_t n : lookups){
+            total += n;
+        }
+        std::printf("%-10s %2u readers %9.2f Mpush/s %9.2f Mlookup/s (%7.2f per reader)  slowest push %9.1f us\n",
+                    name, readers, pushes/seconds*1e-6, total/seconds*1e-6,
+                    readers ? total/seconds*1e-6/readers : 0.0, slowest*1e-3);
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    const unsigned max_readers = argc > 1 ? std::atoi(argv[1]) : std::max(2u, 2*std::thread::hardware_concurrency());
+    const std::chrono::milliseconds duration(argc > 2 ? std::atoi(argv[2]) : 500);
+
+    std::printf("%u hardware threads, 4096 samples, lookups over the last second\n", std::thread::hardware_concurrency());
+    for(unsigned readers = 0; readers <= max_readers; readers = readers ? 2*readers : 1){
+        run<turtlelib::TransformBuffer>("seqlock", readers, duration);
+        run<LockedBuffer>("mutex", readers, duration);
+    }
+    return 0;
+}
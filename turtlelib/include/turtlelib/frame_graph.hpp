@@ -0,0 +1,154 @@
+#ifndef FRAME_GRAPH_INCLUDE_GUARD_HPP
+#define FRAME_GRAPH_INCLUDE_GUARD_HPP
+/// \file
+/// \brief A tree of named 2D frames with cached lookups between any two of them.
+///
+/// Frame names are interned once to integer ids, so the per-tick work (updating an edge,
+/// looking up a transform) indexes arrays instead of hashing strings.
+/// Every frame caches its transform from the root of its tree. A lookup between two frames
+/// composes their cached transforms: T_ab = T_root_a^-1 * T_root_b. A cache is filled by
+/// composing down from the nearest ancestor whose cache is still valid.
+/// Updating an edge invalidates the caches of the child's subtree only, and stops early at
+/// subtrees that are already invalid, so updating one edge every tick costs O(1) between lookups.
+///
+/// The graph is not safe to share between threads: lookups fill the caches.
+/// Errors are reported as std::errc values, std::errc{} meaning success, as in text_io.hpp.
+
+
+#include<cstdint>
+#include<deque>
+#include<string>
+#include<string_view>
+#include<system_error>
+#include<unordered_map>
+#include<vector>
+#include "turtlelib/rigid2d.hpp"
+
+namespace turtlelib
+{
+
+    /// \brief the id of an interned frame name
+    using FrameId = std::uint32_t;
+
+    /// \brief the id that no frame has
+    constexpr FrameId no_frame = ~FrameId{0};
+
+    /// \brief a forest of frames connected by parent-to-child transforms
+    class FrameGraph
+    {
+    public:
+        /// \brief an empty graph
+        FrameGraph() = default;
+
+        /// \brief copy a graph; the name index is rebuilt to view the copy's own names
+        FrameGraph(const FrameGraph & other);
+
+        /// \brief copy a graph; the name index is rebuilt to view the copy's own names
+        FrameGraph & operator=(const FrameGraph & other);
+
+        /// \brief moving keeps the names in place, so the index moves with them
+        FrameGraph(FrameGraph &&) = default;
+
+        /// \brief moving keeps the names in place, so the index moves with them
+        FrameGraph & operator=(FrameGraph &&) = default;
+
+        /// \brief the id of a frame, adding the frame (without a parent) if it is new
+        /// \param name - the frame name
+        /// \return its id; ids are handed out from 0 in order
+        FrameId intern(std::string_view name);
+
+        /// \brief the id of an existing frame
+        /// \param name - the frame name
+        /// \return its id, or no_frame if there is no frame of that name
+        FrameId find(std::string_view name) const;
+
+        /// \brief the name of a frame
+        /// \param id - a frame id returned by intern()
+        const std::string & name(FrameId id) const
+        {
+            return names[id];
+        }
+
+        /// \brief the number of frames
+        std::size_t size() const
+        {
+            return names.size();
+        }
+
+        /// \brief set the transform from a parent frame to a child frame
+        /// The child is attached to the parent, moving it (with its subtree) from any previous parent.
+        /// \param parent - the parent frame
+        /// \param child - the child frame
+        /// \param tf - T_parent_child, the pose of the child in the parent frame
+        /// \return std::errc{} on success, std::errc::invalid_argument for an unknown id or if the
+        ///         parent is the child or one of its descendants
+        std::errc set_transform(FrameId parent, FrameId child, const Transform2D & tf);
+
+        /// \brief set_transform() by name, interning the names
+        std::errc set_transform(std::string_view parent, std::string_view child, const Transform2D & tf);
+
+        /// \brief the transform between two frames
+        /// \param a - the frame to express b in
+        /// \param b - the other frame
+        /// \param tf [out] - T_ab, the pose of b in frame a
+        /// \return std::errc{} on success, std::errc::invalid_argument for an unknown id,
+        ///         std::errc::no_link if the frames are in different trees
+        std::errc lookup(FrameId a, FrameId b, Transform2D & tf) const;
+
+        /// \brief lookup() by name
+        /// \return as lookup(), with std::errc::invalid_argument for an unknown name
+        std::errc lookup(std::string_view a, std::string_view b, Transform2D & tf) const;
+
+        /// \brief the parent of a frame
+        /// \param id - a frame id
+        /// \return the parent, or no_frame for a root
+        FrameId parent(FrameId id) const
+        {
+            return frames[id].parent;
+        }
+
+    private:
+        /// \brief a node of the tree
+        struct Frame
+        {
+            /// \brief T_parent_frame
+            Transform2D edge;
+
+            /// \brief T_root_frame, when valid
+            Transform2D from_root;
+
+            /// \brief the parent, no_frame for a root
+            FrameId parent = no_frame;
+
+            /// \brief the root of the tree, when valid
+            FrameId root = no_frame;
+
+            /// \brief whether from_root and root are up to date. A valid frame has a valid parent.
+            bool valid = false;
+
+            /// \brief the frames whose parent this is
+            std::vector<FrameId> children;
+        };
+
+        /// \brief fill the cache of a frame and of the ancestors it needs
+        const Frame & resolve(FrameId id) const;
+
+        /// \brief mark a subtree out of date
+        void invalidate(FrameId id);
+
+        /// \brief the frames, indexed by id; mutable for the caches
+        mutable std::vector<Frame> frames;
+
+        /// \brief the frame names, indexed by id; a deque so that the ids map can view them
+        std::deque<std::string> names;
+
+        /// \brief the id of every name, viewing the strings in names
+        std::unordered_map<std::string_view, FrameId> ids;
+
+        /// \brief scratch path for resolve(), kept to avoid allocating
+        mutable std::vector<FrameId> path;
+    };
+
+}
+
+#endif
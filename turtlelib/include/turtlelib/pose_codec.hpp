@@ -0,0 +1,185 @@
+#ifndef POSE_CODEC_INCLUDE_GUARD_HPP
+#define POSE_CODEC_INCLUDE_GUARD_HPP
+/// \file
+/// \brief Lossy compression of timestamped pose streams by quantization and delta coding.
+///
+/// Poses are quantized to a fixed resolution (e.g. 0.1 mm and 1e-5 rad), so the error of every
+/// decoded pose is at most half the resolution; it does not accumulate along the stream.
+/// Timestamps are kept exactly.
+///
+/// The stream is cut into blocks of a fixed number of poses. A block stores its first pose in
+/// full and its first difference as varints. The remaining poses are stored as second differences
+/// (the change in velocity), which are near zero for a smoothly moving robot. Those are
+/// bit-packed per field at the smallest width that fits every value in the block. Any block can
+/// be decoded on its own, which gives random access at block granularity.
+///
+/// Layout of an encoded stream (native byte order, little-endian on every supported platform):
+///   header  magic "TLPCODEC", version, block size, position and angle resolution (32 bytes)
+///   blocks
+///   index   byte offset of every block (8 bytes each)
+///   footer  number of poses, offset of the index (16 bytes)
+///
+/// Errors are reported as std::errc values, std::errc{} meaning success, as in text_io.hpp.
+
+
+#include<cstddef>
+#include<cstdint>
+#include<system_error>
+#include<vector>
+#include "turtlelib/rigid2d.hpp"
+
+namespace turtlelib
+{
+
+    /// \brief a pose at an instant
+    struct StampedPose
+    {
+        /// \brief the time, in nanoseconds
+        std::int64_t stamp_ns = 0;
+
+        /// \brief the heading, in radians
+        double theta = 0.0;
+
+        /// \brief the x position
+        double x = 0.0;
+
+        /// \brief the y position
+        double y = 0.0;
+    };
+
+    /// \brief how a pose stream is quantized and blocked
+    struct PoseCodecConfig
+    {
+        /// \brief the position quantum, e.g. 1e-4 for 0.1 mm
+        double position_resolution = 1e-4;
+
+        /// \brief the heading quantum, in radians; decoded headings are wrapped to (-PI, PI]
+        double angle_resolution = 1e-5;
+
+        /// \brief poses per block: the unit of random access
+        std::uint32_t block_size = 1024;
+    };
+
+    /// \brief compresses a stream of poses, appended one at a time or in arrays
+    class PoseEncoder
+    {
+    public:
+        /// \brief start an empty stream
+        /// \param config - the resolutions and block size; the block size must be at least 1
+        explicit PoseEncoder(const PoseCodecConfig & config = PoseCodecConfig{});
+
+        /// \brief add one pose
+        /// \param pose - the pose
+        /// \return std::errc{} on success, std::errc::invalid_argument for a NaN or after finish(),
+        ///         std::errc::value_too_large if a coordinate is too far out for the resolution
+        ///         (more than 2^53 quanta) or infinite
+        std::errc append(const StampedPose & pose);
+
+        /// \brief add an array of poses
+        /// \param poses - n poses
+        /// \param n - number of poses
+        /// \return std::errc{} on success, or the error for the first pose that failed; the poses
+        ///         before it were added
+        std::errc append(const StampedPose * poses, std::size_t n);
+
+        /// \brief complete the stream; no poses can be appended afterwards
+        /// \return the encoded stream
+        const std::vector<std::uint8_t> & finish();
+
+        /// \brief the number of poses appended
+        std::size_t size() const
+        {
+            return count;
+        }
+
+    private:
+        /// \brief encode the buffered block
+        void flush_block();
+
+        /// \brief the resolutions and block size
+        PoseCodecConfig config;
+
+        /// \brief the quantized fields (stamp, theta, x, y) of the poses in the current block
+        std::vector<std::uint64_t> block;
+
+        /// \brief byte offset of every block written
+        std::vector<std::uint64_t> offsets;
+
+        /// \brief the encoded stream
+        std::vector<std::uint8_t> out;
+
+        /// \brief the previous heading, to unwrap the heading across +-PI
+        double prev_theta = 0.0;
+
+        /// \brief whole turns added to the heading so that it is continuous
+        std::int64_t turns = 0;
+
+        /// \brief number of poses appended
+        std::size_t count = 0;
+
+        /// \brief whether finish() was called
+        bool finished = false;
+    };
+
+    /// \brief decodes a stream made by PoseEncoder, sequentially or from any block
+    /// The decoder reads the encoded bytes in place; they must outlive it.
+    class PoseDecoder
+    {
+    public:
+        /// \brief check an encoded stream and read its header and index
+        /// \param data - the encoded stream
+        /// \param size - its size in bytes
+        /// \return std::errc{} on success, std::errc::invalid_argument if it is not a valid stream,
+        ///         std::errc::not_supported for another version
+        std::errc open(const std::uint8_t * data, std::size_t size);
+
+        /// \brief the number of poses
+        std::size_t size() const
+        {
+            return count;
+        }
+
+        /// \brief the number of blocks
+        std::size_t blocks() const
+        {
+            return block_count;
+        }
+
+        /// \brief the resolutions and block size the stream was encoded with
+        const PoseCodecConfig & config() const
+        {
+            return cfg;
+        }
+
+        /// \brief decode a range of poses; only the blocks that overlap it are read
+        /// \param first - index of the first pose
+        /// \param n - number of poses; first + n must be at most size()
+        /// \param out [out] - n poses
+        /// \return std::errc{} on success, std::errc::invalid_argument if the range is out of bounds
+        ///         or a block is corrupt
+        std::errc decode(std::size_t first, std::size_t n, StampedPose * out) const;
+
+    private:
+        /// \brief decode poses [skip, skip + n) of block b
+        /// Poses within a block are decoded in order, so reaching pose skip costs skip steps.
+        std::errc decode_block(std::size_t b, std::size_t skip, std::size_t n, StampedPose * out) const;
+
+        /// \brief the encoded stream
+        const std::uint8_t * bytes = nullptr;
+
+        /// \brief offset of the index of block offsets, where the blocks end
+        std::size_t index_offset = 0;
+
+        /// \brief the resolutions and block size
+        PoseCodecConfig cfg;
+
+        /// \brief number of poses
+        std::size_t count = 0;
+
+        /// \brief number of blocks
+        std::size_t block_count = 0;
+    };
+
+}
+
+#endif
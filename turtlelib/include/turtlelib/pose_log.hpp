@@ -0,0 +1,275 @@
+#ifndef POSE_LOG_INCLUDE_GUARD_HPP
+#define POSE_LOG_INCLUDE_GUARD_HPP
+/// \file
+/// \brief A binary log of timestamped poses and twists, with an appending writer and a
+/// memory-mapped reader.
+///
+/// File layout (version 1, native byte order, little-endian on every supported platform):
+///   PoseLogHeader  (32 bytes)
+///   PoseRecord     (56 bytes) * n
+/// There is no record count in the header: it is derived from the file size, so appending
+/// never rewrites the header, and a partial record left by a crash is ignored.
+/// Values are stored as doubles, so a log is lossless, unlike the text format.
+///
+/// Errors are reported as std::errc values, std::errc{} meaning success, as in text_io.hpp.
+/// The reader and writer use POSIX file and memory-mapping calls.
+
+
+#include<cstddef>
+#include<cstdint>
+#include<system_error>
+#include<vector>
+#include "turtlelib/rigid2d.hpp"
+
+namespace turtlelib
+{
+
+    /// \brief the first bytes of every pose log file
+    struct PoseLogHeader
+    {
+        /// \brief identifies the file type, always "TLPOSLOG" (not null-terminated)
+        char magic[8];
+
+        /// \brief the format version
+        std::uint32_t version;
+
+        /// \brief size of this header in bytes; records start at this offset
+        std::uint32_t header_size;
+
+        /// \brief size of one record in bytes
+        std::uint32_t record_size;
+
+        /// \brief 0x01020304 as written by the machine that created the file, to detect byte order
+        std::uint32_t byte_order;
+
+        /// \brief zero, reserved for later versions
+        std::uint64_t reserved;
+    };
+
+    /// \brief one timestamped pose and twist (e.g. odometry at one instant)
+    /// The pose is kept as angle and translation, so scans over positions need no trig.
+    struct PoseRecord
+    {
+        /// \brief the time of the record, in nanoseconds (e.g. since the epoch or since start)
+        std::int64_t stamp_ns;
+
+        /// \brief the heading, in radians
+        double theta;
+
+        /// \brief the x position
+        double x;
+
+        /// \brief the y position
+        double y;
+
+        /// \brief the angular velocity
+        double thetadot;
+
+        /// \brief the linear velocity along x
+        double xdot;
+
+        /// \brief the linear velocity along y
+        double ydot;
+
+        /// \brief the pose as a transform
+        /// \return the transform from the log's frame to the robot
+        Transform2D pose() const
+        {
+            return Transform2D({x, y}, theta);
+        }
+
+        /// \brief the twist
+        /// \return the twist [thetadot xdot ydot]
+        Twist2D twist() const
+        {
+            return Twist2D{{thetadot, xdot, ydot}};
+        }
+    };
+
+    /// \brief make a record from a pose and twist
+    /// \param stamp_ns - the time, in nanoseconds
+    /// \param pose - the pose
+    /// \param twist - the twist
+    /// \return the record
+    inline PoseRecord make_record(std::int64_t stamp_ns, const Transform2D & pose, const Twist2D & twist = Twist2D{})
+    {
+        return {stamp_ns, pose.rotation(), pose.translation().x, pose.translation().y,
+                twist.thetadot(), twist.xdot(), twist.ydot()};
+    }
+
+    /// \brief the current format version
+    constexpr std::uint32_t pose_log_version = 1;
+
+    static_assert(sizeof(PoseLogHeader) == 32, "PoseLogHeader is part of the file format");
+    static_assert(sizeof(PoseRecord) == 56, "PoseRecord is part of the file format");
+    static_assert(std::is_trivially_copyable<PoseRecord>::value, "PoseRecord must be trivially copyable");
+
+    /// \brief appends records to a pose log, buffering them into large writes
+    class PoseLogWriter
+    {
+    public:
+        /// \brief create a writer with no file open
+        /// \param buffer_records - number of records buffered between writes
+        explicit PoseLogWriter(std::size_t buffer_records = 4096);
+
+        /// \brief flushes and closes the file; records that cannot be written are lost
+        ~PoseLogWriter();
+
+        PoseLogWriter(const PoseLogWriter &) = delete;
+        PoseLogWriter & operator=(const PoseLogWriter &) = delete;
+
+        /// \brief open a log for appending, creating it (with a header) if it is empty or missing
+        /// Appending to an existing log requires a matching header; a trailing partial record is cut off.
+        /// An open file is closed first; if its records cannot be written it stays open.
+        /// Records still buffered are written to the new file.
+        /// \param path - the file
+        /// \return std::errc{} on success, std::errc::invalid_argument if the file is not a
+        ///         compatible pose log, the error of close(), or the error from the system call that failed
+        std::errc open(const char * path);
+
+        /// \brief add one record
+        /// Once the buffer is full every append flushes it, so after a failed flush each append retries.
+        /// \param record - the record
+        /// \return std::errc{} on success, or the error of the write when the buffer was flushed
+        std::errc append(const PoseRecord & record)
+        {
+            buffer.push_back(record);
+            if(buffer.size() >= capacity){
+                return flush();
+            }
+            return std::errc{};
+        }
+
+        /// \brief add an array of records
+        /// \param records - n records
+        /// \param n - number of records
+        /// \return std::errc{} on success, or the error of the write; records that were not
+        ///         written are kept buffered
+        std::errc append(const PoseRecord * records, std::size_t n);
+
+        /// \brief write the buffered records to the file
+        /// On failure the records that were not written stay buffered, for a later flush to retry;
+        /// a partially written record is cut off the file.
+        /// \return std::errc{} on success, or the error of the write
+        std::errc flush();
+
+        /// \brief flush and close the file
+        /// If the flush fails the file stays open and the records stay buffered.
+        /// \return std::errc{} on success, the error of the final write, or
+        ///         std::errc::bad_file_descriptor if records are buffered and no file is open
+        std::errc close();
+
+        /// \brief whether a file is open
+        bool is_open() const
+        {
+            return fd >= 0;
+        }
+
+    private:
+        /// \brief write all of [data, data + size) to the file
+        /// \param written - set to the number of bytes written, also on failure
+        std::errc write_all(const void * data, std::size_t size, std::size_t & written);
+
+        /// \brief write n records, cutting a partially written one off the file on failure
+        /// \param written - set to the number of whole records written
+        std::errc write_records(const PoseRecord * records, std::size_t n, std::size_t & written);
+
+        /// \brief close the file descriptor without flushing
+        std::errc close_fd();
+
+        /// \brief the file descriptor, -1 when closed
+        int fd = -1;
+
+        /// \brief records buffered between writes
+        std::size_t capacity;
+
+        /// \brief records not yet written
+        std::vector<PoseRecord> buffer;
+    };
+
+    /// \brief a read-only view of a pose log, memory-mapped so the records are read in place
+    /// The records are a contiguous array: data()/size() or begin()/end() give them without copying.
+    /// The view is valid until the reader is closed, destroyed or moved from.
+    class PoseLogReader
+    {
+    public:
+        /// \brief create a reader with no file open
+        PoseLogReader() = default;
+
+        /// \brief unmaps the file
+        ~PoseLogReader();
+
+        PoseLogReader(const PoseLogReader &) = delete;
+        PoseLogReader & operator=(const PoseLogReader &) = delete;
+
+        /// \brief take over another reader's mapping
+        PoseLogReader(PoseLogReader && other) noexcept;
+
+        /// \brief take over another reader's mapping
+        PoseLogReader & operator=(PoseLogReader && other) noexcept;
+
+        /// \brief map a log file
+        /// \param path - the file
+        /// \return std::errc{} on success, std::errc::invalid_argument if the file is not a pose log,
+        ///         std::errc::not_supported for another version or byte order, or the error from
+        ///         the system call that failed
+        std::errc open(const char * path);
+
+        /// \brief unmap the file
+        void close();
+
+        /// \brief the file header
+        /// \return the header; only valid while a file is open
+        const PoseLogHeader & header() const
+        {
+            return *static_cast<const PoseLogHeader *>(map);
+        }
+
+        /// \brief the records
+        const PoseRecord * data() const
+        {
+            return records;
+        }
+
+        /// \brief the number of whole records in the file
+        std::size_t size() const
+        {
+            return count;
+        }
+
+        /// \brief the first record
+        const PoseRecord * begin() const
+        {
+            return records;
+        }
+
+        /// \brief one past the last record
+        const PoseRecord * end() const
+        {
+            return records + count;
+        }
+
+        /// \brief record access
+        /// \param i - index of the record, less than size()
+        const PoseRecord & operator[](std::size_t i) const
+        {
+            return records[i];
+        }
+
+    private:
+        /// \brief the mapping, nullptr when closed
+        void * map = nullptr;
+
+        /// \brief size of the mapping in bytes
+        std::size_t map_size = 0;
+
+        /// \brief the first record, inside the mapping
+        const PoseRecord * records = nullptr;
+
+        /// \brief the number of whole records
+        std::size_t count = 0;
+    };
+
+}
+
+#endif
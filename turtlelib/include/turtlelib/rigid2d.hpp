@@ -6,7 +6,10 @@
 
 #include<iosfwd> // contains forward definitions for iostream objects
 #include<cmath>  // import for math helper commands
-#include<vector>
+#include<array>
+#include<cstddef>
+#include<limits>
+#include<type_traits>
 
 namespace turtlelib
 {
@@ -71,26 +74,384 @@ namespace turtlelib
     static_assert(almost_equal(deg2rad(rad2deg(2.1)), 2.1), "deg2rad failed");
     static_assert(almost_equal(deg2rad(rad2deg(7.8)), 7.8), "deg2rad failed");
 
+    /// \brief wrap an angle into (-PI, PI] in constant time, without branches or loops
+    /// The nearest multiple k of 2pi is found by rounding x/(2pi) with the 1.5*2^52 trick, and
+    /// subtracted in three parts (Cody-Waite), so that the result is accurate to an ulp or two of
+    /// the result for |rad| < 5e7, and to an ulp or two of rad beyond. A final select maps -PI and
+    /// anything that rounded just outside the interval back into it.
+    /// Meaningful for |rad| < 1e15, where consecutive doubles are less than 0.125 rad apart;
+    /// NaN and infinities give NaN. batch2d.hpp has the same function over arrays.
+    /// \param rad - any angle
+    /// \returns the equivalent angle in (-PI, PI]
+    constexpr double normalize_angle(double rad)
+    {
+        // 2pi in three parts: the first two have 30 significant bits, so k times them is exact for |k| < 2^23
+        constexpr double two_pi_1 = 6.283185303211212;
+        constexpr double two_pi_2 = 3.9683743166540886e-09;
+        constexpr double two_pi_3 = 2.068073192717642e-18;
+        constexpr double inv_two_pi = 0.15915494309189535;
+        constexpr double round_magic = 6755399441055744.0;
+
+        const double k = (rad*inv_two_pi + round_magic) - round_magic;
+        double r = ((rad - k*two_pi_1) - k*two_pi_2) - k*two_pi_3;
+        r = r <= -PI ? r + 2.0*PI : r;
+        r = r > PI ? r - 2.0*PI : r;
+        return r;
+    }
+
+    /// \brief wrap a single precision angle into (-PI, PI]
+    /// Computed in double precision and rounded to float, so angles just above -PI can come back
+    /// as -PI rounded to float (which is just below -PI).
+    /// \param rad - any angle
+    /// \returns the equivalent angle in (-PI, PI], to float precision
+    constexpr float normalize_angle(float rad)
+    {
+        return static_cast<float>(normalize_angle(static_cast<double>(rad)));
+    }
+
+    static_assert(normalize_angle(0.0) == 0.0, "normalize_angle failed");
+    static_assert(normalize_angle(PI) == PI, "normalize_angle failed");
+    static_assert(normalize_angle(-PI) == PI, "normalize_angle failed");
+    static_assert(almost_equal(normalize_angle(3*PI/2), -PI/2), "normalize_angle failed");
+    static_assert(almost_equal(normalize_angle(-7*PI/2), PI/2), "normalize_angle failed");
+    static_assert(almost_equal(normalize_angle(1000.0), 1000.0 - 159*2*PI, 1e-12), "normalize_angle failed");
+    static_assert(almost_equal(normalize_angle(static_cast<float>(3*PI/2)), -PI/2, 1e-6), "normalize_angle failed");
+
+    namespace detail
+    {
+        /// \brief true when called during constant evaluation, so constexpr code can avoid
+        /// non-constexpr <cmath> calls at compile time and still use them at runtime
+        constexpr bool is_constant_evaluated() noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_is_constant_evaluated();
+#else
+            return false;
+#endif
+        }
+
+        /// \brief sine and cosine of an angle, usable in constant expressions
+        /// Reduces the angle to [-pi/4, pi/4] about the nearest multiple of pi/2 and evaluates
+        /// the Taylor series there. Only used at compile time; runtime calls go to std::sin/std::cos.
+        /// \param radians - the angle
+        /// \param s [out] - sine of the angle
+        /// \param c [out] - cosine of the angle
+        constexpr void constexpr_sincos(double radians, double & s, double & c)
+        {
+            // pi/2 split in two parts so that k*pi/2 is subtracted without losing precision
+            constexpr double half_pi_hi = 1.57079632679489655800e+00;
+            constexpr double half_pi_lo = 6.12323399573676603587e-17;
+
+            const double q = radians/(PI/2);
+            const long long k = static_cast<long long>(q < 0.0 ? q - 0.5 : q + 0.5);
+            const double r = (radians - k*half_pi_hi) - k*half_pi_lo;
+            const double r2 = r*r;
+
+            double sr = 0.0;
+            double cr = 0.0;
+            double term_s = r;
+            double term_c = 1.0;
+            for(int n = 1; n <= 22; n += 2){
+                sr += term_s;
+                cr += term_c;
+                term_s *= -r2/((n + 1)*(n + 2));
+                term_c *= -r2/(n*(n + 1));
+            }
+
+            switch(((k % 4) + 4) % 4){
+                case 0: s = sr;  c = cr;  break;
+                case 1: s = cr;  c = -sr; break;
+                case 2: s = -sr; c = -cr; break;
+                default: s = -cr; c = sr; break;
+            }
+        }
+
+        /// \brief sine of an angle, usable in constant expressions
+        /// \tparam T - the scalar type; types other than float/double use sin() found by argument-dependent lookup
+        template<class T>
+        constexpr T sin(T radians)
+        {
+            if constexpr(std::is_floating_point<T>::value){
+                if(is_constant_evaluated()){
+                    double s = 0.0;
+                    double c = 0.0;
+                    constexpr_sincos(static_cast<double>(radians), s, c);
+                    return static_cast<T>(s);
+                }
+                return std::sin(radians);
+            } else {
+                using std::sin;
+                return sin(radians);
+            }
+        }
+
+        /// \brief cosine of an angle, usable in constant expressions
+        /// \tparam T - the scalar type; types other than float/double use cos() found by argument-dependent lookup
+        template<class T>
+        constexpr T cos(T radians)
+        {
+            if constexpr(std::is_floating_point<T>::value){
+                if(is_constant_evaluated()){
+                    double s = 0.0;
+                    double c = 0.0;
+                    constexpr_sincos(static_cast<double>(radians), s, c);
+                    return static_cast<T>(c);
+                }
+                return std::cos(radians);
+            } else {
+                using std::cos;
+                return cos(radians);
+            }
+        }
+
+        /// \brief square root, usable in constant expressions
+        /// At compile time Newton's method is run from above until it stops decreasing, which
+        /// gives the correctly rounded root or one ulp above it. Runtime calls go to std::sqrt.
+        /// \tparam T - the scalar type; types other than float/double use sqrt() found by argument-dependent lookup
+        template<class T>
+        constexpr T sqrt(T value)
+        {
+            if constexpr(std::is_floating_point<T>::value){
+                if(is_constant_evaluated()){
+                    if(!(value > T(0))){
+                        return value == T(0) ? value : std::numeric_limits<T>::quiet_NaN();
+                    }
+                    if(!(value < std::numeric_limits<T>::infinity())){
+                        return value;
+                    }
+                    T root = value > T(1) ? value : T(1);
+                    for(;;){
+                        const T next = (root + value/root)/T(2);
+                        if(!(next < root)){
+                            return root;
+                        }
+                        root = next;
+                    }
+                }
+                return std::sqrt(value);
+            } else {
+                using std::sqrt;
+                return sqrt(value);
+            }
+        }
+
+        /// \brief T, in a context where it is not deduced, so e.g. a double literal can be passed for a float
+        template<class T>
+        struct identity
+        {
+            /// \brief the type itself
+            using type = T;
+        };
+
+        /// \brief shorthand for identity<T>::type
+        template<class T>
+        using identity_t = typename identity<T>::type;
+
+        static_assert(almost_equal(sin(0.0), 0.0), "sin failed");
+        static_assert(almost_equal(cos(0.0), 1.0), "cos failed");
+        static_assert(almost_equal(sin(PI/6), 0.5), "sin failed");
+        static_assert(almost_equal(cos(PI/3), 0.5), "cos failed");
+        static_assert(almost_equal(sin(-3*PI/2), 1.0), "sin failed");
+        static_assert(almost_equal(cos(PI), -1.0), "cos failed");
+        static_assert(almost_equal(sin(100.0), -0.50636564110975879), "sin failed");
+        static_assert(sqrt(4.0) == 2.0, "sqrt failed");
+        static_assert(almost_equal(sqrt(2.0), 1.4142135623730951), "sqrt failed");
+        static_assert(almost_equal(sqrt(1e-6), 1e-3), "sqrt failed");
+
+        /// \brief wrap an angle into (-PI, PI]
+        /// normalize_angle() for float and double, at compile time and at runtime; other scalar
+        /// types (e.g. automatic differentiation types) step by 2pi.
+        /// \param radians - any angle
+        /// \return the equivalent angle in (-PI, PI]
+        template<class T>
+        constexpr T wrap_angle(T radians)
+        {
+            if constexpr(std::is_floating_point<T>::value){
+                return normalize_angle(radians);
+            } else {
+                while(radians > T(PI)){
+                    radians -= T(2*PI);
+                }
+                while(radians <= T(-PI)){
+                    radians += T(2*PI);
+                }
+                return radians;
+            }
+        }
+
+        static_assert(almost_equal(wrap_angle(3*PI/2), -PI/2), "wrap_angle failed");
+        static_assert(almost_equal(wrap_angle(-PI), PI), "wrap_angle failed");
+        static_assert(almost_equal(wrap_angle(PI), PI), "wrap_angle failed");
+    }
+
     /// \brief A 2-Dimensional Vector
-    struct Vector2D
+    /// \tparam T - the scalar type (double for Vector2D)
+    template<class T>
+    struct BasicVector2D
     {
+        /// \brief the scalar type
+        using scalar_type = T;
+
         /// \brief the x coordinate
-        double x = 0.0;
+        T x = T(0);
 
         /// \brief the y coordinate   
-        double y = 0.0;
+        T y = T(0);
+
+        /// \brief add a vector to this one
+        /// \param rhs - the vector to add
+        /// \return a reference to this vector
+        constexpr BasicVector2D & operator+=(const BasicVector2D & rhs)
+        {
+            x += rhs.x;
+            y += rhs.y;
+            return *this;
+        }
+
+        /// \brief subtract a vector from this one
+        /// \param rhs - the vector to subtract
+        /// \return a reference to this vector
+        constexpr BasicVector2D & operator-=(const BasicVector2D & rhs)
+        {
+            x -= rhs.x;
+            y -= rhs.y;
+            return *this;
+        }
+
+        /// \brief scale this vector
+        /// \param k - the scale factor
+        /// \return a reference to this vector
+        constexpr BasicVector2D & operator*=(T k)
+        {
+            x *= k;
+            y *= k;
+            return *this;
+        }
 
         /// \brief normalize the Vector2D object
+        /// One square root and one division; the zero vector gives NaN components.
         /// \return a new Vector2D object that is normalized
-        Vector2D normalize();
+        constexpr BasicVector2D normalize() const
+        {
+            const T inv = T(1)/detail::sqrt(x*x + y*y);
+            return {x*inv, y*inv};
+        }
     };
 
+    /// \brief a 2-Dimensional Vector of doubles
+    using Vector2D = BasicVector2D<double>;
+
+    /// \brief a 2-Dimensional Vector of floats
+    using Vector2Df = BasicVector2D<float>;
+
+
+
+    /// \brief add two vectors
+    /// \param lhs - the left hand operand
+    /// \param rhs - the right hand operand
+    /// \return the component-wise sum
+    template<class T>
+    constexpr BasicVector2D<T> operator+(BasicVector2D<T> lhs, const BasicVector2D<T> & rhs)
+    {
+        return lhs+=rhs;
+    }
+
+    /// \brief subtract two vectors
+    /// \param lhs - the left hand operand
+    /// \param rhs - the right hand operand
+    /// \return the component-wise difference
+    template<class T>
+    constexpr BasicVector2D<T> operator-(BasicVector2D<T> lhs, const BasicVector2D<T> & rhs)
+    {
+        return lhs-=rhs;
+    }
+
+    /// \brief negate a vector
+    /// \param v - the vector to negate
+    /// \return the vector pointing the other way
+    template<class T>
+    constexpr BasicVector2D<T> operator-(BasicVector2D<T> v)
+    {
+        return v*=T(-1);
+    }
+
+    /// \brief scale a vector
+    /// \param v - the vector
+    /// \param k - the scale factor
+    /// \return the scaled vector
+    template<class T>
+    constexpr BasicVector2D<T> operator*(BasicVector2D<T> v, detail::identity_t<T> k)
+    {
+        return v*=k;
+    }
+
+    /// \brief scale a vector
+    /// \param k - the scale factor
+    /// \param v - the vector
+    /// \return the scaled vector
+    template<class T>
+    constexpr BasicVector2D<T> operator*(detail::identity_t<T> k, BasicVector2D<T> v)
+    {
+        return v*=k;
+    }
+
+    /// \brief dot product
+    /// \param a - a vector
+    /// \param b - a vector
+    /// \return a.x*b.x + a.y*b.y
+    template<class T>
+    constexpr T dot(const BasicVector2D<T> & a, const BasicVector2D<T> & b)
+    {
+        return a.x*b.x + a.y*b.y;
+    }
+
+    /// \brief the z component of the 3D cross product of a and b
+    /// \param a - a vector
+    /// \param b - a vector
+    /// \return a.x*b.y - a.y*b.x, positive when b is counterclockwise of a
+    template<class T>
+    constexpr T cross(const BasicVector2D<T> & a, const BasicVector2D<T> & b)
+    {
+        return a.x*b.y - a.y*b.x;
+    }
 
+    /// \brief length of a vector
+    /// Computed as sqrt(x*x + y*y), without the overflow protection of std::hypot.
+    /// \param v - the vector
+    /// \return the Euclidean norm of v
+    template<class T>
+    constexpr T magnitude(const BasicVector2D<T> & v)
+    {
+        return detail::sqrt(dot(v, v));
+    }
+
+    /// \brief the signed angle from a to b
+    /// \param a - a vector
+    /// \param b - a vector
+    /// \return the angle in [-PI, PI], positive when b is counterclockwise of a; 0 or +-PI if either is zero
+    template<class T>
+    T angle(const BasicVector2D<T> & a, const BasicVector2D<T> & b)
+    {
+        using std::atan2;
+        return atan2(cross(a, b), dot(a, b));
+    }
+
+    static_assert(almost_equal((Vector2D{1.0, -2.0} + 2.0*Vector2D{-3.0, 0.5}).x, -5.0), "vector arithmetic failed");
+    static_assert(almost_equal((Vector2D{1.0, -2.0} - -Vector2D{-3.0, 0.5}).y, -1.5), "vector arithmetic failed");
+    static_assert(almost_equal(dot(Vector2D{1.0, -2.0}, Vector2D{-3.0, 0.5}), -4.0), "dot failed");
+    static_assert(almost_equal(cross(Vector2D{1.0, 0.0}, Vector2D{0.0, 1.0}), 1.0), "cross failed");
+    static_assert(almost_equal(magnitude(Vector2D{-3.0, 4.0}), 5.0), "magnitude failed");
+    static_assert(almost_equal(Vector2D{-3.0, -4.0}.normalize().x, -0.6), "normalize failed");
 
     /// \brief output a 2 dimensional vector as [xcomponent ycomponent]
     /// os - stream to output to
     /// v - the vector to print
-    std::ostream & operator<<(std::ostream & os, const Vector2D & v);
+    /// Built on format() in text_io.hpp: with the default stream flags numbers are written in the
+    /// shortest form that reads back exactly. A fixed, scientific or hexfloat floatfield or a
+    /// precision other than 6 (capped at 17) applies to each number; the width pads the whole text.
+    /// Instantiated for float and double.
+    template<class T>
+    std::ostream & operator<<(std::ostream & os, const BasicVector2D<T> & v);
 
     /// \brief input a 2 dimensional vector
     ///   You should be able to read vectors entered as follows:
@@ -110,115 +471,651 @@ namespace turtlelib
     /// We have lower level control however. For example:
     /// peek looks at the next unprocessed character in the buffer without removing it
     /// get removes the next unprocessed character from the buffer.
-    std::istream & operator>>(std::istream & is, Vector2D & v);
+    /// Built on the parsers in text_io.hpp: malformed input sets failbit and leaves v unchanged.
+    /// Instantiated for float and double.
+    template<class T>
+    std::istream & operator>>(std::istream & is, BasicVector2D<T> & v);
 
 
 
     /// \brief 3 position twist vector: [theta_dot x_dot y_dot]
-    struct Twist2D 
+    /// Fixed-size and trivially copyable, so twists can be stored in contiguous arrays and copied with memcpy.
+    /// \tparam T - the scalar type (double for Twist2D)
+    template<class T>
+    struct BasicTwist2D 
     {   //source(11/12): https://stackoverflow.com/questions/2133250/x-does-not-name-a-type-error-in-c/2133260
-        std::vector<double> tw = {0,0,0};
+        /// \brief the scalar type
+        using scalar_type = T;
+
+        /// \brief the components, in the order [theta_dot x_dot y_dot]
+        std::array<T, 3> tw = {T(0), T(0), T(0)};
+
+        /// \brief the angular velocity
+        constexpr T & thetadot() { return tw[0]; }
+
+        /// \brief the angular velocity
+        constexpr T thetadot() const { return tw[0]; }
+
+        /// \brief the linear velocity along x
+        constexpr T & xdot() { return tw[1]; }
+
+        /// \brief the linear velocity along x
+        constexpr T xdot() const { return tw[1]; }
+
+        /// \brief the linear velocity along y
+        constexpr T & ydot() { return tw[2]; }
+
+        /// \brief the linear velocity along y
+        constexpr T ydot() const { return tw[2]; }
+
+        /// \brief component access, same as tw[i]
+        /// \param i - 0 for theta_dot, 1 for x_dot, 2 for y_dot
+        constexpr T & operator[](std::size_t i) { return tw[i]; }
+
+        /// \brief component access, same as tw[i]
+        /// \param i - 0 for theta_dot, 1 for x_dot, 2 for y_dot
+        constexpr T operator[](std::size_t i) const { return tw[i]; }
+
+        /// \brief add a twist to this one, component-wise
+        /// \param rhs - the twist to add
+        /// \return a reference to this twist
+        constexpr BasicTwist2D & operator+=(const BasicTwist2D & rhs)
+        {
+            tw[0] += rhs.tw[0];
+            tw[1] += rhs.tw[1];
+            tw[2] += rhs.tw[2];
+            return *this;
+        }
+
+        /// \brief subtract a twist from this one, component-wise
+        /// \param rhs - the twist to subtract
+        /// \return a reference to this twist
+        constexpr BasicTwist2D & operator-=(const BasicTwist2D & rhs)
+        {
+            tw[0] -= rhs.tw[0];
+            tw[1] -= rhs.tw[1];
+            tw[2] -= rhs.tw[2];
+            return *this;
+        }
+
+        /// \brief scale this twist
+        /// \param k - the scale factor
+        /// \return a reference to this twist
+        constexpr BasicTwist2D & operator*=(T k)
+        {
+            tw[0] *= k;
+            tw[1] *= k;
+            tw[2] *= k;
+            return *this;
+        }
     };
 
+    /// \brief a twist of doubles
+    using Twist2D = BasicTwist2D<double>;
+
+    /// \brief a twist of floats
+    using Twist2Df = BasicTwist2D<float>;
+
+    static_assert(std::is_trivially_copyable<Twist2D>::value, "Twist2D must be trivially copyable");
+    static_assert(sizeof(Twist2D) == 3*sizeof(double), "Twist2D must be three packed doubles");
+    static_assert(sizeof(Twist2Df) == 3*sizeof(float), "Twist2Df must be three packed floats");
+
+    /// \brief add two twists
+    /// \param lhs - the left hand operand
+    /// \param rhs - the right hand operand
+    /// \return the component-wise sum
+    template<class T>
+    constexpr BasicTwist2D<T> operator+(BasicTwist2D<T> lhs, const BasicTwist2D<T> & rhs)
+    {
+        return lhs+=rhs;
+    }
+
+    /// \brief subtract two twists
+    /// \param lhs - the left hand operand
+    /// \param rhs - the right hand operand
+    /// \return the component-wise difference
+    template<class T>
+    constexpr BasicTwist2D<T> operator-(BasicTwist2D<T> lhs, const BasicTwist2D<T> & rhs)
+    {
+        return lhs-=rhs;
+    }
+
+    /// \brief negate a twist
+    /// \param twist - the twist to negate
+    /// \return the twist with every component negated
+    template<class T>
+    constexpr BasicTwist2D<T> operator-(BasicTwist2D<T> twist)
+    {
+        return twist*=T(-1);
+    }
+
+    /// \brief scale a twist
+    /// \param twist - the twist
+    /// \param k - the scale factor
+    /// \return the scaled twist
+    template<class T>
+    constexpr BasicTwist2D<T> operator*(BasicTwist2D<T> twist, detail::identity_t<T> k)
+    {
+        return twist*=k;
+    }
+
+    /// \brief scale a twist
+    /// \param k - the scale factor
+    /// \param twist - the twist
+    /// \return the scaled twist
+    template<class T>
+    constexpr BasicTwist2D<T> operator*(detail::identity_t<T> k, BasicTwist2D<T> twist)
+    {
+        return twist*=k;
+    }
+
+    static_assert(almost_equal((Twist2D{{1.0, 2.0, 3.0}} + Twist2D{{1.0, 1.0, 1.0}}*2.0).ydot(), 5.0), "twist arithmetic failed");
+
     /// \brief output a 2 dimensional twist vector as [theta_dot x_dot y_dot]   
     /// os - stream to output to
     /// t - the vector to print
-    std::ostream & operator<<(std::ostream & os, const Twist2D & twist);
+    /// Built on format() in text_io.hpp: with the default stream flags numbers are written in the
+    /// shortest form that reads back exactly. A fixed, scientific or hexfloat floatfield or a
+    /// precision other than 6 (capped at 17) applies to each number; the width pads the whole text.
+    /// Instantiated for float and double.
+    template<class T>
+    std::ostream & operator<<(std::ostream & os, const BasicTwist2D<T> & twist);
     
     
-    /// \brief input a 2 dimensional vector as theta_dot x_dot y_dot
-    std::istream & operator>>(std::istream & is, Twist2D & t);
+    /// \brief input a 2 dimensional vector as theta_dot x_dot y_dot, or as output by operator<<
+    /// Built on the parsers in text_io.hpp: malformed input sets failbit and leaves t unchanged.
+    /// Instantiated for float and double.
+    template<class T>
+    std::istream & operator>>(std::istream & is, BasicTwist2D<T> & t);
 
 
     /// \brief a rigid body transformation in 2 dimensions
-    class Transform2D
+    /// Everything except the stream operators is constexpr, so transforms
+    /// between fixed frames (e.g., sensor mounts) can be composed at compile time.
+    /// The rotation angle is kept alongside its cosine and sine, so rotation() and the
+    /// adjoint never call a transcendental function.
+    /// \tparam T - the scalar type (double for Transform2D). Besides float and double, any type
+    /// with the arithmetic and comparison operators and sin/cos found by argument-dependent lookup works,
+    /// e.g., dual numbers for automatic differentiation.
+    template<class T>
+    class BasicTransform2D
     {
 
     public:
+        /// \brief the scalar type
+        using scalar_type = T;
+
         /// \brief Create an identity transformation
-        Transform2D();
+        constexpr BasicTransform2D()
+            : th(T(0)), cos_th(T(1)), sin_th(T(0)), x(T(0)), y(T(0))
+        {
+        }
 
         /// \brief create a transformation that is a pure translation
         /// \param trans - the vector by which to translate
-        explicit Transform2D(Vector2D trans);
+        constexpr explicit BasicTransform2D(BasicVector2D<T> trans)
+            : th(T(0)), cos_th(T(1)), sin_th(T(0)), x(trans.x), y(trans.y)
+        {
+        }
 
         /// \brief create a pure rotation
         /// \param radians - angle of the rotation, in radians
-        explicit Transform2D(double radians);
+        constexpr explicit BasicTransform2D(T radians)
+            : th(detail::wrap_angle(radians)), cos_th(detail::cos(radians)), sin_th(detail::sin(radians)), x(T(0)), y(T(0))
+        {
+        }
 
         /// \brief Create a transformation with a translational and rotational
         /// component
         /// \param trans - the translation
         /// \param radians - the rotation, in radians
-        Transform2D(Vector2D trans, double radians);
+        constexpr BasicTransform2D(BasicVector2D<T> trans, T radians)
+            : th(detail::wrap_angle(radians)), cos_th(detail::cos(radians)), sin_th(detail::sin(radians)), x(trans.x), y(trans.y)
+        {
+        }
+
+        /// \brief create a transformation from the cosine and sine of its rotation,
+        /// for callers that already have them and want to skip the trig calls
+        /// \param trans - the translation
+        /// \param cos_theta - cosine of the rotation
+        /// \param sin_theta - sine of the rotation; cos_theta^2 + sin_theta^2 must be 1
+        /// \param radians - the rotation itself
+        /// \return the transformation
+        static constexpr BasicTransform2D from_cos_sin(BasicVector2D<T> trans, T cos_theta, T sin_theta, T radians)
+        {
+            BasicTransform2D tf(trans);
+            tf.th = detail::wrap_angle(radians);
+            tf.cos_th = cos_theta;
+            tf.sin_th = sin_theta;
+            return tf;
+        }
+
+        /// \brief create a transformation from the cosine and sine of its rotation;
+        /// the angle is recovered with one atan2
+        /// \param trans - the translation
+        /// \param cos_theta - cosine of the rotation
+        /// \param sin_theta - sine of the rotation; cos_theta^2 + sin_theta^2 must be 1
+        /// \return the transformation
+        static BasicTransform2D from_cos_sin(BasicVector2D<T> trans, T cos_theta, T sin_theta)
+        {
+            using std::atan2;
+
+            return from_cos_sin(trans, cos_theta, sin_theta, atan2(sin_theta, cos_theta));
+        }
 
         /// \brief apply a transformation to a Vector2D
         /// \param v - the vector to transform
         /// \return a vector in the new coordinate system
-        Vector2D operator()(Vector2D v) const;
+        constexpr BasicVector2D<T> operator()(BasicVector2D<T> v) const
+        {
+            //code in this method adapted from this source(11/10): http://msl.cs.uiuc.edu/~lavalle/cs497_2001/book/geom/node9.html
+            return {v.x*cos_th - v.y*sin_th + x, v.x*sin_th + v.y*cos_th + y};
+        }
 
 
         /// \brief invert the transformation
         /// \return the inverse transformation. 
-        Transform2D inv() const;
+        constexpr BasicTransform2D inv() const
+        {
+            // The inverse of the homogeneous transform, referenced here: https://nu-msr.github.io/navigation_site/lectures/rigid2d.html
+            // [R p]^-1 = [R^T  -R^T p]
+            BasicTransform2D t_inv;
+            // -PI is outside (-PI, PI], so a half turn is its own inverse, sine included
+            t_inv.th = th < T(PI) ? -th : th;
+            t_inv.cos_th = cos_th;
+            t_inv.sin_th = th < T(PI) ? -sin_th : sin_th;
+            t_inv.x = -(cos_th*x + sin_th*y);
+            t_inv.y = -(cos_th*y - sin_th*x);
+            return t_inv;
+        }
 
         /// \brief transform twist
         /// \return a twist in the new frame. 
-        Twist2D operator()(Twist2D twist) const;
+        constexpr BasicTwist2D<T> operator()(BasicTwist2D<T> twist) const
+        {
+            //Apply the adjoint [1 0 0; y R; -x R] directly from the stored cos/sin
+            BasicTwist2D<T> t_new;
+            t_new.tw[0] = twist.tw[0];
+            t_new.tw[1] = y*twist.tw[0] + twist.tw[1]*cos_th - sin_th*twist.tw[2];
+            t_new.tw[2] = -x*twist.tw[0] + twist.tw[1]*sin_th + twist.tw[2]*cos_th;
+            return t_new;
+        }
 
         /// \brief compose this transform with another and store the result 
         /// in this object
         /// \param rhs - the first transform to apply
         /// \return a reference to the newly transformed operator
-        Transform2D & operator*=(const Transform2D & rhs);
+        constexpr BasicTransform2D & operator*=(const BasicTransform2D & rhs)
+        {
+            // [R1 p1][R2 p2] = [R1*R2  R1*p2 + p1]
+            // Only the 2x3 block is computed, the bottom row of both operands is [0 0 1]
+            // The angles add; both are in (-PI, PI], so one correction wraps the sum
+            T th_new = th + rhs.th;
+            if(th_new > T(PI)){
+                th_new -= T(2*PI);
+            } else if(th_new <= T(-PI)){
+                th_new += T(2*PI);
+            }
+            // Multiply and add only: the cosine and sine are rounded on every composition, so over long
+            // chains they drift off the unit circle and away from the angle; PoseAccumulator bounds that
+            const T c = cos_th*rhs.cos_th - sin_th*rhs.sin_th;
+            const T s = sin_th*rhs.cos_th + cos_th*rhs.sin_th;
+            const T x_new = cos_th*rhs.x - sin_th*rhs.y + x;
+            const T y_new = sin_th*rhs.x + cos_th*rhs.y + y;
+
+            th = th_new;
+            cos_th = c;
+            sin_th = s;
+            x = x_new;
+            y = y_new;
+
+            return *this;
+        }
 
         /// \brief the translational component of the transform
         /// \return the x,y translation
-        Vector2D translation() const;
+        constexpr BasicVector2D<T> translation() const
+        {
+            return {x, y};
+        }
 
         /// \brief get the angular displacement of the transform
-        /// \return the angular displacement, in radians
-        double rotation() const;
+        /// \return the angular displacement, in radians, in (-PI, PI]
+        constexpr T rotation() const
+        {
+            //Returns an angle in radians
+            return th;
+        }
+
+        /// \brief cosine of the angular displacement, without calling atan2/cos
+        /// \return cos(rotation())
+        constexpr T rotation_cos() const
+        {
+            return cos_th;
+        }
 
-        /// \brief \see operator<<(...) (declared outside this class)
-        /// for a description
-        friend std::ostream & operator<<(std::ostream & os, const Transform2D & tf);
+        /// \brief sine of the angular displacement, without calling atan2/sin
+        /// \return sin(rotation())
+        constexpr T rotation_sin() const
+        {
+            return sin_th;
+        }
 
     private:
-        // source (11/10): https://www.geeksforgeeks.org/2d-vector-in-cpp-with-user-defined-size/      
-        std::vector<std::vector<double>> t;
+        // The transform is stored as the 2x3 block [R p] of the homogeneous matrix,
+        // with R kept as its cosine and sine. The bottom row is always [0 0 1] so it is not stored.
+        // This keeps the class fixed-size and trivially copyable: no heap allocation on
+        // construction, copy, composition or inversion.
+
+        /// \brief the rotation angle, in (-PI, PI]
+        T th;
+
+        /// \brief cosine of the rotation angle
+        T cos_th;
+
+        /// \brief sine of the rotation angle
+        T sin_th;
+
+        /// \brief x component of the translation
+        T x;
+
+        /// \brief y component of the translation
+        T y;
 
     };
 
+    /// \brief a rigid body transformation in 2 dimensions, in doubles
+    using Transform2D = BasicTransform2D<double>;
+
+    /// \brief a rigid body transformation in 2 dimensions, in floats
+    using Transform2Df = BasicTransform2D<float>;
+
+    static_assert(std::is_trivially_copyable<Transform2D>::value, "Transform2D must be trivially copyable");
+    static_assert(std::is_trivially_copyable<Transform2Df>::value, "Transform2Df must be trivially copyable");
+
     /// \brief should print a human readable version of the transform:
     /// An example output:
     /// deg: 90 x: 3 y: 5
     /// \param os - an output stream
     /// \param tf - the transform to print
-    std::ostream & operator<<(std::ostream & os, const Transform2D & tf);
+    /// Built on format() in text_io.hpp: with the default stream flags numbers are written in the
+    /// shortest form that reads back exactly. A fixed, scientific or hexfloat floatfield or a
+    /// precision other than 6 (capped at 17) applies to each number; the width pads the whole text.
+    /// Instantiated for float and double.
+    template<class T>
+    std::ostream & operator<<(std::ostream & os, const BasicTransform2D<T> & tf);
 
     
 
     /// \brief Read a transformation from stdin
     /// Should be able to read input either as output by operator<< or
     /// as 3 numbers (degrees, dx, dy) separated by spaces or newlines
-    std::istream & operator>>(std::istream & is, Transform2D & tf);
+    /// Built on the parsers in text_io.hpp: malformed input sets failbit and leaves tf unchanged.
+    /// Instantiated for float and double.
+    template<class T>
+    std::istream & operator>>(std::istream & is, BasicTransform2D<T> & tf);
+
+    /// \brief a lazily evaluated composition of transforms, built with chain()
+    ///
+    /// A chain such as chain(t_ab, t_bc, t_cd) is not multiplied out as it is built. Applied to a
+    /// point or twist, the chain applies each factor right to left (t_ab(t_bc(t_cd(v)))),
+    /// which is cheaper than composing the transforms first. Converted or assigned to a
+    /// Transform2D, the chain is composed left to right in a single pass; call eval() once and
+    /// keep the result to read its translation or rotation.
+    /// The operands are held by value, so an expression never refers to a destroyed temporary.
+    /// \tparam L - the left operand: BasicTransform2D or another TransformProduct
+    /// \tparam R - the right operand: BasicTransform2D or another TransformProduct, with the same scalar type
+    template<class L, class R>
+    class TransformProduct
+    {
+    public:
+        /// \brief the scalar type
+        using scalar_type = typename L::scalar_type;
+
+        /// \brief the type the product evaluates to
+        using transform_type = BasicTransform2D<scalar_type>;
+
+        static_assert(std::is_same<scalar_type, typename R::scalar_type>::value, "operands must share a scalar type");
+
+        /// \brief create the product lhs*rhs
+        /// \param lhs - the left hand operand
+        /// \param rhs - the right hand operand
+        constexpr TransformProduct(const L & lhs, const R & rhs)
+            : lhs(lhs), rhs(rhs)
+        {
+        }
+
+        /// \brief apply the composed transformation to a Vector2D
+        /// \param v - the vector to transform
+        /// \return lhs(rhs(v))
+        constexpr BasicVector2D<scalar_type> operator()(BasicVector2D<scalar_type> v) const
+        {
+            return lhs(rhs(v));
+        }
+
+        /// \brief apply the composed transformation to a twist
+        /// \param twist - the twist to transform
+        /// \return lhs(rhs(twist))
+        constexpr BasicTwist2D<scalar_type> operator()(BasicTwist2D<scalar_type> twist) const
+        {
+            return lhs(rhs(twist));
+        }
+
+        /// \brief multiply the factors of this product onto a transform, left to right
+        /// \param acc - the transform to compose onto
+        constexpr void compose_into(transform_type & acc) const
+        {
+            compose_operand(lhs, acc);
+            compose_operand(rhs, acc);
+        }
+
+        /// \brief compose the chain into a single transform
+        /// \return the composition
+        constexpr transform_type eval() const
+        {
+            transform_type acc;
+            compose_into(acc);
+            return acc;
+        }
+
+        /// \brief the composition, so a product can be used wherever a Transform2D is expected
+        constexpr operator transform_type() const
+        {
+            return eval();
+        }
+
+    private:
+        static constexpr void compose_operand(const transform_type & operand, transform_type & acc)
+        {
+            acc*=operand;
+        }
+
+        template<class L2, class R2>
+        static constexpr void compose_operand(const TransformProduct<L2, R2> & operand, transform_type & acc)
+        {
+            operand.compose_into(acc);
+        }
+
+        /// \brief the left hand operand
+        L lhs;
+
+        /// \brief the right hand operand
+        R rhs;
+    };
+
+    /// \brief true for the types a chain composes: BasicTransform2D and TransformProduct
+    template<class T>
+    struct is_transform_expression : std::false_type {};
+
+    template<class T>
+    struct is_transform_expression<BasicTransform2D<T>> : std::true_type {};
+
+    template<class L, class R>
+    struct is_transform_expression<TransformProduct<L, R>> : std::true_type {};
+
+    /// \brief true for the TransformProduct types
+    template<class T>
+    struct is_transform_product : std::false_type {};
+
+    template<class L, class R>
+    struct is_transform_product<TransformProduct<L, R>> : std::true_type {};
 
     /// \brief multiply two transforms together, returning their composition
     /// \param lhs - the left hand operand
     /// \param rhs - the right hand operand
     /// \return the composition of the two transforms
-    /// HINT: This function should be implemented in terms of *=
-    Transform2D operator*(Transform2D lhs, const Transform2D & rhs);
+    template<class T>
+    constexpr BasicTransform2D<T> operator*(BasicTransform2D<T> lhs, const BasicTransform2D<T> & rhs)
+    {
+        //code within this method adapted from this source(11/11): https://en.cppreference.com/w/cpp/language/operators
+        lhs*=rhs;
+        return lhs;
+    }
 
+    /// \brief extend a chain (see TransformProduct) by another factor, still lazily
+    /// \param lhs - the left hand operand, a BasicTransform2D or TransformProduct
+    /// \param rhs - the right hand operand, a BasicTransform2D or TransformProduct; at least one is a TransformProduct
+    /// \return the longer chain
+    template<class L, class R,
+             class = std::enable_if_t<is_transform_expression<L>::value && is_transform_expression<R>::value
+                                      && (is_transform_product<L>::value || is_transform_product<R>::value)>>
+    constexpr TransformProduct<L, R> operator*(const L & lhs, const R & rhs)
+    {
+        return {lhs, rhs};
+    }
 
+    /// \brief a lazily evaluated composition of two or more transforms, \see TransformProduct
+    /// \param lhs - the first factor
+    /// \param rhs - the second factor
+    /// \return the chain lhs*rhs, unevaluated
+    template<class L, class R,
+             class = std::enable_if_t<is_transform_expression<L>::value && is_transform_expression<R>::value>>
+    constexpr TransformProduct<L, R> chain(const L & lhs, const R & rhs)
+    {
+        return {lhs, rhs};
+    }
 
-    /// \brief should print a human readable version of the twist:
-    /// An example output:
-    /// [1 2 3]
-    /// \param os - an output stream
-    /// \param tf - the transform to print
-    std::ostream & operator<<(std::ostream & os, const Transform2D & tf);
+    /// \brief a lazily evaluated composition of three or more transforms, grouped from the left
+    /// \param lhs - the first factor
+    /// \param rhs - the second factor
+    /// \param rest - the remaining factors
+    /// \return the chain lhs*rhs*rest..., unevaluated
+    template<class L, class R, class... Rest,
+             class = std::enable_if_t<is_transform_expression<L>::value && is_transform_expression<R>::value>>
+    constexpr auto chain(const L & lhs, const R & rhs, const Rest &... rest)
+    {
+        return chain(TransformProduct<L, R>{lhs, rhs}, rest...);
+    }
+
+    /// \brief print a composition of transforms, \see operator<<(std::ostream &, const BasicTransform2D<T> &)
+    template<class L, class R>
+    std::ostream & operator<<(std::ostream & os, const TransformProduct<L, R> & tf)
+    {
+        return os << tf.eval();
+    }
+
+    // Compile-time checks of the constexpr transform operations
+    static_assert(almost_equal(Transform2D{Vector2D{1.0, 2.0}}.translation().y, 2.0), "translation failed");
+    static_assert(almost_equal(Transform2D{PI/2}(Vector2D{1.0, 0.0}).y, 1.0), "rotation failed");
+    static_assert(almost_equal((Transform2D{Vector2D{1.0, 2.0}, 0.5}*Transform2D{Vector2D{1.0, 2.0}, 0.5}.inv()).translation().x, 0.0), "inv failed");
+    static_assert(almost_equal(Transform2D{Vector2D{0.0, 1.0}, PI/2}(Twist2D{{1.0, 1.0, 1.0}}).tw[1], 0.0), "adjoint failed");
+    static_assert(almost_equal((Transform2D{3*PI/4}*Transform2D{PI/2}).rotation(), -3*PI/4), "rotation wrap failed");
+    static_assert(almost_equal(Transform2D{PI}.inv().rotation(), PI), "rotation wrap failed");
+    static_assert(almost_equal(Transform2Df{static_cast<float>(PI/2)}(Vector2Df{1.0f, 0.0f}).y, 1.0, 1e-6), "float rotation failed");
+
+    /// \brief integrate a constant twist for a period of time (the SE(2) exponential map)
+    /// The motion is exact, not an Euler step: a twist with angular velocity follows a circular arc.
+    /// Uses one sin and one cos, with a series expansion when the rotation is tiny.
+    /// \param twist - the body twist, held constant
+    /// \param dt - how long the twist is followed
+    /// \return the displacement, expressed in the frame where the motion started
+    template<class T>
+    BasicTransform2D<T> integrate_twist(const BasicTwist2D<T> & twist, detail::identity_t<T> dt = T(1))
+    {
+        using std::sin;
+        using std::cos;
+        using std::abs;
+
+        // Reference: https://nu-msr.github.io/navigation_site/lectures/rigid2d.html (exponential coordinates)
+        // T = [R(th)  V(th)*v*dt] with V(th) = [a -b; b a], a = sin(th)/th, b = (1 - cos(th))/th
+        const T th = twist.thetadot()*dt;
+        const T vx = twist.xdot()*dt;
+        const T vy = twist.ydot()*dt;
+
+        const T s = sin(th);
+        const T c = cos(th);
+
+        T a = T(1);
+        T b = T(0);
+        if(abs(th) < T(1e-6)){
+            // Series: a = 1 - th^2/6, b = th/2 - th^3/24; the next terms are below 1e-24
+            const T th2 = th*th;
+            a = T(1) - th2/T(6);
+            b = th*(T(0.5) - th2/T(24));
+        } else {
+            // 1 - cos(th) cancels for small th, so use s^2/(1 + c) while c >= 0
+            const T one_minus_c = c >= T(0) ? s*s/(T(1) + c) : T(1) - c;
+            a = s/th;
+            b = one_minus_c/th;
+        }
+
+        return BasicTransform2D<T>::from_cos_sin({a*vx - b*vy, b*vx + a*vy}, c, s, th);
+    }
+
+    /// \brief the twist that, followed for unit time, produces a transform (the SE(2) logarithm)
+    /// Inverse of integrate_twist for rotations in (-pi, pi].
+    /// \param tf - the transform
+    /// \return the body twist; divide by dt to get the twist over a period dt
+    template<class T>
+    BasicTwist2D<T> log(const BasicTransform2D<T> & tf)
+    {
+        using std::abs;
+
+        // Inverse of integrate_twist: v = V(th)^-1 p, with V(th)^-1 = [al th/2; -th/2 al], al = th/2*cot(th/2)
+        const T c = tf.rotation_cos();
+        const T s = tf.rotation_sin();
+        const T th = tf.rotation();
+        const BasicVector2D<T> p = tf.translation();
+
+        T al = T(1);
+        if(abs(th) < T(1e-6)){
+            // Series: al = 1 - th^2/12
+            al = T(1) - th*th/T(12);
+        } else if(c >= T(0)){
+            // cot(th/2) = (1 + c)/s
+            al = th*(T(1) + c)/(T(2)*s);
+        } else {
+            // cot(th/2) = s/(1 - c), which does not cancel near th = pi
+            al = th*s/(T(2)*(T(1) - c));
+        }
+
+        BasicTwist2D<T> twist;
+        twist.thetadot() = th;
+        twist.xdot() = al*p.x + T(0.5)*th*p.y;
+        twist.ydot() = -T(0.5)*th*p.x + al*p.y;
+        return twist;
+    }
+
+    /// \brief log of a composition of transforms
+    template<class L, class R>
+    BasicTwist2D<typename L::scalar_type> log(const TransformProduct<L, R> & tf)
+    {
+        return log(tf.eval());
+    }
+
+    // The stream operators are compiled once, in text_io.cpp
+    extern template std::ostream & operator<<(std::ostream &, const BasicVector2D<double> &);
+    extern template std::ostream & operator<<(std::ostream &, const BasicVector2D<float> &);
+    extern template std::istream & operator>>(std::istream &, BasicVector2D<double> &);
+    extern template std::istream & operator>>(std::istream &, BasicVector2D<float> &);
+    extern template std::ostream & operator<<(std::ostream &, const BasicTwist2D<double> &);
+    extern template std::ostream & operator<<(std::ostream &, const BasicTwist2D<float> &);
+    extern template std::istream & operator>>(std::istream &, BasicTwist2D<double> &);
+    extern template std::istream & operator>>(std::istream &, BasicTwist2D<float> &);
+    extern template std::ostream & operator<<(std::ostream &, const BasicTransform2D<double> &);
+    extern template std::ostream & operator<<(std::ostream &, const BasicTransform2D<float> &);
+    extern template std::istream & operator>>(std::istream &, BasicTransform2D<double> &);
+    extern template std::istream & operator>>(std::istream &, BasicTransform2D<float> &);
 
 }
 
@@ -0,0 +1,159 @@
+#ifndef TEXT_IO_INCLUDE_GUARD_HPP
+#define TEXT_IO_INCLUDE_GUARD_HPP
+/// \file
+/// \brief Parsing and formatting vectors, twists and transforms as text, without allocation or exceptions.
+///
+/// The parsers read from a character range with std::from_chars, so they are not affected
+/// by the locale and never touch the heap. They accept the same formats as the stream
+/// operators, which are implemented on top of them:
+///   Vector2D:    [x y] or x y
+///   Twist2D:     [theta_dot x_dot y_dot] or theta_dot x_dot y_dot
+///   Transform2D: deg: 90 x: 3 y: 5 or 90 3 5 (the angle in degrees)
+/// Leading whitespace is skipped, and any whitespace may separate the fields.
+///
+/// Like std::from_chars, each parser returns a std::from_chars_result. On success ec is
+/// std::errc{} and ptr points just past the parsed text, ready for the next record. On failure
+/// ec is std::errc::invalid_argument (malformed text or end of input) or
+/// std::errc::result_out_of_range (a number does not fit the scalar type), ptr points at the
+/// offending character, and the output is left unchanged.
+///
+/// To read a whole buffer, parse records until skip_space() reaches the end:
+/// \code
+///   for(const char * p = skip_space(first, last); p != last; p = skip_space(p, last)){
+///       const auto result = parse(p, last, tf);
+///       if(result.ec != std::errc{}) { ... }
+///       p = result.ptr;
+///   }
+/// \endcode
+///
+/// The format functions write the same text with std::to_chars into a caller-provided buffer.
+/// Numbers are written in the shortest form that reads back to the same value, so vectors and
+/// twists round-trip exactly. A transform is written with its angle in degrees; the translation
+/// round-trips exactly and the angle to within the rounding of the degree conversion.
+/// On success they return ptr past the text and ec std::errc{}; if the buffer is too small
+/// they return ptr == last and std::errc::value_too_large, and the buffer contents are unspecified.
+///
+/// The parse and format functions are instantiated for float and double.
+
+
+#include<charconv>
+#include<cstddef>
+#include<string_view>
+#include "turtlelib/rigid2d.hpp"
+
+namespace turtlelib
+{
+
+    /// \brief skip whitespace
+    /// \param first - start of the text
+    /// \param last - end of the text
+    /// \return the first non-whitespace character, or last
+    const char * skip_space(const char * first, const char * last);
+
+    /// \brief parse a vector written as [x y] or x y
+    /// \param first - start of the text
+    /// \param last - end of the text
+    /// \param v [out] - the vector
+    /// \return ptr past the vector and ec on success, see the file documentation
+    template<class T>
+    std::from_chars_result parse(const char * first, const char * last, BasicVector2D<T> & v);
+
+    /// \brief parse a twist written as [theta_dot x_dot y_dot] or theta_dot x_dot y_dot
+    /// \param first - start of the text
+    /// \param last - end of the text
+    /// \param twist [out] - the twist
+    /// \return ptr past the twist and ec on success, see the file documentation
+    template<class T>
+    std::from_chars_result parse(const char * first, const char * last, BasicTwist2D<T> & twist);
+
+    /// \brief parse a transform written as deg: 90 x: 3 y: 5 or 90 3 5
+    /// \param first - start of the text
+    /// \param last - end of the text
+    /// \param tf [out] - the transform
+    /// \return ptr past the transform and ec on success, see the file documentation
+    template<class T>
+    std::from_chars_result parse(const char * first, const char * last, BasicTransform2D<T> & tf);
+
+    /// \brief parse a vector, twist or transform from the start of a string
+    /// \param text - the text
+    /// \param value [out] - the parsed value
+    /// \return ptr past the value and ec on success, see the file documentation
+    template<class Value>
+    std::from_chars_result parse(std::string_view text, Value & value)
+    {
+        return parse(text.data(), text.data() + text.size(), value);
+    }
+
+    /// \brief a buffer of this many characters always holds one formatted record, including its newline
+    constexpr std::size_t max_record_chars = 96;
+
+    /// \brief format a vector as [x y]
+    /// \param first - start of the buffer
+    /// \param last - end of the buffer
+    /// \param v - the vector
+    /// \return ptr past the text and ec, see the file documentation
+    template<class T>
+    std::to_chars_result format(char * first, char * last, const BasicVector2D<T> & v);
+
+    /// \brief format a twist as [theta_dot x_dot y_dot]
+    /// \param first - start of the buffer
+    /// \param last - end of the buffer
+    /// \param twist - the twist
+    /// \return ptr past the text and ec, see the file documentation
+    template<class T>
+    std::to_chars_result format(char * first, char * last, const BasicTwist2D<T> & twist);
+
+    /// \brief format a transform as deg: 90 x: 3 y: 5, followed by a newline
+    /// \param first - start of the buffer
+    /// \param last - end of the buffer
+    /// \param tf - the transform
+    /// \return ptr past the text and ec, see the file documentation
+    template<class T>
+    std::to_chars_result format(char * first, char * last, const BasicTransform2D<T> & tf);
+
+    /// \brief format an array of vectors, twists or transforms, one per line
+    /// Only whole records are written: when the buffer fills up, the text ends after the last
+    /// record that fit, so the caller can flush the buffer and continue from values + written.
+    /// \param first - start of the buffer
+    /// \param last - end of the buffer
+    /// \param values - n values
+    /// \param n - number of values
+    /// \param written [out] - number of values written
+    /// \return ptr past the text, and ec std::errc{} if all n were written, std::errc::value_too_large if not
+    template<class Value>
+    std::to_chars_result format(char * first, char * last, const Value * values, std::size_t n, std::size_t & written)
+    {
+        written = 0;
+        for(; written < n; written++){
+            std::to_chars_result result = format(first, last, values[written]);
+            if(result.ec == std::errc{} && result.ptr[-1] != '\n'){
+                if(result.ptr == last){
+                    result = {last, std::errc::value_too_large};
+                } else {
+                    *result.ptr++ = '\n';
+                }
+            }
+            if(result.ec != std::errc{}){
+                return {first, result.ec};
+            }
+            first = result.ptr;
+        }
+        return {first, std::errc{}};
+    }
+
+    extern template std::from_chars_result parse(const char *, const char *, BasicVector2D<double> &);
+    extern template std::from_chars_result parse(const char *, const char *, BasicVector2D<float> &);
+    extern template std::from_chars_result parse(const char *, const char *, BasicTwist2D<double> &);
+    extern template std::from_chars_result parse(const char *, const char *, BasicTwist2D<float> &);
+    extern template std::from_chars_result parse(const char *, const char *, BasicTransform2D<double> &);
+    extern template std::from_chars_result parse(const char *, const char *, BasicTransform2D<float> &);
+    extern template std::to_chars_result format(char *, char *, const BasicVector2D<double> &);
+    extern template std::to_chars_result format(char *, char *, const BasicVector2D<float> &);
+    extern template std::to_chars_result format(char *, char *, const BasicTwist2D<double> &);
+    extern template std::to_chars_result format(char *, char *, const BasicTwist2D<float> &);
+    extern template std::to_chars_result format(char *, char *, const BasicTransform2D<double> &);
+    extern template std::to_chars_result format(char *, char *, const BasicTransform2D<float> &);
+
+}
+
+#endif
@@ -0,0 +1,172 @@
+#ifndef TRAJECTORY_INCLUDE_GUARD_HPP
+#define TRAJECTORY_INCLUDE_GUARD_HPP
+/// \file
+/// \brief Reconstructing trajectories from relative pose increments.
+
+
+#include<cstddef>
+#include<vector>
+#include "turtlelib/rigid2d.hpp"
+
+namespace turtlelib
+{
+
+    /// \brief turn relative increments into absolute poses (inclusive prefix product)
+    /// poses[i] = increments[0] * increments[1] * ... * increments[i]
+    ///
+    /// Composition is associative, so the product is computed as a parallel scan: each thread
+    /// scans its own block, the block totals are combined serially into carries, and each
+    /// thread then left-multiplies its block by its carry.
+    /// The result differs from the serial operator*= fold only by floating-point reassociation.
+    /// For unit-scale increments the difference stays below 1e-9 (absolute, per component)
+    /// for trajectories of 1e6 increments; it grows with the length and the distance from the origin.
+    /// \param increments - n relative transforms
+    /// \param poses [out] - n absolute poses; may be the same array as increments
+    /// \param n - number of increments
+    /// \param threads - number of threads to use; 0 means one per hardware thread.
+    ///                  Short inputs are always composed serially.
+    void build_trajectory(const Transform2D * increments, Transform2D * poses, std::size_t n,
+                          unsigned threads = 0);
+
+    /// \brief an index over a sequence of increments that answers relative-pose queries in O(log n)
+    ///
+    /// Increment k moves the robot from pose k to pose k+1, so there are size()+1 poses
+    /// and pose 0 is the start. The increments are kept in a segment tree whose internal
+    /// nodes hold the composition of their children; a query composes O(log n) nodes.
+    /// Unlike differencing absolute poses, a query only involves the increments inside the
+    /// queried span, so its accuracy does not degrade far from the start of the trajectory.
+    class TrajectoryIndex
+    {
+    public:
+        /// \brief create an empty index
+        TrajectoryIndex() = default;
+
+        /// \brief build an index over existing increments, in O(n)
+        /// \param increments - n relative transforms
+        /// \param n - number of increments
+        TrajectoryIndex(const Transform2D * increments, std::size_t n);
+
+        /// \brief add an increment at the end of the trajectory, in amortized O(log n)
+        /// \param increment - the transform from the current last pose to the new one
+        void append(const Transform2D & increment);
+
+        /// \brief the number of increments
+        /// \return the number of increments (one less than the number of poses)
+        std::size_t size() const;
+
+        /// \brief the transform from pose i to pose j, in O(log n)
+        /// \param i - index of the first pose, at most size()
+        /// \param j - index of the second pose, at most size()
+        /// \return increments[i] * ... * increments[j-1] for i <= j, or its inverse for i > j
+        Transform2D relative(std::size_t i, std::size_t j) const;
+
+        /// \brief the absolute pose after i increments
+        /// \param i - index of the pose, at most size()
+        /// \return relative(0, i)
+        Transform2D pose(std::size_t i) const;
+
+    private:
+        /// \brief rebuild the tree with room for at least the given number of leaves
+        void reserve_leaves(std::size_t needed);
+
+        /// \brief the number of increments stored
+        std::size_t count = 0;
+
+        /// \brief the number of leaves, a power of two (0 when empty)
+        std::size_t leaves = 0;
+
+        /// \brief the segment tree: node k has children 2k and 2k+1, leaf i is node leaves+i.
+        /// Unused leaves hold the identity.
+        std::vector<Transform2D> tree;
+    };
+
+    /// \brief a running pose for long compositions (odometry) whose rotation stays on SO(2)
+    ///
+    /// Every operator*= rounds the cosine and sine of the rotation, with a bias that moves
+    /// them off the unit circle roughly linearly: |cos^2 + sin^2 - 1| reaches about 1e-8
+    /// after 1e8 compositions. The stored angle drifts too, because each small increment is
+    /// rounded when it is added to an angle near PI.
+    /// Every interval compositions the accumulator rescales the cosine and sine back onto
+    /// the unit circle, and takes the angle from them again. That costs one sqrt and one atan2.
+    /// Defined in the header so that the composition inlines into the caller's loop.
+    /// \tparam T - the scalar type
+    template<class T>
+    class BasicPoseAccumulator
+    {
+    public:
+        /// \brief start at the identity
+        /// \param interval - compositions between re-projections; 0 never re-projects
+        explicit BasicPoseAccumulator(std::size_t interval = 1024)
+            : BasicPoseAccumulator(BasicTransform2D<T>{}, interval)
+        {
+        }
+
+        /// \brief start at a given pose
+        /// \param start - the initial pose
+        /// \param interval - compositions between re-projections; 0 never re-projects
+        BasicPoseAccumulator(const BasicTransform2D<T> & start, std::size_t interval)
+            : current(start), every(interval), countdown(interval)
+        {
+        }
+
+        /// \brief compose an increment onto the pose
+        /// \param increment - the transform from the current pose to the next one
+        /// \return a reference to this accumulator
+        BasicPoseAccumulator & operator*=(const BasicTransform2D<T> & increment)
+        {
+            current*=increment;
+            if(countdown != 0 && --countdown == 0){
+                reproject();
+                countdown = every;
+            }
+            return *this;
+        }
+
+        /// \brief put the rotation back on SO(2) now
+        void reproject()
+        {
+            using std::sqrt;
+            using std::atan2;
+
+            // Scaling keeps the direction of [c s], which is far more accurate than its length
+            const T k = T(1)/sqrt(current.rotation_cos()*current.rotation_cos()
+                                  + current.rotation_sin()*current.rotation_sin());
+            const T c = k*current.rotation_cos();
+            const T s = k*current.rotation_sin();
+            current = BasicTransform2D<T>::from_cos_sin(current.translation(), c, s, atan2(s, c));
+        }
+
+        /// \brief the current pose
+        /// \return the composition of the start and every increment so far
+        const BasicTransform2D<T> & pose() const
+        {
+            return current;
+        }
+
+        /// \brief compositions between re-projections
+        /// \return the interval, 0 if re-projection is off
+        std::size_t interval() const
+        {
+            return every;
+        }
+
+    private:
+        /// \brief the current pose
+        BasicTransform2D<T> current;
+
+        /// \brief compositions between re-projections, 0 for never
+        std::size_t every;
+
+        /// \brief compositions left before the next re-projection
+        std::size_t countdown;
+    };
+
+    /// \brief a pose accumulator in doubles
+    using PoseAccumulator = BasicPoseAccumulator<double>;
+
+    /// \brief a pose accumulator in floats
+    using PoseAccumulatorf = BasicPoseAccumulator<float>;
+
+}
+
+#endif
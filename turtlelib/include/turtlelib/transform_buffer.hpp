@@ -0,0 +1,117 @@
+#ifndef TRANSFORM_BUFFER_INCLUDE_GUARD_HPP
+#define TRANSFORM_BUFFER_INCLUDE_GUARD_HPP
+/// \file
+/// \brief A bounded history of timestamped transforms, written by one thread and read by many.
+///
+/// One thread (e.g. the simulator) pushes a transform every tick; any number of threads ask
+/// for the transform at a time. A lookup between two samples interpolates on SE(2): it follows
+/// the constant twist that moves the earlier sample onto the later one, so an arc stays an arc.
+/// A lookup shortly after the newest sample extrapolates along the last such twist.
+///
+/// Readers take no lock and never block the writer. Each slot carries a sequence number
+/// (a seqlock) that the writer makes odd while it rewrites the slot. A reader that finds
+/// a slot being rewritten, or already holding a newer sample, starts its lookup again.
+/// That only happens to lookups near the oldest sample while the writer wraps around.
+///
+/// Errors are reported as std::errc values, std::errc{} meaning success, as in text_io.hpp.
+
+
+#include<atomic>
+#include<cstddef>
+#include<cstdint>
+#include<memory>
+#include<system_error>
+#include "turtlelib/rigid2d.hpp"
+
+namespace turtlelib
+{
+
+    /// \brief a ring buffer of timestamped transforms with interpolated lookups by time
+    class TransformBuffer
+    {
+    public:
+        /// \brief create an empty buffer
+        /// \param capacity - samples kept; rounded up to a power of two, at least 2
+        /// \param max_extrapolation_ns - how far past the newest sample lookup() extrapolates
+        explicit TransformBuffer(std::size_t capacity = 1024, std::int64_t max_extrapolation_ns = 100000000);
+
+        /// \brief add a sample, overwriting the oldest one when full. Only one thread may push.
+        /// \param stamp_ns - the time of the sample, in nanoseconds; later than every earlier sample
+        /// \param tf - the transform at that time
+        /// \return std::errc{} on success, std::errc::invalid_argument if the stamp is not
+        ///         later than the newest sample's
+        std::errc push(std::int64_t stamp_ns, const Transform2D & tf);
+
+        /// \brief the transform at a time, interpolated or extrapolated. Any thread may look up.
+        /// Lookups take O(log capacity) reads of the buffer.
+        /// \param stamp_ns - the time, in nanoseconds
+        /// \param tf [out] - the transform at that time
+        /// \return std::errc{} on success, std::errc::result_out_of_range if the time is before
+        ///         the oldest sample kept, more than the extrapolation horizon after the newest,
+        ///         or the buffer is empty
+        std::errc lookup(std::int64_t stamp_ns, Transform2D & tf) const;
+
+        /// \brief the number of samples kept
+        std::size_t size() const;
+
+        /// \brief the most samples kept
+        std::size_t capacity() const
+        {
+            return mask + 1;
+        }
+
+    private:
+        /// \brief a transform at an instant, as copied out of a slot
+        struct Sample
+        {
+            /// \brief the time, in nanoseconds
+            std::int64_t stamp_ns;
+
+            /// \brief the transform
+            Transform2D tf;
+        };
+
+        /// \brief one entry of the ring, on its own cache line so that the writer filling one
+        /// slot does not slow down readers of the next.
+        /// The fields are relaxed atomics: readers may load them while the writer stores them,
+        /// and discard what they read when the sequence number says so.
+        struct alignas(64) Slot
+        {
+            /// \brief 2*(k+1) once the slot holds sample k, odd while it is being rewritten
+            std::atomic<std::uint64_t> seq{0};
+
+            /// \brief the time of the sample
+            std::atomic<std::int64_t> stamp_ns{0};
+
+            /// \brief the angle, its cosine and sine, and the translation of the transform
+            std::atomic<double> th{0.0}, cos_th{1.0}, sin_th{0.0}, x{0.0}, y{0.0};
+        };
+
+        /// \brief copy the stamp of sample k
+        /// \return false if the slot no longer (or not yet) holds sample k
+        bool read_stamp(std::uint64_t k, std::int64_t & stamp_ns) const;
+
+        /// \brief copy sample k
+        /// \return false if the slot no longer (or not yet) holds sample k
+        bool read_sample(std::uint64_t k, Sample & sample) const;
+
+        /// \brief the ring; sample k lives in slot k & mask
+        std::unique_ptr<Slot[]> slots;
+
+        /// \brief capacity - 1
+        std::size_t mask;
+
+        /// \brief how far past the newest sample lookup() extrapolates
+        std::int64_t max_extrapolation;
+
+        /// \brief the number of samples ever pushed; samples [head - capacity, head) are kept.
+        /// On its own cache line with the writer's state, away from the fields readers only load.
+        alignas(64) std::atomic<std::uint64_t> head{0};
+
+        /// \brief the newest stamp, for the writer's ordering check
+        std::int64_t last_stamp = 0;
+    };
+
+}
+
+#endif
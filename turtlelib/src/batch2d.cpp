@@ -0,0 +1,1338 @@
+#include "turtlelib/batch2d.hpp"
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define TURTLELIB_X86 1
+#include <immintrin.h>
+#endif
+
+/// \file
+/// \brief Implementation file for the batch rigid2d kernels
+
+namespace turtlelib
+{
+    static_assert(sizeof(Vector2D) == 2*sizeof(double), "Vector2D must be two packed doubles");
+    static_assert(std::is_standard_layout<Vector2D>::value, "Vector2D must be standard layout");
+    static_assert(sizeof(Vector2Df) == 2*sizeof(float), "Vector2Df must be two packed floats");
+
+    namespace
+    {
+        SimdLevel detect()
+        {
+#ifdef TURTLELIB_X86
+            __builtin_cpu_init();
+            if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")){
+                return SimdLevel::avx2;
+            }
+            if(__builtin_cpu_supports("sse2")){
+                return SimdLevel::sse2;
+            }
+#endif
+            return SimdLevel::scalar;
+        }
+
+        std::atomic<SimdLevel> & active_level()
+        {
+            // Function-local static so the detection runs once, on first use
+            static std::atomic<SimdLevel> level{detected_simd_level()};
+            return level;
+        }
+
+        // Scalar kernels, also used for the tails of the vector kernels
+
+        template<class T>
+        void points_aos_scalar(const BasicTransform2D<T> & tf, const BasicVector2D<T> * in, BasicVector2D<T> * out,
+                               std::size_t begin, std::size_t n)
+        {
+            for(std::size_t i = begin; i < n; i++){
+                out[i] = tf(in[i]);
+            }
+        }
+
+        template<class T>
+        void points_soa_scalar(const BasicTransform2D<T> & tf, const T * x_in, const T * y_in,
+                               T * x_out, T * y_out, std::size_t begin, std::size_t n)
+        {
+            const T c = tf.rotation_cos();
+            const T s = tf.rotation_sin();
+            const BasicVector2D<T> p = tf.translation();
+            for(std::size_t i = begin; i < n; i++){
+                const T x = x_in[i];
+                const T y = y_in[i];
+                x_out[i] = x*c - y*s + p.x;
+                y_out[i] = x*s + y*c + p.y;
+            }
+        }
+
+        template<class T>
+        void twists_scalar(const BasicTransform2D<T> & tf, const BasicTwist2D<T> * in, BasicTwist2D<T> * out,
+                           std::size_t begin, std::size_t n)
+        {
+            // Adjoint [1 0 0; y c -s; -x s c], formed once
+            const T c = tf.rotation_cos();
+            const T s = tf.rotation_sin();
+            const BasicVector2D<T> p = tf.translation();
+            for(std::size_t i = begin; i < n; i++){
+                const T w = in[i].tw[0];
+                const T vx = in[i].tw[1];
+                const T vy = in[i].tw[2];
+                out[i].tw[0] = w;
+                out[i].tw[1] = p.y*w + c*vx - s*vy;
+                out[i].tw[2] = -p.x*w + s*vx + c*vy;
+            }
+        }
+
+        template<class T>
+        void integrate_twists_scalar(const BasicTwist2D<T> * twists, BasicTransform2D<T> * out, std::size_t n, T dt)
+        {
+            for(std::size_t i = 0; i < n; i++){
+                out[i] = integrate_twist(twists[i], dt);
+            }
+        }
+
+        template<class T>
+        void integrate_sequence_scalar(const BasicTransform2D<T> & start, const BasicTwist2D<T> * twists,
+                                       BasicTransform2D<T> * poses, std::size_t n, T dt)
+        {
+            BasicTransform2D<T> pose = start;
+            for(std::size_t i = 0; i < n; i++){
+                pose*=integrate_twist(twists[i], dt);
+                poses[i] = pose;
+            }
+        }
+
+        template<class T>
+        void normalize_scalar(const BasicVector2D<T> * in, BasicVector2D<T> * out, std::size_t begin, std::size_t n)
+        {
+            for(std::size_t i = begin; i < n; i++){
+                out[i] = in[i].normalize();
+            }
+        }
+
+        template<class T>
+        void magnitude_scalar(const BasicVector2D<T> * in, T * out, std::size_t begin, std::size_t n)
+        {
+            for(std::size_t i = begin; i < n; i++){
+                out[i] = magnitude(in[i]);
+            }
+        }
+
+        template<class T>
+        void dot_scalar(const BasicVector2D<T> * a, const BasicVector2D<T> * b, T * out, std::size_t begin, std::size_t n)
+        {
+            for(std::size_t i = begin; i < n; i++){
+                out[i] = dot(a[i], b[i]);
+            }
+        }
+
+        template<class T>
+        void angle_scalar(const BasicVector2D<T> * a, const BasicVector2D<T> * b, T * out, std::size_t begin, std::size_t n)
+        {
+            for(std::size_t i = begin; i < n; i++){
+                out[i] = angle(a[i], b[i]);
+            }
+        }
+
+        template<class T>
+        void normalize_angle_scalar(const T * in, T * out, std::size_t begin, std::size_t n)
+        {
+            for(std::size_t i = begin; i < n; i++){
+                out[i] = normalize_angle(in[i]);
+            }
+        }
+
+        template<class T>
+        void deg2rad_scalar(const T * in, T * out, std::size_t begin, std::size_t n)
+        {
+            for(std::size_t i = begin; i < n; i++){
+                out[i] = static_cast<T>(deg2rad(in[i]));
+            }
+        }
+
+        template<class T>
+        void rad2deg_scalar(const T * in, T * out, std::size_t begin, std::size_t n)
+        {
+            for(std::size_t i = begin; i < n; i++){
+                out[i] = static_cast<T>(rad2deg(in[i]));
+            }
+        }
+
+        // The constants of normalize_angle() in rigid2d.hpp; the kernels repeat its operations in the same order
+        constexpr double two_pi_1 = 6.283185303211212;
+        constexpr double two_pi_2 = 3.9683743166540886e-09;
+        constexpr double two_pi_3 = 2.068073192717642e-18;
+        constexpr double inv_two_pi = 0.15915494309189535;
+        constexpr double round_magic = 6755399441055744.0;
+
+#ifdef TURTLELIB_X86
+
+        __attribute__((target("sse2")))
+        void points_aos_sse2(const Transform2D & tf, const Vector2D * in, Vector2D * out, std::size_t n)
+        {
+            const double c = tf.rotation_cos();
+            const double s = tf.rotation_sin();
+            const Vector2D p = tf.translation();
+
+            // out = [x x]*[c s] + [y y]*[-s c] + [px py]
+            const __m128d col0 = _mm_set_pd(s, c);
+            const __m128d col1 = _mm_set_pd(c, -s);
+            const __m128d trans = _mm_set_pd(p.y, p.x);
+
+            const double * src = reinterpret_cast<const double *>(in);
+            double * dst = reinterpret_cast<double *>(out);
+            for(std::size_t i = 0; i < n; i++){
+                const __m128d v = _mm_loadu_pd(src + 2*i);
+                const __m128d xx = _mm_unpacklo_pd(v, v);
+                const __m128d yy = _mm_unpackhi_pd(v, v);
+                const __m128d r = _mm_add_pd(_mm_add_pd(_mm_mul_pd(xx, col0), _mm_mul_pd(yy, col1)), trans);
+                _mm_storeu_pd(dst + 2*i, r);
+            }
+        }
+
+        __attribute__((target("sse2")))
+        void points_soa_sse2(const Transform2D & tf, const double * x_in, const double * y_in,
+                             double * x_out, double * y_out, std::size_t n)
+        {
+            const __m128d c = _mm_set1_pd(tf.rotation_cos());
+            const __m128d s = _mm_set1_pd(tf.rotation_sin());
+            const __m128d px = _mm_set1_pd(tf.translation().x);
+            const __m128d py = _mm_set1_pd(tf.translation().y);
+
+            std::size_t i = 0;
+            for(; i + 2 <= n; i += 2){
+                const __m128d x = _mm_loadu_pd(x_in + i);
+                const __m128d y = _mm_loadu_pd(y_in + i);
+                const __m128d xr = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(x, c), _mm_mul_pd(y, s)), px);
+                const __m128d yr = _mm_add_pd(_mm_add_pd(_mm_mul_pd(x, s), _mm_mul_pd(y, c)), py);
+                _mm_storeu_pd(x_out + i, xr);
+                _mm_storeu_pd(y_out + i, yr);
+            }
+            points_soa_scalar(tf, x_in, y_in, x_out, y_out, i, n);
+        }
+
+        __attribute__((target("avx2,fma")))
+        void points_aos_avx2(const Transform2D & tf, const Vector2D * in, Vector2D * out, std::size_t n)
+        {
+            const double c = tf.rotation_cos();
+            const double s = tf.rotation_sin();
+            const Vector2D p = tf.translation();
+
+            // Two points per register: [x0 y0 x1 y1]
+            const __m256d col0 = _mm256_set_pd(s, c, s, c);
+            const __m256d col1 = _mm256_set_pd(c, -s, c, -s);
+            const __m256d trans = _mm256_set_pd(p.y, p.x, p.y, p.x);
+
+            const double * src = reinterpret_cast<const double *>(in);
+            double * dst = reinterpret_cast<double *>(out);
+            std::size_t i = 0;
+            for(; i + 4 <= n; i += 4){
+                const __m256d v0 = _mm256_loadu_pd(src + 2*i);
+                const __m256d v1 = _mm256_loadu_pd(src + 2*i + 4);
+                const __m256d r0 = _mm256_fmadd_pd(_mm256_movedup_pd(v0), col0,
+                                   _mm256_fmadd_pd(_mm256_permute_pd(v0, 0xF), col1, trans));
+                const __m256d r1 = _mm256_fmadd_pd(_mm256_movedup_pd(v1), col0,
+                                   _mm256_fmadd_pd(_mm256_permute_pd(v1, 0xF), col1, trans));
+                _mm256_storeu_pd(dst + 2*i, r0);
+                _mm256_storeu_pd(dst + 2*i + 4, r1);
+            }
+            points_aos_scalar(tf, in, out, i, n);
+        }
+
+        __attribute__((target("avx2,fma")))
+        void points_soa_avx2(const Transform2D & tf, const double * x_in, const double * y_in,
+                             double * x_out, double * y_out, std::size_t n)
+        {
+            const __m256d c = _mm256_set1_pd(tf.rotation_cos());
+            const __m256d s = _mm256_set1_pd(tf.rotation_sin());
+            const __m256d px = _mm256_set1_pd(tf.translation().x);
+            const __m256d py = _mm256_set1_pd(tf.translation().y);
+
+            std::size_t i = 0;
+            for(; i + 4 <= n; i += 4){
+                const __m256d x = _mm256_loadu_pd(x_in + i);
+                const __m256d y = _mm256_loadu_pd(y_in + i);
+                const __m256d xr = _mm256_fmadd_pd(x, c, _mm256_fnmadd_pd(y, s, px));
+                const __m256d yr = _mm256_fmadd_pd(x, s, _mm256_fmadd_pd(y, c, py));
+                _mm256_storeu_pd(x_out + i, xr);
+                _mm256_storeu_pd(y_out + i, yr);
+            }
+            points_soa_scalar(tf, x_in, y_in, x_out, y_out, i, n);
+        }
+
+        __attribute__((target("sse2")))
+        void twists_sse2(const Transform2D & tf, const Twist2D * in, Twist2D * out, std::size_t n)
+        {
+            const double c = tf.rotation_cos();
+            const double s = tf.rotation_sin();
+            const Vector2D p = tf.translation();
+
+            // [vx' vy'] = [vx vx]*[c s] + [vy vy]*[-s c] + [w w]*[y -x]
+            const __m128d col0 = _mm_set_pd(s, c);
+            const __m128d col1 = _mm_set_pd(c, -s);
+            const __m128d col_w = _mm_set_pd(-p.x, p.y);
+
+            const double * src = reinterpret_cast<const double *>(in);
+            double * dst = reinterpret_cast<double *>(out);
+            for(std::size_t i = 0; i < n; i++){
+                const __m128d w = _mm_load1_pd(src + 3*i);
+                const __m128d v = _mm_loadu_pd(src + 3*i + 1);
+                const __m128d vx = _mm_unpacklo_pd(v, v);
+                const __m128d vy = _mm_unpackhi_pd(v, v);
+                const __m128d r = _mm_add_pd(_mm_add_pd(_mm_mul_pd(vx, col0), _mm_mul_pd(vy, col1)), _mm_mul_pd(w, col_w));
+                _mm_store_sd(dst + 3*i, w);
+                _mm_storeu_pd(dst + 3*i + 1, r);
+            }
+        }
+
+        __attribute__((target("avx2,fma")))
+        void twists_avx2(const Transform2D & tf, const Twist2D * in, Twist2D * out, std::size_t n)
+        {
+            const __m256d c = _mm256_set1_pd(tf.rotation_cos());
+            const __m256d s = _mm256_set1_pd(tf.rotation_sin());
+            const __m256d px = _mm256_set1_pd(tf.translation().x);
+            const __m256d py = _mm256_set1_pd(tf.translation().y);
+
+            const double * src = reinterpret_cast<const double *>(in);
+            double * dst = reinterpret_cast<double *>(out);
+            std::size_t i = 0;
+            for(; i + 4 <= n; i += 4){
+                // Four twists are twelve doubles: a = [w0 x0 y0 w1], b = [x1 y1 w2 x2], c = [y2 w3 x3 y3]
+                const __m256d a = _mm256_loadu_pd(src + 3*i);
+                const __m256d b = _mm256_loadu_pd(src + 3*i + 4);
+                const __m256d d = _mm256_loadu_pd(src + 3*i + 8);
+
+                // Deinterleave into W, X, Y
+                const __m256d m0 = _mm256_blend_pd(a, b, 0xC);          // [w0 x0 w2 x2]
+                const __m256d m1 = _mm256_permute2f128_pd(a, d, 0x21);  // [y0 w1 y2 w3]
+                const __m256d m2 = _mm256_blend_pd(b, d, 0xC);          // [x1 y1 x3 y3]
+                const __m256d w = _mm256_blend_pd(m0, m1, 0xA);
+                const __m256d vx = _mm256_shuffle_pd(m0, m2, 0x5);
+                const __m256d vy = _mm256_blend_pd(m1, m2, 0xA);
+
+                const __m256d rx = _mm256_fmadd_pd(py, w, _mm256_fmsub_pd(c, vx, _mm256_mul_pd(s, vy)));
+                const __m256d ry = _mm256_fmadd_pd(s, vx, _mm256_fmsub_pd(c, vy, _mm256_mul_pd(px, w)));
+
+                // Interleave back
+                const __m256d n0 = _mm256_unpacklo_pd(w, rx);           // [w0 x0 w2 x2]
+                const __m256d n1 = _mm256_blend_pd(ry, w, 0xA);         // [y0 w1 y2 w3]
+                const __m256d n2 = _mm256_unpackhi_pd(rx, ry);          // [x1 y1 x3 y3]
+                _mm256_storeu_pd(dst + 3*i, _mm256_permute2f128_pd(n0, n1, 0x20));
+                _mm256_storeu_pd(dst + 3*i + 4, _mm256_blend_pd(n2, n0, 0xC));
+                _mm256_storeu_pd(dst + 3*i + 8, _mm256_permute2f128_pd(n1, n2, 0x31));
+            }
+            twists_scalar(tf, in, out, i, n);
+        }
+
+        // Vector kernels: each register pair of interleaved [x y] vectors is split into x and y registers.
+        // normalize and magnitude use the same operations as the scalar code (no FMA), so give the same bits.
+
+        __attribute__((target("sse2")))
+        void normalize_sse2(const Vector2D * in, Vector2D * out, std::size_t n)
+        {
+            const double * src = reinterpret_cast<const double *>(in);
+            double * dst = reinterpret_cast<double *>(out);
+            const __m128d one = _mm_set1_pd(1.0);
+            std::size_t i = 0;
+            for(; i + 2 <= n; i += 2){
+                const __m128d v0 = _mm_loadu_pd(src + 2*i);
+                const __m128d v1 = _mm_loadu_pd(src + 2*i + 2);
+                const __m128d x = _mm_unpacklo_pd(v0, v1);
+                const __m128d y = _mm_unpackhi_pd(v0, v1);
+                const __m128d inv = _mm_div_pd(one, _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(x, x), _mm_mul_pd(y, y))));
+                const __m128d xn = _mm_mul_pd(x, inv);
+                const __m128d yn = _mm_mul_pd(y, inv);
+                _mm_storeu_pd(dst + 2*i, _mm_unpacklo_pd(xn, yn));
+                _mm_storeu_pd(dst + 2*i + 2, _mm_unpackhi_pd(xn, yn));
+            }
+            normalize_scalar(in, out, i, n);
+        }
+
+        __attribute__((target("sse2")))
+        void magnitude_sse2(const Vector2D * in, double * out, std::size_t n)
+        {
+            const double * src = reinterpret_cast<const double *>(in);
+            std::size_t i = 0;
+            for(; i + 2 <= n; i += 2){
+                const __m128d v0 = _mm_loadu_pd(src + 2*i);
+                const __m128d v1 = _mm_loadu_pd(src + 2*i + 2);
+                const __m128d x = _mm_unpacklo_pd(v0, v1);
+                const __m128d y = _mm_unpackhi_pd(v0, v1);
+                _mm_storeu_pd(out + i, _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(x, x), _mm_mul_pd(y, y))));
+            }
+            magnitude_scalar(in, out, i, n);
+        }
+
+        __attribute__((target("sse2")))
+        void dot_sse2(const Vector2D * a, const Vector2D * b, double * out, std::size_t n)
+        {
+            const double * pa = reinterpret_cast<const double *>(a);
+            const double * pb = reinterpret_cast<const double *>(b);
+            std::size_t i = 0;
+            for(; i + 2 <= n; i += 2){
+                const __m128d a0 = _mm_loadu_pd(pa + 2*i);
+                const __m128d a1 = _mm_loadu_pd(pa + 2*i + 2);
+                const __m128d p0 = _mm_mul_pd(a0, _mm_loadu_pd(pb + 2*i));
+                const __m128d p1 = _mm_mul_pd(a1, _mm_loadu_pd(pb + 2*i + 2));
+                _mm_storeu_pd(out + i, _mm_add_pd(_mm_unpacklo_pd(p0, p1), _mm_unpackhi_pd(p0, p1)));
+            }
+            dot_scalar(a, b, out, i, n);
+        }
+
+        /// \brief split four interleaved vectors into x and y registers
+        /// The lanes come out in the order [0 2 1 3]; unpacking them again restores [x y] pairs.
+        __attribute__((target("avx2,fma")))
+        void deinterleave_avx2(const double * src, __m256d & x, __m256d & y)
+        {
+            const __m256d v0 = _mm256_loadu_pd(src);
+            const __m256d v1 = _mm256_loadu_pd(src + 4);
+            x = _mm256_unpacklo_pd(v0, v1);
+            y = _mm256_unpackhi_pd(v0, v1);
+        }
+
+        __attribute__((target("avx2,fma")))
+        void normalize_avx2(const Vector2D * in, Vector2D * out, std::size_t n)
+        {
+            const double * src = reinterpret_cast<const double *>(in);
+            double * dst = reinterpret_cast<double *>(out);
+            const __m256d one = _mm256_set1_pd(1.0);
+            std::size_t i = 0;
+            for(; i + 4 <= n; i += 4){
+                __m256d x, y;
+                deinterleave_avx2(src + 2*i, x, y);
+                const __m256d inv = _mm256_div_pd(one, _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y))));
+                const __m256d xn = _mm256_mul_pd(x, inv);
+                const __m256d yn = _mm256_mul_pd(y, inv);
+                _mm256_storeu_pd(dst + 2*i, _mm256_unpacklo_pd(xn, yn));
+                _mm256_storeu_pd(dst + 2*i + 4, _mm256_unpackhi_pd(xn, yn));
+            }
+            normalize_scalar(in, out, i, n);
+        }
+
+        __attribute__((target("avx2,fma")))
+        void magnitude_avx2(const Vector2D * in, double * out, std::size_t n)
+        {
+            const double * src = reinterpret_cast<const double *>(in);
+            std::size_t i = 0;
+            for(; i + 4 <= n; i += 4){
+                __m256d x, y;
+                deinterleave_avx2(src + 2*i, x, y);
+                const __m256d m = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)));
+                _mm256_storeu_pd(out + i, _mm256_permute4x64_pd(m, 0xD8));
+            }
+            magnitude_scalar(in, out, i, n);
+        }
+
+        __attribute__((target("avx2,fma")))
+        void dot_avx2(const Vector2D * a, const Vector2D * b, double * out, std::size_t n)
+        {
+            const double * pa = reinterpret_cast<const double *>(a);
+            const double * pb = reinterpret_cast<const double *>(b);
+            std::size_t i = 0;
+            for(; i + 4 <= n; i += 4){
+                __m256d ax, ay, bx, by;
+                deinterleave_avx2(pa + 2*i, ax, ay);
+                deinterleave_avx2(pb + 2*i, bx, by);
+                const __m256d d = _mm256_fmadd_pd(ax, bx, _mm256_mul_pd(ay, by));
+                _mm256_storeu_pd(out + i, _mm256_permute4x64_pd(d, 0xD8));
+            }
+            dot_scalar(a, b, out, i, n);
+        }
+
+        /// \brief atan2 of four pairs, following std::atan2 for signed zeros
+        /// The ratio of the smaller to the larger magnitude is reduced to [0, 0.66] and atan is
+        /// evaluated there with the Cephes rational approximation (relative error about 1e-16).
+        __attribute__((target("avx2,fma")))
+        __m256d atan2_avx2(__m256d y, __m256d x)
+        {
+            const __m256d sign = _mm256_set1_pd(-0.0);
+            const __m256d ax = _mm256_andnot_pd(sign, x);
+            const __m256d ay = _mm256_andnot_pd(sign, y);
+            const __m256d lo = _mm256_min_pd(ax, ay);
+            const __m256d hi = _mm256_max_pd(ax, ay);
+            const __m256d zero = _mm256_setzero_pd();
+            const __m256d one = _mm256_set1_pd(1.0);
+
+            // t = lo/hi in [0, 1]; 0/0 becomes 0
+            __m256d t = _mm256_div_pd(lo, hi);
+            t = _mm256_blendv_pd(t, zero, _mm256_cmp_pd(hi, zero, _CMP_EQ_OQ));
+
+            // atan(t) = pi/4 + atan((t - 1)/(t + 1)) above 0.66
+            const double more_bits = 6.123233995736765886130e-17;
+            const __m256d big = _mm256_cmp_pd(t, _mm256_set1_pd(0.66), _CMP_GT_OQ);
+            const __m256d r = _mm256_blendv_pd(t, _mm256_div_pd(_mm256_sub_pd(t, one), _mm256_add_pd(t, one)), big);
+            const __m256d base = _mm256_and_pd(big, _mm256_set1_pd(PI/4));
+            const __m256d base_lo = _mm256_and_pd(big, _mm256_set1_pd(0.5*more_bits));
+
+            const __m256d z = _mm256_mul_pd(r, r);
+            __m256d p = _mm256_set1_pd(-8.750608600031904122785e-1);
+            p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-1.615753718733365076637e1));
+            p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-7.500855792314704667340e1));
+            p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-1.228866684490136173410e2));
+            p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-6.485021904942025371773e1));
+            __m256d q = _mm256_add_pd(z, _mm256_set1_pd(2.485846490142306297962e1));
+            q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(1.650270098316988542046e2));
+            q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(4.328810604912902668951e2));
+            q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(4.853903996359136964868e2));
+            q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(1.945506571482613964425e2));
+            const __m256d poly = _mm256_div_pd(_mm256_mul_pd(z, p), q);
+            __m256d a = _mm256_add_pd(base, _mm256_add_pd(_mm256_fmadd_pd(r, poly, r), base_lo));
+
+            // Undo the reductions: swap of x and y, then the sign of x, then the sign of y
+            const __m256d swapped = _mm256_cmp_pd(ay, ax, _CMP_GT_OQ);
+            a = _mm256_blendv_pd(a, _mm256_add_pd(_mm256_sub_pd(_mm256_set1_pd(PI/2), a), _mm256_set1_pd(more_bits)), swapped);
+            a = _mm256_blendv_pd(a, _mm256_add_pd(_mm256_sub_pd(_mm256_set1_pd(PI), a), _mm256_set1_pd(2*more_bits)), x);
+            return _mm256_or_pd(a, _mm256_and_pd(sign, y));
+        }
+
+        __attribute__((target("avx2,fma")))
+        void angle_avx2(const Vector2D * a, const Vector2D * b, double * out, std::size_t n)
+        {
+            const double * pa = reinterpret_cast<const double *>(a);
+            const double * pb = reinterpret_cast<const double *>(b);
+            std::size_t i = 0;
+            for(; i + 4 <= n; i += 4){
+                __m256d ax, ay, bx, by;
+                deinterleave_avx2(pa + 2*i, ax, ay);
+                deinterleave_avx2(pb + 2*i, bx, by);
+                const __m256d d = _mm256_fmadd_pd(ax, bx, _mm256_mul_pd(ay, by));
+                const __m256d c = _mm256_fmsub_pd(ax, by, _mm256_mul_pd(ay, bx));
+                _mm256_storeu_pd(out + i, _mm256_permute4x64_pd(atan2_avx2(c, d), 0xD8));
+            }
+            angle_scalar(a, b, out, i, n);
+        }
+
+        /// \brief mask ? a : b for SSE2, which has no blendv
+        __attribute__((target("sse2")))
+        __m128d select_sse2(__m128d mask, __m128d a, __m128d b)
+        {
+            return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+        }
+
+        /// \brief atan2 of two pairs, the same approximation as atan2_avx2 without FMA
+        __attribute__((target("sse2")))
+        __m128d atan2_sse2(__m128d y, __m128d x)
+        {
+            const __m128d sign = _mm_set1_pd(-0.0);
+            const __m128d ax = _mm_andnot_pd(sign, x);
+            const __m128d ay = _mm_andnot_pd(sign, y);
+            const __m128d lo = _mm_min_pd(ax, ay);
+            const __m128d hi = _mm_max_pd(ax, ay);
+            const __m128d zero = _mm_setzero_pd();
+            const __m128d one = _mm_set1_pd(1.0);
+
+            // t = lo/hi in [0, 1]; 0/0 becomes 0
+            const __m128d t = _mm_andnot_pd(_mm_cmpeq_pd(hi, zero), _mm_div_pd(lo, hi));
+
+            // atan(t) = pi/4 + atan((t - 1)/(t + 1)) above 0.66
+            const double more_bits = 6.123233995736765886130e-17;
+            const __m128d big = _mm_cmpgt_pd(t, _mm_set1_pd(0.66));
+            const __m128d r = select_sse2(big, _mm_div_pd(_mm_sub_pd(t, one), _mm_add_pd(t, one)), t);
+            const __m128d base = _mm_and_pd(big, _mm_set1_pd(PI/4));
+            const __m128d base_lo = _mm_and_pd(big, _mm_set1_pd(0.5*more_bits));
+
+            const __m128d z = _mm_mul_pd(r, r);
+            __m128d p = _mm_set1_pd(-8.750608600031904122785e-1);
+            p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(-1.615753718733365076637e1));
+            p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(-7.500855792314704667340e1));
+            p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(-1.228866684490136173410e2));
+            p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(-6.485021904942025371773e1));
+            __m128d q = _mm_add_pd(z, _mm_set1_pd(2.485846490142306297962e1));
+            q = _mm_add_pd(_mm_mul_pd(q, z), _mm_set1_pd(1.650270098316988542046e2));
+            q = _mm_add_pd(_mm_mul_pd(q, z), _mm_set1_pd(4.328810604912902668951e2));
+            q = _mm_add_pd(_mm_mul_pd(q, z), _mm_set1_pd(4.853903996359136964868e2));
+            q = _mm_add_pd(_mm_mul_pd(q, z), _mm_set1_pd(1.945506571482613964425e2));
+            const __m128d poly = _mm_div_pd(_mm_mul_pd(z, p), q);
+            __m128d a = _mm_add_pd(base, _mm_add_pd(_mm_add_pd(_mm_mul_pd(r, poly), r), base_lo));
+
+            // Undo the reductions: swap of x and y, then the sign of x (-0.0 included), then the sign of y
+            const __m128d swapped = _mm_cmpgt_pd(ay, ax);
+            a = select_sse2(swapped, _mm_add_pd(_mm_sub_pd(_mm_set1_pd(PI/2), a), _mm_set1_pd(more_bits)), a);
+            const __m128d negative = _mm_castsi128_pd(_mm_shuffle_epi32(_mm_srai_epi32(_mm_castpd_si128(x), 31),
+                                                                        _MM_SHUFFLE(3, 3, 1, 1)));
+            a = select_sse2(negative, _mm_add_pd(_mm_sub_pd(_mm_set1_pd(PI), a), _mm_set1_pd(2*more_bits)), a);
+            return _mm_or_pd(a, _mm_and_pd(sign, y));
+        }
+
+        __attribute__((target("sse2")))
+        void angle_sse2(const Vector2D * a, const Vector2D * b, double * out, std::size_t n)
+        {
+            const double * pa = reinterpret_cast<const double *>(a);
+            const double * pb = reinterpret_cast<const double *>(b);
+            std::size_t i = 0;
+            for(; i + 2 <= n; i += 2){
+                const __m128d a0 = _mm_loadu_pd(pa + 2*i);
+                const __m128d a1 = _mm_loadu_pd(pa + 2*i + 2);
+                const __m128d b0 = _mm_loadu_pd(pb + 2*i);
+                const __m128d b1 = _mm_loadu_pd(pb + 2*i + 2);
+                const __m128d ax = _mm_unpacklo_pd(a0, a1);
+                const __m128d ay = _mm_unpackhi_pd(a0, a1);
+                const __m128d bx = _mm_unpacklo_pd(b0, b1);
+                const __m128d by = _mm_unpackhi_pd(b0, b1);
+                const __m128d d = _mm_add_pd(_mm_mul_pd(ax, bx), _mm_mul_pd(ay, by));
+                const __m128d c = _mm_sub_pd(_mm_mul_pd(ax, by), _mm_mul_pd(ay, bx));
+                _mm_storeu_pd(out + i, atan2_sse2(c, d));
+            }
+            angle_scalar(a, b, out, i, n);
+        }
+
+        // Angle kernels. SSE2 has no blendv, so the selects are and/andnot/or.
+
+        __attribute__((target("sse2")))
+        __m128d normalize_angle_sse2(__m128d x)
+        {
+            const __m128d magic = _mm_set1_pd(round_magic);
+            const __m128d k = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(x, _mm_set1_pd(inv_two_pi)), magic), magic);
+            __m128d r = _mm_sub_pd(x, _mm_mul_pd(k, _mm_set1_pd(two_pi_1)));
+            r = _mm_sub_pd(r, _mm_mul_pd(k, _mm_set1_pd(two_pi_2)));
+            r = _mm_sub_pd(r, _mm_mul_pd(k, _mm_set1_pd(two_pi_3)));
+            const __m128d two_pi = _mm_set1_pd(2.0*PI);
+            const __m128d low = _mm_cmple_pd(r, _mm_set1_pd(-PI));
+            r = _mm_or_pd(_mm_and_pd(low, _mm_add_pd(r, two_pi)), _mm_andnot_pd(low, r));
+            const __m128d high = _mm_cmpgt_pd(r, _mm_set1_pd(PI));
+            return _mm_or_pd(_mm_and_pd(high, _mm_sub_pd(r, two_pi)), _mm_andnot_pd(high, r));
+        }
+
+        __attribute__((target("sse2")))
+        void normalize_angle_sse2(const double * in, double * out, std::size_t n)
+        {
+            std::size_t i = 0;
+            for(; i + 2 <= n; i += 2){
+                _mm_storeu_pd(out + i, normalize_angle_sse2(_mm_loadu_pd(in + i)));
+            }
+            normalize_angle_scalar(in, out, i, n);
+        }
+
+        __attribute__((target("avx2,fma")))
+        __m256d normalize_angle_avx2(__m256d x)
+        {
+            const __m256d magic = _mm256_set1_pd(round_magic);
+            const __m256d k = _mm256_sub_pd(_mm256_add_pd(_mm256_mul_pd(x, _mm256_set1_pd(inv_two_pi)), magic), magic);
+            __m256d r = _mm256_sub_pd(x, _mm256_mul_pd(k, _mm256_set1_pd(two_pi_1)));
+            r = _mm256_sub_pd(r, _mm256_mul_pd(k, _mm256_set1_pd(two_pi_2)));
+            r = _mm256_sub_pd(r, _mm256_mul_pd(k, _mm256_set1_pd(two_pi_3)));
+            const __m256d two_pi = _mm256_set1_pd(2.0*PI);
+            r = _mm256_blendv_pd(r, _mm256_add_pd(r, two_pi), _mm256_cmp_pd(r, _mm256_set1_pd(-PI), _CMP_LE_OQ));
+            return _mm256_blendv_pd(r, _mm256_sub_pd(r, two_pi), _mm256_cmp_pd(r, _mm256_set1_pd(PI), _CMP_GT_OQ));
+        }
+
+        __attribute__((target("avx2,fma")))
+        void normalize_angle_avx2(const double * in, double * out, std::size_t n)
+        {
+            std::size_t i = 0;
+            for(; i + 8 <= n; i += 8){
+                const __m256d r0 = normalize_angle_avx2(_mm256_loadu_pd(in + i));
+                const __m256d r1 = normalize_angle_avx2(_mm256_loadu_pd(in + i + 4));
+                _mm256_storeu_pd(out + i, r0);
+                _mm256_storeu_pd(out + i + 4, r1);
+            }
+            normalize_angle_scalar(in, out, i, n);
+        }
+
+        /// \brief out[i] = in[i]*a/b, the operation order of deg2rad() and rad2deg()
+        __attribute__((target("sse2")))
+        void scale_angles_sse2(const double * in, double * out, std::size_t n, double a, double b)
+        {
+            const __m128d va = _mm_set1_pd(a);
+            const __m128d vb = _mm_set1_pd(b);
+            std::size_t i = 0;
+            for(; i + 2 <= n; i += 2){
+                _mm_storeu_pd(out + i, _mm_div_pd(_mm_mul_pd(_mm_loadu_pd(in + i), va), vb));
+            }
+            for(; i < n; i++){
+                out[i] = in[i]*a/b;
+            }
+        }
+
+        /// \brief out[i] = in[i]*a/b, the operation order of deg2rad() and rad2deg()
+        __attribute__((target("avx2,fma")))
+        void scale_angles_avx2(const double * in, double * out, std::size_t n, double a, double b)
+        {
+            const __m256d va = _mm256_set1_pd(a);
+            const __m256d vb = _mm256_set1_pd(b);
+            std::size_t i = 0;
+            for(; i + 4 <= n; i += 4){
+                _mm256_storeu_pd(out + i, _mm256_div_pd(_mm256_mul_pd(_mm256_loadu_pd(in + i), va), vb));
+            }
+            for(; i < n; i++){
+                out[i] = in[i]*a/b;
+            }
+        }
+
+        // Single precision kernels: twice the lanes per register of the double kernels
+
+        __attribute__((target("sse2")))
+        void points_aos_sse2(const Transform2Df & tf, const Vector2Df * in, Vector2Df * out, std::size_t n)
+        {
+            const float c = tf.rotation_cos();
+            const float s = tf.rotation_sin();
+            const Vector2Df p = tf.translation();
+
+            // Two points per register: [x0 y0 x1 y1]
+            const __m128 col0 = _mm_set_ps(s, c, s, c);
+            const __m128 col1 = _mm_set_ps(c, -s, c, -s);
+            const __m128 trans = _mm_set_ps(p.y, p.x, p.y, p.x);
+
+            const float * src = reinterpret_cast<const float *>(in);
+            float * dst = reinterpret_cast<float *>(out);
+            std::size_t i = 0;
+            for(; i + 2 <= n; i += 2){
+                const __m128 v = _mm_loadu_ps(src + 2*i);
+                const __m128 xx = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0));
+                const __m128 yy = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1));
+                const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xx, col0), _mm_mul_ps(yy, col1)), trans);
+                _mm_storeu_ps(dst + 2*i, r);
+            }
+            points_aos_scalar(tf, in, out, i, n);
+        }
+
+        __attribute__((target("sse2")))
+        void points_soa_sse2(const Transform2Df & tf, const float * x_in, const float * y_in,
+                             float * x_out, float * y_out, std::size_t n)
+        {
+            const __m128 c = _mm_set1_ps(tf.rotation_cos());
+            const __m128 s = _mm_set1_ps(tf.rotation_sin());
+            const __m128 px = _mm_set1_ps(tf.translation().x);
+            const __m128 py = _mm_set1_ps(tf.translation().y);
+
+            std::size_t i = 0;
+            for(; i + 4 <= n; i += 4){
+                const __m128 x = _mm_loadu_ps(x_in + i);
+                const __m128 y = _mm_loadu_ps(y_in + i);
+                const __m128 xr = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(x, c), _mm_mul_ps(y, s)), px);
+                const __m128 yr = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, s), _mm_mul_ps(y, c)), py);
+                _mm_storeu_ps(x_out + i, xr);
+                _mm_storeu_ps(y_out + i, yr);
+            }
+            points_soa_scalar(tf, x_in, y_in, x_out, y_out, i, n);
+        }
+
+        __attribute__((target("avx2,fma")))
+        void points_aos_avx2(const Transform2Df & tf, const Vector2Df * in, Vector2Df * out, std::size_t n)
+        {
+            const float c = tf.rotation_cos();
+            const float s = tf.rotation_sin();
+            const Vector2Df p = tf.translation();
+
+            // Four points per register: [x0 y0 x1 y1 x2 y2 x3 y3]
+            const __m256 col0 = _mm256_set_ps(s, c, s, c, s, c, s, c);
+            const __m256 col1 = _mm256_set_ps(c, -s, c, -s, c, -s, c, -s);
+            const __m256 trans = _mm256_set_ps(p.y, p.x, p.y, p.x, p.y, p.x, p.y, p.x);
+
+            const float * src = reinterpret_cast<const float *>(in);
+            float * dst = reinterpret_cast<float *>(out);
+            std::size_t i = 0;
+            for(; i + 8 <= n; i += 8){
+                const __m256 v0 = _mm256_loadu_ps(src + 2*i);
+                const __m256 v1 = _mm256_loadu_ps(src + 2*i + 8);
+                const __m256 r0 = _mm256_fmadd_ps(_mm256_moveldup_ps(v0), col0,
+                                  _mm256_fmadd_ps(_mm256_movehdup_ps(v0), col1, trans));
+                const __m256 r1 = _mm256_fmadd_ps(_mm256_moveldup_ps(v1), col0,
+                                  _mm256_fmadd_ps(_mm256_movehdup_ps(v1), col1, trans));
+                _mm256_storeu_ps(dst + 2*i, r0);
+                _mm256_storeu_ps(dst + 2*i + 8, r1);
+            }
+            points_aos_scalar(tf, in, out, i, n);
+        }
+
+        __attribute__((target("avx2,fma")))
+        void points_soa_avx2(const Transform2Df & tf, const float * x_in, const float * y_in,
+                             float * x_out, float * y_out, std::size_t n)
+        {
+            const __m256 c = _mm256_set1_ps(tf.rotation_cos());
+            const __m256 s = _mm256_set1_ps(tf.rotation_sin());
+            const __m256 px = _mm256_set1_ps(tf.translation().x);
+            const __m256 py = _mm256_set1_ps(tf.translation().y);
+
+            std::size_t i = 0;
+            for(; i + 8 <= n; i += 8){
+                const __m256 x = _mm256_loadu_ps(x_in + i);
+                const __m256 y = _mm256_loadu_ps(y_in + i);
+                const __m256 xr = _mm256_fmadd_ps(x, c, _mm256_fnmadd_ps(y, s, px));
+                const __m256 yr = _mm256_fmadd_ps(x, s, _mm256_fmadd_ps(y, c, py));
+                _mm256_storeu_ps(x_out + i, xr);
+                _mm256_storeu_ps(y_out + i, yr);
+            }
+            points_soa_scalar(tf, x_in, y_in, x_out, y_out, i, n);
+        }
+
+        /// \brief split four interleaved twists, a = [w0 x0 y0 w1], b = [x1 y1 w2 x2], c = [y2 w3 x3 y3],
+        /// into w, x and y registers
+        __attribute__((target("sse2")))
+        void deinterleave_twists_sse2(__m128 a, __m128 b, __m128 c, __m128 & w, __m128 & vx, __m128 & vy)
+        {
+            w = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+            vx = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)),
+                                _MM_SHUFFLE(2, 0, 2, 0));
+            vy = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), c, _MM_SHUFFLE(3, 0, 2, 0));
+        }
+
+        /// \brief the inverse of deinterleave_twists_sse2
+        __attribute__((target("sse2")))
+        void interleave_twists_sse2(__m128 w, __m128 vx, __m128 vy, __m128 & a, __m128 & b, __m128 & c)
+        {
+            a = _mm_shuffle_ps(_mm_unpacklo_ps(w, vx), _mm_shuffle_ps(vy, w, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0));
+            b = _mm_shuffle_ps(_mm_shuffle_ps(vx, vy, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(w, vx, _MM_SHUFFLE(2, 2, 2, 2)),
+                               _MM_SHUFFLE(2, 0, 2, 0));
+            c = _mm_shuffle_ps(_mm_shuffle_ps(vy, w, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(vx, vy, _MM_SHUFFLE(3, 3, 3, 3)),
+                               _MM_SHUFFLE(2, 0, 2, 0));
+        }
+
+        /// \brief deinterleave_twists_sse2 on each 128-bit half: twists 0-3 in the low halves, 4-7 in the high
+        __attribute__((target("avx2,fma")))
+        void deinterleave_twists_avx2(__m256 a, __m256 b, __m256 c, __m256 & w, __m256 & vx, __m256 & vy)
+        {
+            w = _mm256_shuffle_ps(a, _mm256_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+            vx = _mm256_shuffle_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm256_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)),
+                                   _MM_SHUFFLE(2, 0, 2, 0));
+            vy = _mm256_shuffle_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), c, _MM_SHUFFLE(3, 0, 2, 0));
+        }
+
+        /// \brief the inverse of deinterleave_twists_avx2
+        __attribute__((target("avx2,fma")))
+        void interleave_twists_avx2(__m256 w, __m256 vx, __m256 vy, __m256 & a, __m256 & b, __m256 & c)
+        {
+            a = _mm256_shuffle_ps(_mm256_unpacklo_ps(w, vx), _mm256_shuffle_ps(vy, w, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0));
+            b = _mm256_shuffle_ps(_mm256_shuffle_ps(vx, vy, _MM_SHUFFLE(1, 1, 1, 1)), _mm256_shuffle_ps(w, vx, _MM_SHUFFLE(2, 2, 2, 2)),
+                                  _MM_SHUFFLE(2, 0, 2, 0));
+            c = _mm256_shuffle_ps(_mm256_shuffle_ps(vy, w, _MM_SHUFFLE(3, 3, 2, 2)), _mm256_shuffle_ps(vx, vy, _MM_SHUFFLE(3, 3, 3, 3)),
+                                  _MM_SHUFFLE(2, 0, 2, 0));
+        }
+
+        __attribute__((target("sse2")))
+        void twists_sse2(const Transform2Df & tf, const Twist2Df * in, Twist2Df * out, std::size_t n)
+        {
+            const __m128 c = _mm_set1_ps(tf.rotation_cos());
+            const __m128 s = _mm_set1_ps(tf.rotation_sin());
+            const __m128 px = _mm_set1_ps(tf.translation().x);
+            const __m128 py = _mm_set1_ps(tf.translation().y);
+
+            // Four twists are twelve floats, three registers; the operations are those of the scalar code
+            const float * src = reinterpret_cast<const float *>(in);
+            float * dst = reinterpret_cast<float *>(out);
+            std::size_t i = 0;
+            for(; i + 4 <= n; i += 4){
+                __m128 w, vx, vy;
+                deinterleave_twists_sse2(_mm_loadu_ps(src + 3*i), _mm_loadu_ps(src + 3*i + 4), _mm_loadu_ps(src + 3*i + 8),
+                                         w, vx, vy);
+                const __m128 rx = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(py, w), _mm_mul_ps(c, vx)), _mm_mul_ps(s, vy));
+                const __m128 ry = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(s, vx), _mm_mul_ps(px, w)), _mm_mul_ps(c, vy));
+                __m128 a, b, d;
+                interleave_twists_sse2(w, rx, ry, a, b, d);
+                _mm_storeu_ps(dst + 3*i, a);
+                _mm_storeu_ps(dst + 3*i + 4, b);
+                _mm_storeu_ps(dst + 3*i + 8, d);
+            }
+            twists_scalar(tf, in, out, i, n);
+        }
+
+        __attribute__((target("avx2,fma")))
+        void twists_avx2(const Transform2Df & tf, const Twist2Df * in, Twist2Df * out, std::size_t n)
+        {
+            const __m256 c = _mm256_set1_ps(tf.rotation_cos());
+            const __m256 s = _mm256_set1_ps(tf.rotation_sin());
+            const __m256 px = _mm256_set1_ps(tf.translation().x);
+            const __m256 py = _mm256_set1_ps(tf.translation().y);
+
+            // Eight twists: twists 0-3 in the low halves of the registers, 4-7 in the high halves
+            const float * src = reinterpret_cast<const float *>(in);
+            float * dst = reinterpret_cast<float *>(out);
+            std::size_t i = 0;
+            for(; i + 8 <= n; i += 8){
+                const float * p = src + 3*i;
+                __m256 w, vx, vy;
+                deinterleave_twists_avx2(_mm256_loadu2_m128(p + 12, p), _mm256_loadu2_m128(p + 16, p + 4),
+                                         _mm256_loadu2_m128(p + 20, p + 8), w, vx, vy);
+                const __m256 rx = _mm256_fmadd_ps(py, w, _mm256_fmsub_ps(c, vx, _mm256_mul_ps(s, vy)));
+                const __m256 ry = _mm256_fmadd_ps(s, vx, _mm256_fmsub_ps(c, vy, _mm256_mul_ps(px, w)));
+                __m256 a, b, d;
+                interleave_twists_avx2(w, rx, ry, a, b, d);
+                float * q = dst + 3*i;
+                _mm256_storeu2_m128(q + 12, q, a);
+                _mm256_storeu2_m128(q + 16, q + 4, b);
+                _mm256_storeu2_m128(q + 20, q + 8, d);
+            }
+            twists_scalar(tf, in, out, i, n);
+        }
+
+        // Single precision vector kernels: normalize, magnitude and the float cross and dot of
+        // angle use the same operations as the scalar code (no FMA), so give the same bits.
+
+        /// \brief split four interleaved vectors into x and y registers, in order
+        __attribute__((target("sse2")))
+        void deinterleave_sse2(const float * src, __m128 & x, __m128 & y)
+        {
+            const __m128 v0 = _mm_loadu_ps(src);
+            const __m128 v1 = _mm_loadu_ps(src + 4);
+            x = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+            y = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+        }
+
+        __attribute__((target("sse2")))
+        void normalize_sse2(const Vector2Df * in, Vector2Df * out, std::size_t n)
+        {
+            const float * src = reinterpret_cast<const float *>(in);
+            float * dst = reinterpret_cast<float *>(out);
+            const __m128 one = _mm_set1_ps(1.0f);
+            std::size_t i = 0;
+            for(; i + 4 <= n; i += 4){
+                __m128 x, y;
+                deinterleave_sse2(src + 2*i, x, y);
+                const __m128 inv = _mm_div_ps(one, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y))));
+                const __m128 xn = _mm_mul_ps(x, inv);
+                const __m128 yn = _mm_mul_ps(y, inv);
+                _mm_storeu_ps(dst + 2*i, _mm_unpacklo_ps(xn, yn));
+                _mm_storeu_ps(dst + 2*i + 4, _mm_unpackhi_ps(xn, yn));
+            }
+            normalize_scalar(in, out, i, n);
+        }
+
+        __attribute__((target("sse2")))
+        void magnitude_sse2(const Vector2Df * in, float * out, std::size_t n)
+        {
+            const float * src = reinterpret_cast<const float *>(in);
+            std::size_t i = 0;
+            for(; i + 4 <= n; i += 4){
+                __m128 x, y;
+                deinterleave_sse2(src + 2*i, x, y);
+                _mm_storeu_ps(out + i, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y))));
+            }
+            magnitude_scalar(in, out, i, n);
+        }
+
+        __attribute__((target("sse2")))
+        void dot_sse2(const Vector2Df * a, const Vector2Df * b, float * out, std::size_t n)
+        {
+            const float * pa = reinterpret_cast<const float *>(a);
+            const float * pb = reinterpret_cast<const float *>(b);
+            std::size_t i = 0;
+            for(; i + 4 <= n; i += 4){
+                __m128 ax, ay, bx, by;
+                deinterleave_sse2(pa + 2*i, ax, ay);
+                deinterleave_sse2(pb + 2*i, bx, by);
+                _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)));
+            }
+            dot_scalar(a, b, out, i, n);
+        }
+
+        /// \brief split eight interleaved vectors into x and y registers
+        /// The lanes come out in the order [0 1 4 5 2 3 6 7]; unpacking them again restores [x y] pairs.
+        __attribute__((target("avx2,fma")))
+        void deinterleave_avx2(const float * src, __m256 & x, __m256 & y)
+        {
+            const __m256 v0 = _mm256_loadu_ps(src);
+            const __m256 v1 = _mm256_loadu_ps(src + 8);
+            x = _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+            y = _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+        }
+
+        /// \brief put eight lanes in the order [0 1 4 5 2 3 6 7] back in order
+        __attribute__((target("avx2,fma")))
+        __m256 in_order_avx2(__m256 v)
+        {
+            return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(v), 0xD8));
+        }
+
+        __attribute__((target("avx2,fma")))
+        void normalize_avx2(const Vector2Df * in, Vector2Df * out, std::size_t n)
+        {
+            const float * src = reinterpret_cast<const float *>(in);
+            float * dst = reinterpret_cast<float *>(out);
+            const __m256 one = _mm256_set1_ps(1.0f);
+            std::size_t i = 0;
+            for(; i + 8 <= n; i += 8){
+                __m256 x, y;
+                deinterleave_avx2(src + 2*i, x, y);
+                const __m256 inv = _mm256_div_ps(one, _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y))));
+                const __m256 xn = _mm256_mul_ps(x, inv);
+                const __m256 yn = _mm256_mul_ps(y, inv);
+                _mm256_storeu_ps(dst + 2*i, _mm256_unpacklo_ps(xn, yn));
+                _mm256_storeu_ps(dst + 2*i + 8, _mm256_unpackhi_ps(xn, yn));
+            }
+            normalize_scalar(in, out, i, n);
+        }
+
+        __attribute__((target("avx2,fma")))
+        void magnitude_avx2(const Vector2Df * in, float * out, std::size_t n)
+        {
+            const float * src = reinterpret_cast<const float *>(in);
+            std::size_t i = 0;
+            for(; i + 8 <= n; i += 8){
+                __m256 x, y;
+                deinterleave_avx2(src + 2*i, x, y);
+                const __m256 m = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)));
+                _mm256_storeu_ps(out + i, in_order_avx2(m));
+            }
+            magnitude_scalar(in, out, i, n);
+        }
+
+        __attribute__((target("avx2,fma")))
+        void dot_avx2(const Vector2Df * a, const Vector2Df * b, float * out, std::size_t n)
+        {
+            const float * pa = reinterpret_cast<const float *>(a);
+            const float * pb = reinterpret_cast<const float *>(b);
+            std::size_t i = 0;
+            for(; i + 8 <= n; i += 8){
+                __m256 ax, ay, bx, by;
+                deinterleave_avx2(pa + 2*i, ax, ay);
+                deinterleave_avx2(pb + 2*i, bx, by);
+                const __m256 d = _mm256_fmadd_ps(ax, bx, _mm256_mul_ps(ay, by));
+                _mm256_storeu_ps(out + i, in_order_avx2(d));
+            }
+            dot_scalar(a, b, out, i, n);
+        }
+
+        /// \brief the float cross and dot are widened to double for atan2_avx2, and the angles
+        /// rounded back to float, which is well within the accuracy of std::atan2 for floats
+        __attribute__((target("avx2,fma")))
+        void angle_avx2(const Vector2Df * a, const Vector2Df * b, float * out, std::size_t n)
+        {
+            const float * pa = reinterpret_cast<const float *>(a);
+            const float * pb = reinterpret_cast<const float *>(b);
+            std::size_t i = 0;
+            for(; i + 8 <= n; i += 8){
+                __m256 ax, ay, bx, by;
+                deinterleave_avx2(pa + 2*i, ax, ay);
+                deinterleave_avx2(pb + 2*i, bx, by);
+                const __m256 d = in_order_avx2(_mm256_add_ps(_mm256_mul_ps(ax, bx), _mm256_mul_ps(ay, by)));
+                const __m256 c = in_order_avx2(_mm256_sub_ps(_mm256_mul_ps(ax, by), _mm256_mul_ps(ay, bx)));
+                const __m256d lo = atan2_avx2(_mm256_cvtps_pd(_mm256_castps256_ps128(c)),
+                                              _mm256_cvtps_pd(_mm256_castps256_ps128(d)));
+                const __m256d hi = atan2_avx2(_mm256_cvtps_pd(_mm256_extractf128_ps(c, 1)),
+                                              _mm256_cvtps_pd(_mm256_extractf128_ps(d, 1)));
+                _mm_storeu_ps(out + i, _mm256_cvtpd_ps(lo));
+                _mm_storeu_ps(out + i + 4, _mm256_cvtpd_ps(hi));
+            }
+            angle_scalar(a, b, out, i, n);
+        }
+
+        __attribute__((target("sse2")))
+        void angle_sse2(const Vector2Df * a, const Vector2Df * b, float * out, std::size_t n)
+        {
+            const float * pa = reinterpret_cast<const float *>(a);
+            const float * pb = reinterpret_cast<const float *>(b);
+            std::size_t i = 0;
+            for(; i + 4 <= n; i += 4){
+                __m128 ax, ay, bx, by;
+                deinterleave_sse2(pa + 2*i, ax, ay);
+                deinterleave_sse2(pb + 2*i, bx, by);
+                const __m128 d = _mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by));
+                const __m128 c = _mm_sub_ps(_mm_mul_ps(ax, by), _mm_mul_ps(ay, bx));
+                const __m128d lo = atan2_sse2(_mm_cvtps_pd(c), _mm_cvtps_pd(d));
+                const __m128d hi = atan2_sse2(_mm_cvtps_pd(_mm_movehl_ps(c, c)), _mm_cvtps_pd(_mm_movehl_ps(d, d)));
+                _mm_storeu_ps(out + i, _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi)));
+            }
+            angle_scalar(a, b, out, i, n);
+        }
+
+        // Single precision angle kernels: the scalar functions compute in double and round to
+        // float, so these widen four floats, run the double kernels and round back, to the bit.
+
+        __attribute__((target("sse2")))
+        void normalize_angle_sse2(const float * in, float * out, std::size_t n)
+        {
+            std::size_t i = 0;
+            for(; i + 4 <= n; i += 4){
+                const __m128 v = _mm_loadu_ps(in + i);
+                const __m128 lo = _mm_cvtpd_ps(normalize_angle_sse2(_mm_cvtps_pd(v)));
+                const __m128 hi = _mm_cvtpd_ps(normalize_angle_sse2(_mm_cvtps_pd(_mm_movehl_ps(v, v))));
+                _mm_storeu_ps(out + i, _mm_movelh_ps(lo, hi));
+            }
+            normalize_angle_scalar(in, out, i, n);
+        }
+
+        __attribute__((target("avx2,fma")))
+        void normalize_angle_avx2(const float * in, float * out, std::size_t n)
+        {
+            std::size_t i = 0;
+            for(; i + 8 <= n; i += 8){
+                const __m128 r0 = _mm256_cvtpd_ps(normalize_angle_avx2(_mm256_cvtps_pd(_mm_loadu_ps(in + i))));
+                const __m128 r1 = _mm256_cvtpd_ps(normalize_angle_avx2(_mm256_cvtps_pd(_mm_loadu_ps(in + i + 4))));
+                _mm_storeu_ps(out + i, r0);
+                _mm_storeu_ps(out + i + 4, r1);
+            }
+            normalize_angle_scalar(in, out, i, n);
+        }
+
+        /// \brief out[i] = float(double(in[i])*a/b), the operation order of deg2rad() and rad2deg()
+        __attribute__((target("sse2")))
+        void scale_angles_sse2(const float * in, float * out, std::size_t n, double a, double b)
+        {
+            const __m128d va = _mm_set1_pd(a);
+            const __m128d vb = _mm_set1_pd(b);
+            std::size_t i = 0;
+            for(; i + 4 <= n; i += 4){
+                const __m128 v = _mm_loadu_ps(in + i);
+                const __m128d lo = _mm_div_pd(_mm_mul_pd(_mm_cvtps_pd(v), va), vb);
+                const __m128d hi = _mm_div_pd(_mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(v, v)), va), vb);
+                _mm_storeu_ps(out + i, _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi)));
+            }
+            for(; i < n; i++){
+                out[i] = static_cast<float>(static_cast<double>(in[i])*a/b);
+            }
+        }
+
+        /// \brief out[i] = float(double(in[i])*a/b), the operation order of deg2rad() and rad2deg()
+        __attribute__((target("avx2,fma")))
+        void scale_angles_avx2(const float * in, float * out, std::size_t n, double a, double b)
+        {
+            const __m256d va = _mm256_set1_pd(a);
+            const __m256d vb = _mm256_set1_pd(b);
+            std::size_t i = 0;
+            for(; i + 4 <= n; i += 4){
+                const __m256d v = _mm256_cvtps_pd(_mm_loadu_ps(in + i));
+                _mm_storeu_ps(out + i, _mm256_cvtpd_ps(_mm256_div_pd(_mm256_mul_pd(v, va), vb)));
+            }
+            for(; i < n; i++){
+                out[i] = static_cast<float>(static_cast<double>(in[i])*a/b);
+            }
+        }
+
+#endif
+    }
+
+    SimdLevel detected_simd_level(){
+        static const SimdLevel level = detect();
+        return level;
+    }
+
+    SimdLevel simd_level(){
+        return active_level().load(std::memory_order_relaxed);
+    }
+
+    SimdLevel set_simd_level(SimdLevel level){
+        if(static_cast<int>(level) > static_cast<int>(detected_simd_level())){
+            level = detected_simd_level();
+        }
+        active_level().store(level, std::memory_order_relaxed);
+        return level;
+    }
+
+    const char * to_string(SimdLevel level){
+        switch(level){
+            case SimdLevel::avx2: return "avx2";
+            case SimdLevel::sse2: return "sse2";
+            default: return "scalar";
+        }
+    }
+
+    void transform_points(const Transform2D & tf, const Vector2D * in, Vector2D * out, std::size_t n){
+        switch(simd_level()){
+#ifdef TURTLELIB_X86
+            case SimdLevel::avx2: points_aos_avx2(tf, in, out, n); return;
+            case SimdLevel::sse2: points_aos_sse2(tf, in, out, n); return;
+#endif
+            default: points_aos_scalar(tf, in, out, 0, n); return;
+        }
+    }
+
+    void transform_points(const Transform2D & tf, const double * x_in, const double * y_in,
+                          double * x_out, double * y_out, std::size_t n){
+        switch(simd_level()){
+#ifdef TURTLELIB_X86
+            case SimdLevel::avx2: points_soa_avx2(tf, x_in, y_in, x_out, y_out, n); return;
+            case SimdLevel::sse2: points_soa_sse2(tf, x_in, y_in, x_out, y_out, n); return;
+#endif
+            default: points_soa_scalar(tf, x_in, y_in, x_out, y_out, 0, n); return;
+        }
+    }
+
+    void transform_twists(const Transform2D & tf, const Twist2D * in, Twist2D * out, std::size_t n){
+        switch(simd_level()){
+#ifdef TURTLELIB_X86
+            case SimdLevel::avx2: twists_avx2(tf, in, out, n); return;
+            case SimdLevel::sse2: twists_sse2(tf, in, out, n); return;
+#endif
+            default: twists_scalar(tf, in, out, 0, n); return;
+        }
+    }
+
+    void transform_points(const Transform2Df & tf, const Vector2Df * in, Vector2Df * out, std::size_t n){
+        switch(simd_level()){
+#ifdef TURTLELIB_X86
+            case SimdLevel::avx2: points_aos_avx2(tf, in, out, n); return;
+            case SimdLevel::sse2: points_aos_sse2(tf, in, out, n); return;
+#endif
+            default: points_aos_scalar(tf, in, out, 0, n); return;
+        }
+    }
+
+    void transform_points(const Transform2Df & tf, const float * x_in, const float * y_in,
+                          float * x_out, float * y_out, std::size_t n){
+        switch(simd_level()){
+#ifdef TURTLELIB_X86
+            case SimdLevel::avx2: points_soa_avx2(tf, x_in, y_in, x_out, y_out, n); return;
+            case SimdLevel::sse2: points_soa_sse2(tf, x_in, y_in, x_out, y_out, n); return;
+#endif
+            default: points_soa_scalar(tf, x_in, y_in, x_out, y_out, 0, n); return;
+        }
+    }
+
+    void transform_twists(const Transform2Df & tf, const Twist2Df * in, Twist2Df * out, std::size_t n){
+        switch(simd_level()){
+#ifdef TURTLELIB_X86
+            case SimdLevel::avx2: twists_avx2(tf, in, out, n); return;
+            case SimdLevel::sse2: twists_sse2(tf, in, out, n); return;
+#endif
+            default: twists_scalar(tf, in, out, 0, n); return;
+        }
+    }
+
+    void normalize(const Vector2D * in, Vector2D * out, std::size_t n){
+        switch(simd_level()){
+#ifdef TURTLELIB_X86
+            case SimdLevel::avx2: normalize_avx2(in, out, n); return;
+            case SimdLevel::sse2: normalize_sse2(in, out, n); return;
+#endif
+            default: normalize_scalar(in, out, 0, n); return;
+        }
+    }
+
+    void magnitude(const Vector2D * in, double * out, std::size_t n){
+        switch(simd_level()){
+#ifdef TURTLELIB_X86
+            case SimdLevel::avx2: magnitude_avx2(in, out, n); return;
+            case SimdLevel::sse2: magnitude_sse2(in, out, n); return;
+#endif
+            default: magnitude_scalar(in, out, 0, n); return;
+        }
+    }
+
+    void dot(const Vector2D * a, const Vector2D * b, double * out, std::size_t n){
+        switch(simd_level()){
+#ifdef TURTLELIB_X86
+            case SimdLevel::avx2: dot_avx2(a, b, out, n); return;
+            case SimdLevel::sse2: dot_sse2(a, b, out, n); return;
+#endif
+            default: dot_scalar(a, b, out, 0, n); return;
+        }
+    }
+
+    void angle(const Vector2D * a, const Vector2D * b, double * out, std::size_t n){
+        switch(simd_level()){
+#ifdef TURTLELIB_X86
+            case SimdLevel::avx2: angle_avx2(a, b, out, n); return;
+            case SimdLevel::sse2: angle_sse2(a, b, out, n); return;
+#endif
+            default: angle_scalar(a, b, out, 0, n); return;
+        }
+    }
+
+    void normalize(const Vector2Df * in, Vector2Df * out, std::size_t n){
+        switch(simd_level()){
+#ifdef TURTLELIB_X86
+            case SimdLevel::avx2: normalize_avx2(in, out, n); return;
+            case SimdLevel::sse2: normalize_sse2(in, out, n); return;
+#endif
+            default: normalize_scalar(in, out, 0, n); return;
+        }
+    }
+
+    void magnitude(const Vector2Df * in, float * out, std::size_t n){
+        switch(simd_level()){
+#ifdef TURTLELIB_X86
+            case SimdLevel::avx2: magnitude_avx2(in, out, n); return;
+            case SimdLevel::sse2: magnitude_sse2(in, out, n); return;
+#endif
+            default: magnitude_scalar(in, out, 0, n); return;
+        }
+    }
+
+    void dot(const Vector2Df * a, const Vector2Df * b, float * out, std::size_t n){
+        switch(simd_level()){
+#ifdef TURTLELIB_X86
+            case SimdLevel::avx2: dot_avx2(a, b, out, n); return;
+            case SimdLevel::sse2: dot_sse2(a, b, out, n); return;
+#endif
+            default: dot_scalar(a, b, out, 0, n); return;
+        }
+    }
+
+    void angle(const Vector2Df * a, const Vector2Df * b, float * out, std::size_t n){
+        switch(simd_level()){
+#ifdef TURTLELIB_X86
+            case SimdLevel::avx2: angle_avx2(a, b, out, n); return;
+            case SimdLevel::sse2: angle_sse2(a, b, out, n); return;
+#endif
+            default: angle_scalar(a, b, out, 0, n); return;
+        }
+    }
+
+    void normalize_angle(const double * in, double * out, std::size_t n){
+        switch(simd_level()){
+#ifdef TURTLELIB_X86
+            case SimdLevel::avx2: normalize_angle_avx2(in, out, n); return;
+            case SimdLevel::sse2: normalize_angle_sse2(in, out, n); return;
+#endif
+            default: normalize_angle_scalar(in, out, 0, n); return;
+        }
+    }
+
+    void deg2rad(const double * in, double * out, std::size_t n){
+        switch(simd_level()){
+#ifdef TURTLELIB_X86
+            case SimdLevel::avx2: scale_angles_avx2(in, out, n, PI, 180.0); return;
+            case SimdLevel::sse2: scale_angles_sse2(in, out, n, PI, 180.0); return;
+#endif
+            default: deg2rad_scalar(in, out, 0, n); return;
+        }
+    }
+
+    void rad2deg(const double * in, double * out, std::size_t n){
+        switch(simd_level()){
+#ifdef TURTLELIB_X86
+            case SimdLevel::avx2: scale_angles_avx2(in, out, n, 180.0, PI); return;
+            case SimdLevel::sse2: scale_angles_sse2(in, out, n, 180.0, PI); return;
+#endif
+            default: rad2deg_scalar(in, out, 0, n); return;
+        }
+    }
+
+    void normalize_angle(const float * in, float * out, std::size_t n){
+        switch(simd_level()){
+#ifdef TURTLELIB_X86
+            case SimdLevel::avx2: normalize_angle_avx2(in, out, n); return;
+            case SimdLevel::sse2: normalize_angle_sse2(in, out, n); return;
+#endif
+            default: normalize_angle_scalar(in, out, 0, n); return;
+        }
+    }
+
+    void deg2rad(const float * in, float * out, std::size_t n){
+        switch(simd_level()){
+#ifdef TURTLELIB_X86
+            case SimdLevel::avx2: scale_angles_avx2(in, out, n, PI, 180.0); return;
+            case SimdLevel::sse2: scale_angles_sse2(in, out, n, PI, 180.0); return;
+#endif
+            default: deg2rad_scalar(in, out, 0, n); return;
+        }
+    }
+
+    void rad2deg(const float * in, float * out, std::size_t n){
+        switch(simd_level()){
+#ifdef TURTLELIB_X86
+            case SimdLevel::avx2: scale_angles_avx2(in, out, n, 180.0, PI); return;
+            case SimdLevel::sse2: scale_angles_sse2(in, out, n, 180.0, PI); return;
+#endif
+            default: rad2deg_scalar(in, out, 0, n); return;
+        }
+    }
+
+    void integrate_twists(const Twist2D * twists, Transform2D * out, std::size_t n, double dt){
+        integrate_twists_scalar(twists, out, n, dt);
+    }
+
+    void integrate_twists(const Twist2Df * twists, Transform2Df * out, std::size_t n, float dt){
+        integrate_twists_scalar(twists, out, n, dt);
+    }
+
+    void integrate_twist_sequence(const Transform2D & start, const Twist2D * twists,
+                                  Transform2D * poses, std::size_t n, double dt){
+        integrate_sequence_scalar(start, twists, poses, n, dt);
+    }
+
+    void integrate_twist_sequence(const Transform2Df & start, const Twist2Df * twists,
+                                  Transform2Df * poses, std::size_t n, float dt){
+        integrate_sequence_scalar(start, twists, poses, n, dt);
+    }
+
+}
@@ -0,0 +1,134 @@
+#include "turtlelib/frame_graph.hpp"
+#include <algorithm>
+
+/// \file
+/// \brief Implementation file for the frame graph
+
+namespace turtlelib
+{
+    FrameGraph::FrameGraph(const FrameGraph & other)
+        : frames(other.frames), names(other.names), path(other.path)
+    {
+        // The keys of other.ids view other's names, so index the copied names instead
+        ids.reserve(names.size());
+        for(FrameId id = 0; id < names.size(); id++){
+            ids.emplace(names[id], id);
+        }
+    }
+
+    FrameGraph & FrameGraph::operator=(const FrameGraph & other){
+        if(this != &other){
+            *this = FrameGraph(other);
+        }
+        return *this;
+    }
+
+    FrameId FrameGraph::intern(std::string_view name){
+        const auto found = ids.find(name);
+        if(found != ids.end()){
+            return found->second;
+        }
+        const FrameId id = static_cast<FrameId>(names.size());
+        names.emplace_back(name);
+        ids.emplace(names.back(), id);
+        frames.emplace_back();
+        return id;
+    }
+
+    FrameId FrameGraph::find(std::string_view name) const{
+        const auto found = ids.find(name);
+        return found == ids.end() ? no_frame : found->second;
+    }
+
+    std::errc FrameGraph::set_transform(FrameId parent, FrameId child, const Transform2D & tf){
+        if(parent >= frames.size() || child >= frames.size()){
+            return std::errc::invalid_argument;
+        }
+
+        // Moving to a new parent: refuse cycles, then move the child between children lists
+        const FrameId previous = frames[child].parent;
+        if(previous != parent){
+            for(FrameId f = parent; f != no_frame; f = frames[f].parent){
+                if(f == child){
+                    return std::errc::invalid_argument;
+                }
+            }
+            if(previous != no_frame){
+                std::vector<FrameId> & siblings = frames[previous].children;
+                siblings.erase(std::find(siblings.begin(), siblings.end(), child));
+            }
+            frames[parent].children.push_back(child);
+            frames[child].parent = parent;
+        }
+
+        frames[child].edge = tf;
+        invalidate(child);
+        return std::errc{};
+    }
+
+    std::errc FrameGraph::set_transform(std::string_view parent, std::string_view child, const Transform2D & tf){
+        const FrameId p = intern(parent);
+        return set_transform(p, intern(child), tf);
+    }
+
+    std::errc FrameGraph::lookup(FrameId a, FrameId b, Transform2D & tf) const{
+        if(a >= frames.size() || b >= frames.size()){
+            return std::errc::invalid_argument;
+        }
+        if(a == b){
+            tf = Transform2D{};
+            return std::errc{};
+        }
+
+        // resolve() does not reallocate frames, so both references stay valid
+        const Frame & fa = resolve(a);
+        const Frame & fb = resolve(b);
+        if(fa.root != fb.root){
+            return std::errc::no_link;
+        }
+        tf = fa.from_root.inv()*fb.from_root;
+        return std::errc{};
+    }
+
+    std::errc FrameGraph::lookup(std::string_view a, std::string_view b, Transform2D & tf) const{
+        return lookup(find(a), find(b), tf);
+    }
+
+    const FrameGraph::Frame & FrameGraph::resolve(FrameId id) const{
+        // Climb to the first frame with a valid cache (or past the root), then compose down
+        path.clear();
+        for(FrameId f = id; f != no_frame && !frames[f].valid; f = frames[f].parent){
+            path.push_back(f);
+        }
+        for(auto f = path.rbegin(); f != path.rend(); ++f){
+            Frame & frame = frames[*f];
+            if(frame.parent == no_frame){
+                frame.from_root = Transform2D{};
+                frame.root = *f;
+            } else {
+                const Frame & parent = frames[frame.parent];
+                frame.from_root = parent.from_root*frame.edge;
+                frame.root = parent.root;
+            }
+            frame.valid = true;
+        }
+        return frames[id];
+    }
+
+    void FrameGraph::invalidate(FrameId id){
+        // An invalid frame has only invalid descendants, so invalid subtrees are skipped whole
+        path.clear();
+        path.push_back(id);
+        while(!path.empty()){
+            Frame & frame = frames[path.back()];
+            path.pop_back();
+            if(!frame.valid){
+                continue;
+            }
+            frame.valid = false;
+            for(const FrameId child : frame.children){
+                path.push_back(child);
+            }
+        }
+    }
+}
@@ -0,0 +1,421 @@
+#include "turtlelib/pose_codec.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+/// \file
+/// \brief Implementation file for the pose stream codec
+
+namespace turtlelib
+{
+    namespace
+    {
+        constexpr char magic[8] = {'T', 'L', 'P', 'C', 'O', 'D', 'E', 'C'};
+        constexpr std::uint32_t codec_version = 1;
+        constexpr std::size_t header_size = 32;
+        constexpr std::size_t footer_size = 16;
+
+        /// \brief quantized fields per pose: stamp, theta, x, y
+        constexpr std::size_t fields = 4;
+
+        /// \brief quantized coordinates are kept within the range doubles hold exactly
+        constexpr double max_quanta = 9007199254740992.0;
+
+        void put_u32(std::vector<std::uint8_t> & out, std::uint32_t v)
+        {
+            std::uint8_t b[sizeof(v)];
+            std::memcpy(b, &v, sizeof(v));
+            out.insert(out.end(), b, b + sizeof(v));
+        }
+
+        void put_u64(std::vector<std::uint8_t> & out, std::uint64_t v)
+        {
+            std::uint8_t b[sizeof(v)];
+            std::memcpy(b, &v, sizeof(v));
+            out.insert(out.end(), b, b + sizeof(v));
+        }
+
+        void put_double(std::vector<std::uint8_t> & out, double v)
+        {
+            std::uint64_t bits;
+            std::memcpy(&bits, &v, sizeof(v));
+            put_u64(out, bits);
+        }
+
+        template<class T>
+        T get(const std::uint8_t * p)
+        {
+            T v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        /// \brief append an unsigned LEB128 varint
+        void put_varint(std::vector<std::uint8_t> & out, std::uint64_t v)
+        {
+            while(v >= 0x80){
+                out.push_back(static_cast<std::uint8_t>(v) | 0x80);
+                v >>= 7;
+            }
+            out.push_back(static_cast<std::uint8_t>(v));
+        }
+
+        /// \brief read a varint
+        /// \return the byte after it, or nullptr if it runs past last or is too long
+        const std::uint8_t * get_varint(const std::uint8_t * p, const std::uint8_t * last, std::uint64_t & v)
+        {
+            v = 0;
+            for(unsigned shift = 0; p != last && shift < 64; shift += 7){
+                const std::uint8_t b = *p++;
+                v |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+                if(!(b & 0x80)){
+                    return p;
+                }
+            }
+            return nullptr;
+        }
+
+        /// \brief map a two's complement difference to an unsigned value that is small when it is near zero
+        std::uint64_t zigzag(std::uint64_t v)
+        {
+            return (v << 1) ^ (0 - (v >> 63));
+        }
+
+        /// \brief the inverse of zigzag
+        std::uint64_t unzigzag(std::uint64_t z)
+        {
+            return (z >> 1) ^ (0 - (z & 1));
+        }
+
+        /// \brief the number of bits needed to hold v
+        unsigned bit_width(std::uint64_t v)
+        {
+            return v == 0 ? 0 : 64 - __builtin_clzll(v);
+        }
+
+        /// \brief packs values of a fixed bit width, least significant bit first
+        class BitWriter
+        {
+        public:
+            explicit BitWriter(std::vector<std::uint8_t> & out)
+                : out(out)
+            {
+            }
+
+            /// \brief append the low w bits of v; the other bits of v must be zero
+            void put(std::uint64_t v, unsigned w)
+            {
+                if(w == 0){
+                    return;
+                }
+                acc |= v << used;
+                if(used + w >= 64){
+                    put_u64(out, acc);
+                    acc = used == 0 ? 0 : v >> (64 - used);
+                    used = used + w - 64;
+                } else {
+                    used += w;
+                }
+            }
+
+            /// \brief write the partial last word, padded to a whole byte
+            void finish()
+            {
+                for(; used > 0; used = used > 8 ? used - 8 : 0){
+                    out.push_back(static_cast<std::uint8_t>(acc));
+                    acc >>= 8;
+                }
+            }
+
+        private:
+            std::vector<std::uint8_t> & out;
+            std::uint64_t acc = 0;
+            unsigned used = 0;
+        };
+
+        /// \brief read w bits starting at bit pos of p
+        /// Reads up to 9 bytes from the byte holding bit pos; the footer after the last block
+        /// keeps that inside the stream.
+        std::uint64_t get_bits(const std::uint8_t * p, std::uint64_t pos, unsigned w)
+        {
+            const std::uint8_t * q = p + pos/8;
+            const unsigned shift = pos%8;
+            std::uint64_t v = get<std::uint64_t>(q) >> shift;
+            if(shift + w > 64){
+                v |= static_cast<std::uint64_t>(q[8]) << (64 - shift);
+            }
+            return w == 64 ? v : v & ((std::uint64_t{1} << w) - 1);
+        }
+    }
+
+    PoseEncoder::PoseEncoder(const PoseCodecConfig & config)
+        : config(config)
+    {
+        this->config.block_size = std::max<std::uint32_t>(config.block_size, 1);
+        block.reserve(fields*this->config.block_size);
+        out.insert(out.end(), magic, magic + sizeof(magic));
+        put_u32(out, codec_version);
+        put_u32(out, this->config.block_size);
+        put_double(out, this->config.position_resolution);
+        put_double(out, this->config.angle_resolution);
+    }
+
+    std::errc PoseEncoder::append(const StampedPose & pose){
+        if(finished || std::isnan(pose.theta) || std::isnan(pose.x) || std::isnan(pose.y)){
+            return std::errc::invalid_argument;
+        }
+
+        //Count whole turns, so the heading is continuous and its differences stay small
+        std::int64_t turns_now = turns;
+        if(count > 0){
+            const double step = pose.theta - prev_theta;
+            if(step > PI){
+                turns_now--;
+            } else if(step < -PI){
+                turns_now++;
+            }
+        }
+
+        const double quanta[fields - 1] = {(pose.theta + 2.0*PI*turns_now)/config.angle_resolution,
+                                           pose.x/config.position_resolution,
+                                           pose.y/config.position_resolution};
+        std::uint64_t q[fields] = {static_cast<std::uint64_t>(pose.stamp_ns)};
+        for(std::size_t f = 1; f < fields; f++){
+            if(!(std::abs(quanta[f - 1]) <= max_quanta)){
+                return std::errc::value_too_large;
+            }
+            q[f] = static_cast<std::uint64_t>(std::llround(quanta[f - 1]));
+        }
+
+        block.insert(block.end(), q, q + fields);
+        prev_theta = pose.theta;
+        turns = turns_now;
+        count++;
+        if(block.size() == fields*config.block_size){
+            flush_block();
+        }
+        return std::errc{};
+    }
+
+    std::errc PoseEncoder::append(const StampedPose * poses, std::size_t n){
+        for(std::size_t i = 0; i < n; i++){
+            const std::errc ec = append(poses[i]);
+            if(ec != std::errc{}){
+                return ec;
+            }
+        }
+        return std::errc{};
+    }
+
+    void PoseEncoder::flush_block(){
+        const std::size_t n = block.size()/fields;
+        offsets.push_back(out.size());
+
+        //The first pose in full, then the first difference
+        for(std::size_t f = 0; f < fields; f++){
+            put_u64(out, block[f]);
+        }
+        if(n >= 2){
+            for(std::size_t f = 0; f < fields; f++){
+                put_varint(out, zigzag(block[fields + f] - block[f]));
+            }
+        }
+
+        //Then the second differences, bit-packed one field after another
+        if(n >= 3){
+            auto second_difference = [&](std::size_t i, std::size_t f){
+                return zigzag(block[fields*i + f] - 2*block[fields*(i - 1) + f] + block[fields*(i - 2) + f]);
+            };
+            unsigned width[fields];
+            for(std::size_t f = 0; f < fields; f++){
+                std::uint64_t bits = 0;
+                for(std::size_t i = 2; i < n; i++){
+                    bits |= second_difference(i, f);
+                }
+                width[f] = bit_width(bits);
+                out.push_back(static_cast<std::uint8_t>(width[f]));
+            }
+            for(std::size_t f = 0; f < fields; f++){
+                BitWriter bits(out);
+                for(std::size_t i = 2; i < n; i++){
+                    bits.put(second_difference(i, f), width[f]);
+                }
+                bits.finish();
+            }
+        }
+        block.clear();
+    }
+
+    const std::vector<std::uint8_t> & PoseEncoder::finish(){
+        if(!finished){
+            if(!block.empty()){
+                flush_block();
+            }
+            const std::uint64_t index_offset = out.size();
+            for(const std::uint64_t offset : offsets){
+                put_u64(out, offset);
+            }
+            put_u64(out, count);
+            put_u64(out, index_offset);
+            finished = true;
+        }
+        return out;
+    }
+
+    std::errc PoseDecoder::open(const std::uint8_t * data, std::size_t size){
+        *this = PoseDecoder{};
+        if(size < header_size + footer_size || std::memcmp(data, magic, sizeof(magic)) != 0){
+            return std::errc::invalid_argument;
+        }
+        if(get<std::uint32_t>(data + 8) != codec_version){
+            return std::errc::not_supported;
+        }
+
+        PoseCodecConfig config;
+        config.block_size = get<std::uint32_t>(data + 12);
+        config.position_resolution = get<double>(data + 16);
+        config.angle_resolution = get<double>(data + 24);
+        const std::uint64_t poses = get<std::uint64_t>(data + size - footer_size);
+        const std::uint64_t index = get<std::uint64_t>(data + size - footer_size + 8);
+        if(config.block_size == 0 || index < header_size || index > size - footer_size){
+            return std::errc::invalid_argument;
+        }
+        const std::uint64_t n_blocks = poses/config.block_size + (poses%config.block_size != 0);
+        if((size - footer_size - index)/8 != n_blocks || (size - footer_size - index)%8 != 0){
+            return std::errc::invalid_argument;
+        }
+
+        bytes = data;
+        index_offset = index;
+        cfg = config;
+        count = poses;
+        block_count = n_blocks;
+        return std::errc{};
+    }
+
+    std::errc PoseDecoder::decode(std::size_t first, std::size_t n, StampedPose * out) const{
+        if(first > count || n > count - first){
+            return std::errc::invalid_argument;
+        }
+        std::size_t b = first/cfg.block_size;
+        std::size_t skip = first%cfg.block_size;
+        while(n > 0){
+            const std::size_t take = std::min<std::size_t>(n, cfg.block_size - skip);
+            const std::errc ec = decode_block(b, skip, take, out);
+            if(ec != std::errc{}){
+                return ec;
+            }
+            out += take;
+            n -= take;
+            b++;
+            skip = 0;
+        }
+        return std::errc{};
+    }
+
+    std::errc PoseDecoder::decode_block(std::size_t b, std::size_t skip, std::size_t n, StampedPose * out) const{
+        const std::uint8_t * index = bytes + index_offset;
+        const std::uint64_t start = get<std::uint64_t>(index + 8*b);
+        const std::uint64_t stop = b + 1 < block_count ? get<std::uint64_t>(index + 8*(b + 1)) : index_offset;
+        if(start < header_size || start > stop || stop > index_offset || stop - start < 8*fields){
+            return std::errc::invalid_argument;
+        }
+        const std::uint8_t * p = bytes + start;
+        const std::uint8_t * last = bytes + stop;
+        const std::size_t len = std::min<std::size_t>(cfg.block_size, count - b*cfg.block_size);
+
+        std::uint64_t value[fields];
+        std::uint64_t delta[fields] = {};
+        for(std::size_t f = 0; f < fields; f++, p += 8){
+            value[f] = get<std::uint64_t>(p);
+        }
+        if(len >= 2){
+            for(std::size_t f = 0; f < fields; f++){
+                std::uint64_t z;
+                p = get_varint(p, last, z);
+                if(!p){
+                    return std::errc::invalid_argument;
+                }
+                delta[f] = unzigzag(z);
+            }
+        }
+        unsigned width[fields] = {};
+        const std::uint8_t * packed[fields] = {};
+        if(len >= 3){
+            if(last - p < static_cast<std::ptrdiff_t>(fields)){
+                return std::errc::invalid_argument;
+            }
+            for(std::size_t f = 0; f < fields; f++){
+                width[f] = *p++;
+                if(width[f] > 64){
+                    return std::errc::invalid_argument;
+                }
+            }
+            for(std::size_t f = 0; f < fields; f++){
+                const std::uint64_t packed_bytes = ((len - 2)*width[f] + 7)/8;
+                if(static_cast<std::uint64_t>(last - p) < packed_bytes){
+                    return std::errc::invalid_argument;
+                }
+                packed[f] = p;
+                p += packed_bytes;
+            }
+        }
+
+        const double position_resolution = cfg.position_resolution;
+        const double angle_resolution = cfg.angle_resolution;
+        //The stored heading is continuous; the whole turns in it change rarely, so are kept between poses
+        double turns = 0.0;
+        auto emit = [&](std::uint64_t stamp, std::uint64_t q_theta, std::uint64_t q_x, std::uint64_t q_y){
+            const double heading = static_cast<std::int64_t>(q_theta)*angle_resolution;
+            double theta = heading - turns;
+            if(theta > PI || theta <= -PI){
+                theta = detail::wrap_angle(heading);
+                turns = heading - theta;
+            }
+            *out++ = {static_cast<std::int64_t>(stamp), theta,
+                      static_cast<std::int64_t>(q_x)*position_resolution,
+                      static_cast<std::int64_t>(q_y)*position_resolution};
+        };
+
+        //Earlier poses in the block are decoded but not written
+        const std::size_t end = skip + n;
+        if(skip == 0){
+            emit(value[0], value[1], value[2], value[3]);
+        }
+        if(end >= 2){
+            for(std::size_t f = 0; f < fields; f++){
+                value[f] += delta[f];
+            }
+            if(skip <= 1){
+                emit(value[0], value[1], value[2], value[3]);
+            }
+        }
+
+        //The rest a chunk at a time: each field is summed up in its own loop, then the poses are written
+        constexpr std::size_t chunk = 64;
+        std::uint64_t q[fields][chunk];
+        std::uint64_t pos[fields] = {};
+        for(std::size_t i = 2; i < end; i += chunk){
+            const std::size_t m = std::min(chunk, end - i);
+            for(std::size_t f = 0; f < fields; f++){
+                const std::uint8_t * bits = packed[f];
+                const unsigned w = width[f];
+                std::uint64_t d = delta[f];
+                std::uint64_t v = value[f];
+                for(std::size_t j = 0; j < m; j++){
+                    d += unzigzag(get_bits(bits, pos[f] + j*w, w));
+                    v += d;
+                    q[f][j] = v;
+                }
+                pos[f] += m*w;
+                delta[f] = d;
+                value[f] = v;
+            }
+            for(std::size_t j = skip > i ? std::min(skip - i, m) : 0; j < m; j++){
+                emit(q[0][j], q[1][j], q[2][j], q[3][j]);
+            }
+        }
+        return std::errc{};
+    }
+
+}
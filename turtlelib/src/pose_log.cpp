@@ -0,0 +1,278 @@
+#include "turtlelib/pose_log.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// \file
+/// \brief Implementation file for the binary pose log
+
+namespace turtlelib
+{
+    namespace
+    {
+        constexpr char magic[8] = {'T', 'L', 'P', 'O', 'S', 'L', 'O', 'G'};
+        constexpr std::uint32_t byte_order = 0x01020304;
+
+        /// \brief the errno of the last failed system call
+        std::errc last_error()
+        {
+            return static_cast<std::errc>(errno);
+        }
+
+        /// \brief the header this version writes
+        PoseLogHeader current_header()
+        {
+            PoseLogHeader header{};
+            std::memcpy(header.magic, magic, sizeof(magic));
+            header.version = pose_log_version;
+            header.header_size = sizeof(PoseLogHeader);
+            header.record_size = sizeof(PoseRecord);
+            header.byte_order = byte_order;
+            return header;
+        }
+
+        /// \brief check that a header describes a file this version can read
+        std::errc check_header(const PoseLogHeader & header)
+        {
+            if(std::memcmp(header.magic, magic, sizeof(magic)) != 0){
+                return std::errc::invalid_argument;
+            }
+            if(header.version != pose_log_version || header.byte_order != byte_order
+               || header.header_size != sizeof(PoseLogHeader) || header.record_size != sizeof(PoseRecord)){
+                return std::errc::not_supported;
+            }
+            return std::errc{};
+        }
+    }
+
+    PoseLogWriter::PoseLogWriter(std::size_t buffer_records)
+        : capacity(buffer_records > 0 ? buffer_records : 1)
+    {
+        buffer.reserve(capacity);
+    }
+
+    PoseLogWriter::~PoseLogWriter(){
+        if(close() != std::errc{}){
+            close_fd();
+        }
+    }
+
+    std::errc PoseLogWriter::open(const char * path){
+        if(is_open()){
+            const std::errc ec = close();
+            if(ec != std::errc{}){
+                return ec;
+            }
+        }
+        fd = ::open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if(fd < 0){
+            return last_error();
+        }
+
+        struct stat st;
+        if(fstat(fd, &st) != 0){
+            const std::errc ec = last_error();
+            close_fd();
+            return ec;
+        }
+
+        if(st.st_size == 0){
+            const PoseLogHeader header = current_header();
+            std::size_t written = 0;
+            const std::errc ec = write_all(&header, sizeof(header), written);
+            if(ec != std::errc{}){
+                close_fd();
+            }
+            return ec;
+        }
+
+        // Appending to an existing log: its header must match, and a partial record is dropped
+        PoseLogHeader header;
+        if(st.st_size < static_cast<off_t>(sizeof(header))
+           || pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))){
+            close_fd();
+            return std::errc::invalid_argument;
+        }
+        const std::errc ec = check_header(header);
+        if(ec != std::errc{}){
+            close_fd();
+            return ec;
+        }
+        const off_t records = (st.st_size - sizeof(header))/sizeof(PoseRecord);
+        const off_t whole = sizeof(header) + records*sizeof(PoseRecord);
+        if(whole != st.st_size && ftruncate(fd, whole) != 0){
+            const std::errc truncate_ec = last_error();
+            close_fd();
+            return truncate_ec;
+        }
+        return std::errc{};
+    }
+
+    std::errc PoseLogWriter::append(const PoseRecord * records, std::size_t n){
+        // Large arrays go straight to the file, after whatever is already buffered
+        if(buffer.size() + n > capacity){
+            const std::errc ec = flush();
+            if(ec != std::errc{}){
+                buffer.insert(buffer.end(), records, records + n);
+                return ec;
+            }
+            if(n >= capacity){
+                std::size_t written = 0;
+                const std::errc write_ec = write_records(records, n, written);
+                // As in flush(), what did not reach the file is kept for the next one
+                buffer.insert(buffer.end(), records + written, records + n);
+                return write_ec;
+            }
+        }
+        buffer.insert(buffer.end(), records, records + n);
+        return std::errc{};
+    }
+
+    std::errc PoseLogWriter::flush(){
+        if(buffer.empty()){
+            return std::errc{};
+        }
+        std::size_t written = 0;
+        const std::errc ec = write_records(buffer.data(), buffer.size(), written);
+        // Records that did not reach the file stay buffered for the next flush
+        buffer.erase(buffer.begin(), buffer.begin() + written);
+        return ec;
+    }
+
+    std::errc PoseLogWriter::close(){
+        if(fd < 0){
+            return buffer.empty() ? std::errc{} : std::errc::bad_file_descriptor;
+        }
+        const std::errc ec = flush();
+        if(ec != std::errc{}){
+            return ec;
+        }
+        return close_fd();
+    }
+
+    std::errc PoseLogWriter::close_fd(){
+        if(fd < 0){
+            return std::errc{};
+        }
+        const int old = fd;
+        fd = -1;
+        if(::close(old) != 0){
+            return last_error();
+        }
+        return std::errc{};
+    }
+
+    std::errc PoseLogWriter::write_records(const PoseRecord * records, std::size_t n, std::size_t & written){
+        std::size_t bytes = 0;
+        const std::errc ec = write_all(records, n*sizeof(PoseRecord), bytes);
+        written = bytes/sizeof(PoseRecord);
+        // Cut off a partial record, so the records appended later stay aligned
+        const std::size_t partial = bytes%sizeof(PoseRecord);
+        if(partial != 0){
+            const off_t end = lseek(fd, 0, SEEK_END);
+            if(end >= 0){
+                static_cast<void>(ftruncate(fd, end - static_cast<off_t>(partial)));
+            }
+        }
+        return ec;
+    }
+
+    std::errc PoseLogWriter::write_all(const void * data, std::size_t size, std::size_t & written){
+        written = 0;
+        if(fd < 0){
+            return std::errc::bad_file_descriptor;
+        }
+        const char * p = static_cast<const char *>(data);
+        while(written < size){
+            const ssize_t n = ::write(fd, p + written, size - written);
+            if(n < 0){
+                if(errno == EINTR){
+                    continue;
+                }
+                return last_error();
+            }
+            written += n;
+        }
+        return std::errc{};
+    }
+
+    PoseLogReader::~PoseLogReader(){
+        close();
+    }
+
+    PoseLogReader::PoseLogReader(PoseLogReader && other) noexcept
+        : map(other.map), map_size(other.map_size), records(other.records), count(other.count)
+    {
+        other.map = nullptr;
+        other.close();
+    }
+
+    PoseLogReader & PoseLogReader::operator=(PoseLogReader && other) noexcept{
+        if(this != &other){
+            close();
+            map = other.map;
+            map_size = other.map_size;
+            records = other.records;
+            count = other.count;
+            other.map = nullptr;
+            other.close();
+        }
+        return *this;
+    }
+
+    std::errc PoseLogReader::open(const char * path){
+        close();
+        const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if(fd < 0){
+            return last_error();
+        }
+
+        struct stat st;
+        if(fstat(fd, &st) != 0){
+            const std::errc ec = last_error();
+            ::close(fd);
+            return ec;
+        }
+        if(st.st_size < static_cast<off_t>(sizeof(PoseLogHeader))){
+            ::close(fd);
+            return std::errc::invalid_argument;
+        }
+
+        // The mapping stays valid after the descriptor is closed
+        void * p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        const std::errc map_ec = p == MAP_FAILED ? last_error() : std::errc{};
+        ::close(fd);
+        if(map_ec != std::errc{}){
+            return map_ec;
+        }
+
+        const std::errc ec = check_header(*static_cast<const PoseLogHeader *>(p));
+        if(ec != std::errc{}){
+            munmap(p, st.st_size);
+            return ec;
+        }
+
+        // Scans read the file front to back
+        madvise(p, st.st_size, MADV_SEQUENTIAL);
+
+        map = p;
+        map_size = st.st_size;
+        records = reinterpret_cast<const PoseRecord *>(static_cast<const char *>(p) + sizeof(PoseLogHeader));
+        count = (map_size - sizeof(PoseLogHeader))/sizeof(PoseRecord);
+        return std::errc{};
+    }
+
+    void PoseLogReader::close(){
+        if(map){
+            munmap(map, map_size);
+        }
+        map = nullptr;
+        map_size = 0;
+        records = nullptr;
+        count = 0;
+    }
+
+}
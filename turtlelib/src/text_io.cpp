@@ -0,0 +1,557 @@
+#include "turtlelib/text_io.hpp"
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <streambuf>
+
+/// \file
+/// \brief Implementation file for parsing and formatting rigid2d types as text
+
+namespace turtlelib
+{
+    namespace
+    {
+        /// \brief the characters isspace() accepts in the C locale
+        bool is_space(int c)
+        {
+            return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+        }
+
+        /// \brief reads characters from a buffer
+        class BufferSource
+        {
+        public:
+            BufferSource(const char * first, const char * last)
+                : p(first), last(last)
+            {
+            }
+
+            /// \brief the next character, or EOF
+            int peek() const
+            {
+                return p == last ? std::char_traits<char>::eof() : static_cast<unsigned char>(*p);
+            }
+
+            /// \brief consume the next character
+            void get()
+            {
+                p++;
+            }
+
+            /// \brief consume whitespace
+            void skip_space()
+            {
+                p = turtlelib::skip_space(p, last);
+            }
+
+            /// \brief skip whitespace and read a number; a leading '+' is allowed, as it is for iostreams
+            template<class T>
+            bool number(T & value)
+            {
+                skip_space();
+                const char * start = p;
+                if(p != last && *p == '+' && p + 1 != last && p[1] != '-'){
+                    start++;
+                }
+                const std::from_chars_result result = std::from_chars(start, last, value);
+                if(result.ec != std::errc{}){
+                    ec = result.ec;
+                    if(result.ec == std::errc::result_out_of_range){
+                        p = result.ptr;
+                    }
+                    return false;
+                }
+                p = result.ptr;
+                return true;
+            }
+
+            /// \brief why the last read failed
+            std::errc error() const
+            {
+                return ec;
+            }
+
+            /// \brief where reading stopped
+            const char * position() const
+            {
+                return p;
+            }
+
+        private:
+            const char * p;
+            const char * last;
+            std::errc ec = std::errc::invalid_argument;
+        };
+
+        /// \brief reads characters from a stream buffer, so the stream operators share the parsers
+        class StreamSource
+        {
+        public:
+            explicit StreamSource(std::streambuf & buf)
+                : buf(buf)
+            {
+            }
+
+            /// \brief the next character, or EOF
+            int peek()
+            {
+                return buf.sgetc();
+            }
+
+            /// \brief consume the next character
+            void get()
+            {
+                buf.sbumpc();
+            }
+
+            /// \brief consume whitespace
+            void skip_space()
+            {
+                while(is_space(peek())){
+                    get();
+                }
+            }
+
+            /// \brief skip whitespace, then collect the characters of one number and convert them
+            /// Only characters that can continue a number are taken from the stream, and those the
+            /// conversion does not use (a dangling exponent, a partial "infinity") are put back.
+            template<class T>
+            bool number(T & value)
+            {
+                skip_space();
+                // Enough for any double in shortest round-trip form, with room to spare
+                char digits[64];
+                std::size_t n = 0;
+                const auto take = [&]{
+                    if(n == sizeof(digits)){
+                        return false;
+                    }
+                    digits[n++] = static_cast<char>(peek());
+                    get();
+                    return true;
+                };
+                const auto take_digits = [&]{
+                    while(is_digit(peek())){
+                        if(!take()){
+                            return false;
+                        }
+                    }
+                    return true;
+                };
+
+                if(peek() == '+' || peek() == '-'){
+                    take();
+                }
+                const int first = lower(peek());
+                if(first == 'i' || first == 'n'){
+                    // inf, infinity or nan, in any case
+                    const char * word = first == 'i' ? "infinity" : "nan";
+                    for(; *word && lower(peek()) == *word; word++){
+                        take();
+                    }
+                } else {
+                    if(!take_digits()){
+                        return false;
+                    }
+                    if(peek() == '.' && (!take() || !take_digits())){
+                        return false;
+                    }
+                    if(lower(peek()) == 'e'){
+                        take();
+                        if((peek() == '+' || peek() == '-') && !take()){
+                            return false;
+                        }
+                        if(!take_digits()){
+                            return false;
+                        }
+                    }
+                }
+
+                BufferSource source(digits, digits + n);
+                const bool ok = source.number(value);
+                // Give back what the conversion did not use, so the next read starts there
+                const char * used = ok ? source.position() : digits;
+                for(const char * q = digits + n; q != used; q--){
+                    if(std::char_traits<char>::eq_int_type(buf.sputbackc(q[-1]), std::char_traits<char>::eof())){
+                        break;
+                    }
+                }
+                return ok;
+            }
+
+        private:
+            /// \brief whether a character is a decimal digit
+            static bool is_digit(int c)
+            {
+                return c >= '0' && c <= '9';
+            }
+
+            /// \brief an ASCII letter in lower case, anything else unchanged
+            static int lower(int c)
+            {
+                return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+            }
+
+            std::streambuf & buf;
+        };
+
+        /// \brief consume a fixed string, such as a field label
+        template<class Source>
+        bool literal(Source & src, const char * text)
+        {
+            src.skip_space();
+            for(; *text; text++){
+                if(src.peek() != static_cast<unsigned char>(*text)){
+                    return false;
+                }
+                src.get();
+            }
+            return true;
+        }
+
+        /// \brief read n numbers, optionally enclosed in brackets
+        template<class Source, class T>
+        bool read_numbers(Source & src, T * values, std::size_t n)
+        {
+            src.skip_space();
+            const bool bracket = src.peek() == '[';
+            if(bracket){
+                src.get();
+            }
+            for(std::size_t i = 0; i < n; i++){
+                if(!src.number(values[i])){
+                    return false;
+                }
+            }
+            return !bracket || literal(src, "]");
+        }
+
+        template<class Source, class T>
+        bool read(Source & src, BasicVector2D<T> & v)
+        {
+            T values[2];
+            if(!read_numbers(src, values, 2)){
+                return false;
+            }
+            v.x = values[0];
+            v.y = values[1];
+            return true;
+        }
+
+        template<class Source, class T>
+        bool read(Source & src, BasicTwist2D<T> & twist)
+        {
+            T values[3];
+            if(!read_numbers(src, values, 3)){
+                return false;
+            }
+            twist.tw = {values[0], values[1], values[2]};
+            return true;
+        }
+
+        template<class Source, class T>
+        bool read(Source & src, BasicTransform2D<T> & tf)
+        {
+            T deg;
+            BasicVector2D<T> trans;
+            src.skip_space();
+            if(src.peek() == 'd'){
+                // deg: 90 x: 3 y: 5
+                if(!(literal(src, "deg:") && src.number(deg) && literal(src, "x:") && src.number(trans.x)
+                     && literal(src, "y:") && src.number(trans.y))){
+                    return false;
+                }
+            } else if(!(src.number(deg) && src.number(trans.x) && src.number(trans.y))){
+                return false;
+            }
+            tf = BasicTransform2D<T>(trans, static_cast<T>(deg2rad(deg)));
+            return true;
+        }
+
+        template<class Value>
+        std::from_chars_result parse_buffer(const char * first, const char * last, Value & value)
+        {
+            BufferSource src(first, last);
+            if(read(src, value)){
+                return {src.position(), std::errc{}};
+            }
+            return {src.position(), src.error()};
+        }
+
+        template<class Value>
+        std::istream & extract(std::istream & is, Value & value)
+        {
+            //The sentry skips leading whitespace (unless noskipws) and checks the stream state
+            const std::istream::sentry sentry(is);
+            if(!sentry){
+                return is;
+            }
+            StreamSource src(*is.rdbuf());
+            if(!read(src, value)){
+                is.setstate(std::ios_base::failbit);
+            }
+            if(src.peek() == std::char_traits<char>::eof()){
+                is.setstate(std::ios_base::eofbit);
+            }
+            return is;
+        }
+    }
+
+    namespace
+    {
+        /// \brief writes text into a buffer, remembering whether it ran out of room
+        class Writer
+        {
+        public:
+            Writer(char * first, char * last)
+                : p(first), last(last)
+            {
+            }
+
+            /// \brief a writer that formats numbers with a stream's precision and floatfield
+            /// instead of the shortest round-trip form; see insert()
+            Writer(char * first, char * last, std::chars_format fmt, int precision)
+                : p(first), last(last), fmt(fmt), precision(precision), shortest(false)
+            {
+            }
+
+            /// \brief append a fixed string
+            void text(std::string_view s)
+            {
+                if(static_cast<std::size_t>(last - p) < s.size()){
+                    full = true;
+                    return;
+                }
+                p = std::copy(s.begin(), s.end(), p);
+            }
+
+            /// \brief append a number, in its shortest round-trip form unless given a precision
+            template<class T>
+            void number(T value)
+            {
+                const std::to_chars_result result = shortest ? std::to_chars(p, last, value)
+                                                    : precision < 0 ? std::to_chars(p, last, value, fmt)
+                                                    : std::to_chars(p, last, value, fmt, precision);
+                if(result.ec != std::errc{}){
+                    full = true;
+                    return;
+                }
+                p = result.ptr;
+            }
+
+            /// \brief the result of everything written so far
+            std::to_chars_result result() const
+            {
+                if(full){
+                    return {last, std::errc::value_too_large};
+                }
+                return {p, std::errc{}};
+            }
+
+        private:
+            char * p;
+            char * last;
+            std::chars_format fmt = std::chars_format::general;
+            int precision = -1;
+            bool shortest = true;
+            bool full = false;
+        };
+
+        template<class T>
+        void write(Writer & out, const BasicVector2D<T> & v){
+            out.text("[");
+            out.number(v.x);
+            out.text(" ");
+            out.number(v.y);
+            out.text("]");
+        }
+
+        template<class T>
+        void write(Writer & out, const BasicTwist2D<T> & twist){
+            out.text("[");
+            out.number(twist.tw[0]);
+            out.text(" ");
+            out.number(twist.tw[1]);
+            out.text(" ");
+            out.number(twist.tw[2]);
+            out.text("]");
+        }
+
+        template<class T>
+        void write(Writer & out, const BasicTransform2D<T> & tf){
+            out.text("deg: ");
+            out.number(static_cast<T>(rad2deg(tf.rotation())));
+            out.text(" x: ");
+            out.number(tf.translation().x);
+            out.text(" y: ");
+            out.number(tf.translation().y);
+            out.text("\n");
+        }
+
+        /// \brief the largest precision honoured for a stream, enough to round-trip a double
+        constexpr std::streamsize max_precision = 17;
+
+        /// \brief room for a record of the widest fixed-format doubles at max_precision
+        constexpr std::size_t max_stream_chars = 1024;
+
+        /// \brief the writer for a stream's formatting flags. With the default flags (general
+        /// format, precision 6) numbers keep the shortest form that reads back exactly; a set
+        /// floatfield or another precision is honoured as operator<< for a double would,
+        /// with the precision capped at max_precision.
+        Writer stream_writer(const std::ostream & os, char * first, char * last)
+        {
+            const std::ios_base::fmtflags field = os.flags() & std::ios_base::floatfield;
+            const int precision = static_cast<int>(std::min<std::streamsize>(os.precision(), max_precision));
+            if(field == std::ios_base::fixed){
+                return Writer(first, last, std::chars_format::fixed, precision);
+            }
+            if(field == std::ios_base::scientific){
+                return Writer(first, last, std::chars_format::scientific, precision);
+            }
+            if(field == (std::ios_base::fixed | std::ios_base::scientific)){
+                return Writer(first, last, std::chars_format::hex, -1);
+            }
+            if(precision != 6){
+                return Writer(first, last, std::chars_format::general, std::max(precision, 1));
+            }
+            return Writer(first, last);
+        }
+
+        template<class Value>
+        std::ostream & insert(std::ostream & os, const Value & value)
+        {
+            const std::ostream::sentry sentry(os);
+            if(!sentry){
+                return os;
+            }
+            char buf[max_stream_chars];
+            Writer out = stream_writer(os, buf, buf + sizeof(buf));
+            write(out, value);
+            if(out.result().ec != std::errc{}){
+                os.setstate(std::ios_base::failbit);
+                return os;
+            }
+            const std::streamsize n = out.result().ptr - buf;
+
+            //Pad the whole record to the field width, then reset it as operator<< does
+            const std::streamsize pad = std::max<std::streamsize>(os.width() - n, 0);
+            os.width(0);
+            const bool left = (os.flags() & std::ios_base::adjustfield) == std::ios_base::left;
+            std::streambuf & sb = *os.rdbuf();
+            bool ok = true;
+            for(std::streamsize i = 0; ok && !left && i < pad; i++){
+                ok = sb.sputc(os.fill()) != std::char_traits<char>::eof();
+            }
+            ok = ok && sb.sputn(buf, n) == n;
+            for(std::streamsize i = 0; ok && left && i < pad; i++){
+                ok = sb.sputc(os.fill()) != std::char_traits<char>::eof();
+            }
+            if(!ok){
+                os.setstate(std::ios_base::badbit);
+            }
+            return os;
+        }
+    }
+
+    const char * skip_space(const char * first, const char * last){
+        while(first != last && is_space(static_cast<unsigned char>(*first))){
+            first++;
+        }
+        return first;
+    }
+
+    template<class T>
+    std::from_chars_result parse(const char * first, const char * last, BasicVector2D<T> & v){
+        return parse_buffer(first, last, v);
+    }
+
+    template<class T>
+    std::from_chars_result parse(const char * first, const char * last, BasicTwist2D<T> & twist){
+        return parse_buffer(first, last, twist);
+    }
+
+    template<class T>
+    std::from_chars_result parse(const char * first, const char * last, BasicTransform2D<T> & tf){
+        return parse_buffer(first, last, tf);
+    }
+
+    template<class T>
+    std::istream & operator>>(std::istream & is, BasicVector2D<T> & v){
+        return extract(is, v);
+    }
+
+    template<class T>
+    std::istream & operator>>(std::istream & is, BasicTwist2D<T> & t){
+        return extract(is, t);
+    }
+
+    template<class T>
+    std::istream & operator>>(std::istream & is, BasicTransform2D<T> & tf){
+        return extract(is, tf);
+    }
+
+    template<class T>
+    std::to_chars_result format(char * first, char * last, const BasicVector2D<T> & v){
+        Writer out(first, last);
+        write(out, v);
+        return out.result();
+    }
+
+    template<class T>
+    std::to_chars_result format(char * first, char * last, const BasicTwist2D<T> & twist){
+        Writer out(first, last);
+        write(out, twist);
+        return out.result();
+    }
+
+    template<class T>
+    std::to_chars_result format(char * first, char * last, const BasicTransform2D<T> & tf){
+        Writer out(first, last);
+        write(out, tf);
+        return out.result();
+    }
+
+    template<class T>
+    std::ostream & operator<<(std::ostream & os, const BasicVector2D<T> & v){
+        return insert(os, v);
+    }
+
+    template<class T>
+    std::ostream & operator<<(std::ostream & os, const BasicTwist2D<T> & twist){
+        return insert(os, twist);
+    }
+
+    template<class T>
+    std::ostream & operator<<(std::ostream & os, const BasicTransform2D<T> & tf){
+        return insert(os, tf);
+    }
+
+    template std::from_chars_result parse(const char *, const char *, BasicVector2D<double> &);
+    template std::from_chars_result parse(const char *, const char *, BasicVector2D<float> &);
+    template std::from_chars_result parse(const char *, const char *, BasicTwist2D<double> &);
+    template std::from_chars_result parse(const char *, const char *, BasicTwist2D<float> &);
+    template std::from_chars_result parse(const char *, const char *, BasicTransform2D<double> &);
+    template std::from_chars_result parse(const char *, const char *, BasicTransform2D<float> &);
+
+    template std::istream & operator>>(std::istream &, BasicVector2D<double> &);
+    template std::istream & operator>>(std::istream &, BasicVector2D<float> &);
+    template std::istream & operator>>(std::istream &, BasicTwist2D<double> &);
+    template std::istream & operator>>(std::istream &, BasicTwist2D<float> &);
+    template std::istream & operator>>(std::istream &, BasicTransform2D<double> &);
+    template std::istream & operator>>(std::istream &, BasicTransform2D<float> &);
+
+    template std::to_chars_result format(char *, char *, const BasicVector2D<double> &);
+    template std::to_chars_result format(char *, char *, const BasicVector2D<float> &);
+    template std::to_chars_result format(char *, char *, const BasicTwist2D<double> &);
+    template std::to_chars_result format(char *, char *, const BasicTwist2D<float> &);
+    template std::to_chars_result format(char *, char *, const BasicTransform2D<double> &);
+    template std::to_chars_result format(char *, char *, const BasicTransform2D<float> &);
+
+    template std::ostream & operator<<(std::ostream &, const BasicVector2D<double> &);
+    template std::ostream & operator<<(std::ostream &, const BasicVector2D<float> &);
+    template std::ostream & operator<<(std::ostream &, const BasicTwist2D<double> &);
+    template std::ostream & operator<<(std::ostream &, const BasicTwist2D<float> &);
+    template std::ostream & operator<<(std::ostream &, const BasicTransform2D<double> &);
+    template std::ostream & operator<<(std::ostream &, const BasicTransform2D<float> &);
+
+}
@@ -0,0 +1,150 @@
+#include "turtlelib/trajectory.hpp"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+/// \file
+/// \brief Implementation file for trajectory reconstruction
+
+namespace turtlelib
+{
+    namespace
+    {
+        /// \brief below this many increments per thread the threads cost more than they save
+        constexpr std::size_t min_block = 16384;
+
+        /// \brief serial inclusive scan of [begin, end)
+        void scan_block(const Transform2D * increments, Transform2D * poses, std::size_t begin, std::size_t end)
+        {
+            Transform2D pose;
+            for(std::size_t i = begin; i < end; i++){
+                pose*=increments[i];
+                poses[i] = pose;
+            }
+        }
+
+        /// \brief left-multiply [begin, end) by a carry
+        void apply_carry(const Transform2D & carry, Transform2D * poses, std::size_t begin, std::size_t end)
+        {
+            for(std::size_t i = begin; i < end; i++){
+                poses[i] = carry*poses[i];
+            }
+        }
+    }
+
+    void build_trajectory(const Transform2D * increments, Transform2D * poses, std::size_t n,
+                          unsigned threads){
+        if(threads == 0){
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        const std::size_t blocks = std::min<std::size_t>(threads, n/min_block);
+        if(blocks <= 1){
+            scan_block(increments, poses, 0, n);
+            return;
+        }
+
+        // Block k covers [bounds[k], bounds[k+1])
+        std::vector<std::size_t> bounds(blocks + 1);
+        for(std::size_t k = 0; k <= blocks; k++){
+            bounds[k] = n*k/blocks;
+        }
+
+        // Phase 1: independent scans of every block; the calling thread takes block 0
+        std::vector<std::thread> workers;
+        workers.reserve(blocks - 1);
+        for(std::size_t k = 1; k < blocks; k++){
+            workers.emplace_back(scan_block, increments, poses, bounds[k], bounds[k + 1]);
+        }
+        scan_block(increments, poses, bounds[0], bounds[1]);
+        for(std::thread & worker : workers){
+            worker.join();
+        }
+        workers.clear();
+
+        // Phase 2: carry[k] is the product of all blocks before k
+        std::vector<Transform2D> carry(blocks);
+        for(std::size_t k = 1; k < blocks; k++){
+            carry[k] = carry[k - 1]*poses[bounds[k] - 1];
+        }
+
+        // Phase 3: fix up every block but the first with its carry
+        for(std::size_t k = 2; k < blocks; k++){
+            workers.emplace_back(apply_carry, carry[k], poses, bounds[k], bounds[k + 1]);
+        }
+        apply_carry(carry[1], poses, bounds[1], bounds[2]);
+        for(std::thread & worker : workers){
+            worker.join();
+        }
+    }
+
+    TrajectoryIndex::TrajectoryIndex(const Transform2D * increments, std::size_t n){
+        reserve_leaves(n);
+        std::copy(increments, increments + n, tree.begin() + leaves);
+        count = n;
+        for(std::size_t k = leaves - 1; k > 0; k--){
+            tree[k] = tree[2*k]*tree[2*k + 1];
+        }
+    }
+
+    void TrajectoryIndex::reserve_leaves(std::size_t needed){
+        std::size_t new_leaves = 1;
+        while(new_leaves < needed){
+            new_leaves *= 2;
+        }
+        if(new_leaves <= leaves){
+            return;
+        }
+
+        // Move the existing leaves into a larger tree and recompute the internal nodes
+        std::vector<Transform2D> new_tree(2*new_leaves);
+        std::copy(tree.begin() + leaves, tree.begin() + leaves + count, new_tree.begin() + new_leaves);
+        for(std::size_t k = new_leaves - 1; k > 0; k--){
+            new_tree[k] = new_tree[2*k]*new_tree[2*k + 1];
+        }
+        tree.swap(new_tree);
+        leaves = new_leaves;
+    }
+
+    void TrajectoryIndex::append(const Transform2D & increment){
+        if(count == leaves){
+            reserve_leaves(2*count);
+        }
+
+        // Set the leaf and recompute its ancestors
+        std::size_t k = leaves + count;
+        tree[k] = increment;
+        count++;
+        for(k /= 2; k > 0; k /= 2){
+            tree[k] = tree[2*k]*tree[2*k + 1];
+        }
+    }
+
+    std::size_t TrajectoryIndex::size() const{
+        return count;
+    }
+
+    Transform2D TrajectoryIndex::relative(std::size_t i, std::size_t j) const{
+        if(i > j){
+            return relative(j, i).inv();
+        }
+
+        // Bottom-up query of the leaves [i, j). Composition does not commute, so nodes on the
+        // left boundary are appended to left and nodes on the right boundary prepended to right.
+        Transform2D left;
+        Transform2D right;
+        for(std::size_t l = i + leaves, r = j + leaves; l < r; l /= 2, r /= 2){
+            if(l & 1){
+                left*=tree[l++];
+            }
+            if(r & 1){
+                right = tree[--r]*right;
+            }
+        }
+        return left*right;
+    }
+
+    Transform2D TrajectoryIndex::pose(std::size_t i) const{
+        return relative(0, i);
+    }
+
+}
@@ -0,0 +1,156 @@
+#include "turtlelib/transform_buffer.hpp"
+
+/// \file
+/// \brief Implementation file for the transform buffer
+
+namespace turtlelib
+{
+    namespace
+    {
+        /// \brief the smallest power of two at least n, and at least 2
+        std::size_t ring_size(std::size_t n)
+        {
+            std::size_t size = 2;
+            while(size < n){
+                size *= 2;
+            }
+            return size;
+        }
+
+        /// \brief follow the constant twist that takes a (at time ta) to b (at time tb) until time t
+        /// Interpolates for t in [ta, tb] and extrapolates past tb.
+        Transform2D along(const Transform2D & a, std::int64_t ta, const Transform2D & b, std::int64_t tb, std::int64_t t)
+        {
+            const double u = static_cast<double>(t - ta)/static_cast<double>(tb - ta);
+            return a*integrate_twist(log(a.inv()*b), u);
+        }
+    }
+
+    TransformBuffer::TransformBuffer(std::size_t capacity, std::int64_t max_extrapolation_ns)
+        : slots(new Slot[ring_size(capacity)]), mask(ring_size(capacity) - 1), max_extrapolation(max_extrapolation_ns)
+    {
+    }
+
+    std::errc TransformBuffer::push(std::int64_t stamp_ns, const Transform2D & tf){
+        const std::uint64_t k = head.load(std::memory_order_relaxed);
+        if(k != 0 && stamp_ns <= last_stamp){
+            return std::errc::invalid_argument;
+        }
+
+        // Odd while the fields change; readers that load any of them check seq again afterwards
+        Slot & slot = slots[k & mask];
+        slot.seq.store(2*k + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.stamp_ns.store(stamp_ns, std::memory_order_relaxed);
+        slot.th.store(tf.rotation(), std::memory_order_relaxed);
+        slot.cos_th.store(tf.rotation_cos(), std::memory_order_relaxed);
+        slot.sin_th.store(tf.rotation_sin(), std::memory_order_relaxed);
+        slot.x.store(tf.translation().x, std::memory_order_relaxed);
+        slot.y.store(tf.translation().y, std::memory_order_relaxed);
+        slot.seq.store(2*(k + 1), std::memory_order_release);
+
+        head.store(k + 1, std::memory_order_release);
+        last_stamp = stamp_ns;
+        return std::errc{};
+    }
+
+    bool TransformBuffer::read_stamp(std::uint64_t k, std::int64_t & stamp_ns) const{
+        const Slot & slot = slots[k & mask];
+        const std::uint64_t expected = 2*(k + 1);
+        if(slot.seq.load(std::memory_order_acquire) != expected){
+            return false;
+        }
+        stamp_ns = slot.stamp_ns.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.seq.load(std::memory_order_relaxed) == expected;
+    }
+
+    bool TransformBuffer::read_sample(std::uint64_t k, Sample & sample) const{
+        const Slot & slot = slots[k & mask];
+        const std::uint64_t expected = 2*(k + 1);
+        if(slot.seq.load(std::memory_order_acquire) != expected){
+            return false;
+        }
+        sample.stamp_ns = slot.stamp_ns.load(std::memory_order_relaxed);
+        const double th = slot.th.load(std::memory_order_relaxed);
+        const double c = slot.cos_th.load(std::memory_order_relaxed);
+        const double s = slot.sin_th.load(std::memory_order_relaxed);
+        const double x = slot.x.load(std::memory_order_relaxed);
+        const double y = slot.y.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(slot.seq.load(std::memory_order_relaxed) != expected){
+            return false;
+        }
+        sample.tf = Transform2D::from_cos_sin({x, y}, c, s, th);
+        return true;
+    }
+
+    std::errc TransformBuffer::lookup(std::int64_t stamp_ns, Transform2D & tf) const{
+        // Every pass that fails to read a slot has seen the writer lap it, so the next pass
+        // starts from a newer head
+        for(;;){
+            const std::uint64_t end = head.load(std::memory_order_acquire);
+            if(end == 0){
+                return std::errc::result_out_of_range;
+            }
+            const std::uint64_t begin = end > capacity() ? end - capacity() : 0;
+
+            Sample newest;
+            if(!read_sample(end - 1, newest)){
+                continue;
+            }
+            if(stamp_ns >= newest.stamp_ns){
+                if(stamp_ns == newest.stamp_ns){
+                    tf = newest.tf;
+                    return std::errc{};
+                }
+                if(end - begin < 2 || stamp_ns - newest.stamp_ns > max_extrapolation){
+                    return std::errc::result_out_of_range;
+                }
+                Sample previous;
+                if(!read_sample(end - 2, previous)){
+                    continue;
+                }
+                tf = along(previous.tf, previous.stamp_ns, newest.tf, newest.stamp_ns, stamp_ns);
+                return std::errc{};
+            }
+
+            std::int64_t oldest = 0;
+            if(!read_stamp(begin, oldest)){
+                continue;
+            }
+            if(stamp_ns < oldest){
+                return std::errc::result_out_of_range;
+            }
+
+            // Narrow down to stamp(lo) <= stamp_ns < stamp(hi)
+            std::uint64_t lo = begin;
+            std::uint64_t hi = end - 1;
+            bool lapped = false;
+            while(hi - lo > 1){
+                const std::uint64_t mid = lo + (hi - lo)/2;
+                std::int64_t stamp = 0;
+                if(!read_stamp(mid, stamp)){
+                    lapped = true;
+                    break;
+                }
+                if(stamp <= stamp_ns){
+                    lo = mid;
+                } else {
+                    hi = mid;
+                }
+            }
+            Sample a, b;
+            if(lapped || !read_sample(lo, a) || !read_sample(hi, b)){
+                continue;
+            }
+            tf = a.stamp_ns == stamp_ns ? a.tf : along(a.tf, a.stamp_ns, b.tf, b.stamp_ns, stamp_ns);
+            return std::errc{};
+        }
+    }
+
+    std::size_t TransformBuffer::size() const{
+        const std::uint64_t n = head.load(std::memory_order_acquire);
+        return n < capacity() ? static_cast<std::size_t>(n) : capacity();
+    }
+}
@@ -0,0 +1,320 @@
+/// \file
+/// \brief Testing file for the batch rigid2d kernels
+
+
+#include<cmath>
+#include<limits>
+#include<vector>
+#include "turtlelib/batch2d.hpp"
+#include "catch.hpp"
+
+
+namespace
+{
+    /// \brief all instruction sets this CPU can run, from scalar up to the detected one
+    std::vector<turtlelib::SimdLevel> available_levels(){
+        std::vector<turtlelib::SimdLevel> levels = {turtlelib::SimdLevel::scalar};
+        if(static_cast<int>(turtlelib::detected_simd_level()) >= static_cast<int>(turtlelib::SimdLevel::sse2)){
+            levels.push_back(turtlelib::SimdLevel::sse2);
+        }
+        if(turtlelib::detected_simd_level() == turtlelib::SimdLevel::avx2){
+            levels.push_back(turtlelib::SimdLevel::avx2);
+        }
+        return levels;
+    }
+
+    /// \brief a set of points with an awkward count, so the vector kernels hit their tails
+    std::vector<turtlelib::Vector2D> test_points(){
+        std::vector<turtlelib::Vector2D> points;
+        for(int i = 0; i < 37; i++){
+            points.push_back({0.25*i - 3.0, 1.5 - 0.125*i*i});
+        }
+        return points;
+    }
+}
+
+/// \brief batch point transform (array of structures) against operator()
+TEST_CASE("transform_points AoS","[batch]"){
+    const turtlelib::Transform2D tf({1.5, -2.25}, 0.7);
+    const std::vector<turtlelib::Vector2D> points = test_points();
+
+    for(const turtlelib::SimdLevel level : available_levels()){
+        turtlelib::set_simd_level(level);
+        std::vector<turtlelib::Vector2D> out(points.size());
+        turtlelib::transform_points(tf, points.data(), out.data(), points.size());
+
+        //Compare each point to the per-point operator
+        for(std::size_t i = 0; i < points.size(); i++){
+            REQUIRE(tf(points[i]).x==Approx(out[i].x).margin(1e-12));
+            REQUIRE(tf(points[i]).y==Approx(out[i].y).margin(1e-12));
+        }
+    }
+    turtlelib::set_simd_level(turtlelib::detected_simd_level());
+
+}
+
+/// \brief batch point transform (structure of arrays) against operator(), in place
+TEST_CASE("transform_points SoA","[batch]"){
+    const turtlelib::Transform2D tf({-0.5, 4.0}, -2.1);
+    const std::vector<turtlelib::Vector2D> points = test_points();
+
+    for(const turtlelib::SimdLevel level : available_levels()){
+        turtlelib::set_simd_level(level);
+        std::vector<double> xs;
+        std::vector<double> ys;
+        for(const turtlelib::Vector2D & p : points){
+            xs.push_back(p.x);
+            ys.push_back(p.y);
+        }
+        turtlelib::transform_points(tf, xs.data(), ys.data(), xs.data(), ys.data(), xs.size());
+
+        //Compare each point to the per-point operator
+        for(std::size_t i = 0; i < points.size(); i++){
+            REQUIRE(tf(points[i]).x==Approx(xs[i]).margin(1e-12));
+            REQUIRE(tf(points[i]).y==Approx(ys[i]).margin(1e-12));
+        }
+    }
+    turtlelib::set_simd_level(turtlelib::detected_simd_level());
+
+}
+
+/// \brief requesting an unsupported level falls back to the detected one
+TEST_CASE("set_simd_level","[batch]"){
+    const turtlelib::SimdLevel level = turtlelib::set_simd_level(turtlelib::SimdLevel::avx2);
+    REQUIRE(static_cast<int>(level) <= static_cast<int>(turtlelib::detected_simd_level()));
+    REQUIRE(level == turtlelib::simd_level());
+    REQUIRE(turtlelib::set_simd_level(turtlelib::SimdLevel::scalar) == turtlelib::SimdLevel::scalar);
+    turtlelib::set_simd_level(turtlelib::detected_simd_level());
+
+}
+
+/// \brief batch twist adjoint against operator()(Twist2D), in place
+TEST_CASE("transform_twists","[batch]"){
+    const turtlelib::Transform2D tf({0.8, -1.3}, 2.4);
+    std::vector<turtlelib::Twist2D> twists;
+    for(int i = 0; i < 23; i++){
+        twists.push_back(turtlelib::Twist2D{{0.1*i - 1.0, 2.0 - 0.3*i, 0.05*i*i}});
+    }
+
+    for(const turtlelib::SimdLevel level : available_levels()){
+        turtlelib::set_simd_level(level);
+        std::vector<turtlelib::Twist2D> out = twists;
+        turtlelib::transform_twists(tf, out.data(), out.data(), out.size());
+
+        //Compare each twist to the single-twist adjoint
+        for(std::size_t i = 0; i < twists.size(); i++){
+            const turtlelib::Twist2D expected = tf(twists[i]);
+            REQUIRE(expected.tw[0]==Approx(out[i].tw[0]).margin(1e-12));
+            REQUIRE(expected.tw[1]==Approx(out[i].tw[1]).margin(1e-12));
+            REQUIRE(expected.tw[2]==Approx(out[i].tw[2]).margin(1e-12));
+        }
+    }
+    turtlelib::set_simd_level(turtlelib::detected_simd_level());
+
+}
+
+/// \brief batch twist integration against the single-twist version
+TEST_CASE("integrate_twist_sequence","[batch]"){
+    std::vector<turtlelib::Twist2D> twists;
+    for(int i = 0; i < 50; i++){
+        twists.push_back(turtlelib::Twist2D{{0.2*std::sin(0.1*i), 0.3, 0.01*i}});
+    }
+    const turtlelib::Transform2D start({1.0, -1.0}, 0.3);
+
+    std::vector<turtlelib::Transform2D> increments(twists.size());
+    std::vector<turtlelib::Transform2D> poses(twists.size());
+    turtlelib::integrate_twists(twists.data(), increments.data(), twists.size(), 0.01);
+    turtlelib::integrate_twist_sequence(start, twists.data(), poses.data(), twists.size(), 0.01);
+
+    //Fold the increments by hand and compare to the sequence
+    turtlelib::Transform2D pose = start;
+    for(std::size_t i = 0; i < twists.size(); i++){
+        const turtlelib::Transform2D single = turtlelib::integrate_twist(twists[i], 0.01);
+        REQUIRE(single.rotation()==Approx(increments[i].rotation()).margin(1e-15));
+        REQUIRE(single.translation().x==Approx(increments[i].translation().x).margin(1e-15));
+        pose*=single;
+        REQUIRE(pose.rotation()==Approx(poses[i].rotation()).margin(1e-12));
+        REQUIRE(pose.translation().x==Approx(poses[i].translation().x).margin(1e-12));
+        REQUIRE(pose.translation().y==Approx(poses[i].translation().y).margin(1e-12));
+    }
+
+}
+
+/// \brief single precision batch points against the per-point operator, on every level
+TEST_CASE("transform_points float","[batch]"){
+    const turtlelib::Transform2Df tf({0.5f, -2.0f}, -1.2f);
+    std::vector<turtlelib::Vector2Df> in;
+    std::vector<float> xs, ys;
+    for(const turtlelib::Vector2D & p : test_points()){
+        in.push_back({static_cast<float>(p.x), static_cast<float>(p.y)});
+        xs.push_back(static_cast<float>(p.x));
+        ys.push_back(static_cast<float>(p.y));
+    }
+
+    for(const turtlelib::SimdLevel level : available_levels()){
+        turtlelib::set_simd_level(level);
+        std::vector<turtlelib::Vector2Df> out(in.size());
+        std::vector<float> xs_out(in.size()), ys_out(in.size());
+        turtlelib::transform_points(tf, in.data(), out.data(), in.size());
+        turtlelib::transform_points(tf, xs.data(), ys.data(), xs_out.data(), ys_out.data(), in.size());
+        for(std::size_t i = 0; i < in.size(); i++){
+            const turtlelib::Vector2Df expected = tf(in[i]);
+            REQUIRE(out[i].x==Approx(expected.x).margin(1e-5));
+            REQUIRE(out[i].y==Approx(expected.y).margin(1e-5));
+            REQUIRE(xs_out[i]==Approx(expected.x).margin(1e-5));
+            REQUIRE(ys_out[i]==Approx(expected.y).margin(1e-5));
+        }
+    }
+    turtlelib::set_simd_level(turtlelib::detected_simd_level());
+
+    //Twists: a count that leaves a tail for the 4- and 8-wide kernels
+    std::vector<turtlelib::Twist2Df> twists;
+    for(int i = 0; i < 19; i++){
+        twists.push_back({{0.3f - 0.1f*i, 1.0f + 0.5f*i, -0.5f*i}});
+    }
+    for(const turtlelib::SimdLevel level : available_levels()){
+        turtlelib::set_simd_level(level);
+        std::vector<turtlelib::Twist2Df> twists_out(twists.size());
+        turtlelib::transform_twists(tf, twists.data(), twists_out.data(), twists.size());
+        for(std::size_t i = 0; i < twists.size(); i++){
+            const turtlelib::Twist2Df expected = tf(twists[i]);
+            REQUIRE(twists_out[i].thetadot() == expected.thetadot());
+            REQUIRE(twists_out[i].xdot()==Approx(expected.xdot()).margin(1e-5));
+            REQUIRE(twists_out[i].ydot()==Approx(expected.ydot()).margin(1e-5));
+        }
+    }
+    turtlelib::set_simd_level(turtlelib::detected_simd_level());
+}
+
+/// \brief batch normalize, magnitude, dot and angle against the per-vector functions, in every quadrant
+TEST_CASE("vector batch","[batch]"){
+    std::vector<turtlelib::Vector2D> a = test_points();
+    std::vector<turtlelib::Vector2D> b;
+    for(std::size_t i = 0; i < a.size(); i++){
+        b.push_back({std::cos(0.7*i)*(1.0 + i), std::sin(0.7*i)*(1.0 + i)});
+    }
+    //Exact angles of +-PI, +-PI/2 and 0, and tiny and huge ratios
+    a[0] = {-1.0, 0.0};
+    b[0] = {1.0, 0.0};
+    a[1] = {1.0, 1.0};
+    b[1] = {-1.0, 1.0};
+    a[2] = {3.0, -1e-300};
+    b[2] = {1.0, 0.0};
+    a[3] = {1e-12, 5.0};
+    b[3] = {5.0, 1e-9};
+
+    for(const turtlelib::SimdLevel level : available_levels()){
+        turtlelib::set_simd_level(level);
+        std::vector<turtlelib::Vector2D> unit(a.size());
+        std::vector<double> length(a.size()), dots(a.size()), angles(a.size());
+        turtlelib::normalize(a.data(), unit.data(), a.size());
+        turtlelib::magnitude(a.data(), length.data(), a.size());
+        turtlelib::dot(a.data(), b.data(), dots.data(), a.size());
+        turtlelib::angle(a.data(), b.data(), angles.data(), a.size());
+
+        for(std::size_t i = 0; i < a.size(); i++){
+            REQUIRE(unit[i].x == a[i].normalize().x);
+            REQUIRE(unit[i].y == a[i].normalize().y);
+            REQUIRE(length[i] == turtlelib::magnitude(a[i]));
+            REQUIRE(dots[i]==Approx(turtlelib::dot(a[i], b[i])).margin(1e-12));
+            REQUIRE(angles[i]==Approx(turtlelib::angle(a[i], b[i])).margin(1e-15));
+        }
+    }
+    turtlelib::set_simd_level(turtlelib::detected_simd_level());
+
+    //Single precision: normalize and magnitude to the bit, angle to within a float rounding
+    std::vector<turtlelib::Vector2Df> af, bf;
+    for(std::size_t i = 0; i < a.size(); i++){
+        af.push_back({static_cast<float>(a[i].x), static_cast<float>(a[i].y)});
+        bf.push_back({static_cast<float>(b[i].x), static_cast<float>(b[i].y)});
+    }
+    for(const turtlelib::SimdLevel level : available_levels()){
+        turtlelib::set_simd_level(level);
+        std::vector<turtlelib::Vector2Df> unit(af.size());
+        std::vector<float> length(af.size()), dots(af.size()), angles(af.size());
+        turtlelib::normalize(af.data(), unit.data(), af.size());
+        turtlelib::magnitude(af.data(), length.data(), af.size());
+        turtlelib::dot(af.data(), bf.data(), dots.data(), af.size());
+        turtlelib::angle(af.data(), bf.data(), angles.data(), af.size());
+
+        for(std::size_t i = 0; i < af.size(); i++){
+            REQUIRE(unit[i].x == af[i].normalize().x);
+            REQUIRE(unit[i].y == af[i].normalize().y);
+            REQUIRE(length[i] == turtlelib::magnitude(af[i]));
+            REQUIRE(dots[i]==Approx(turtlelib::dot(af[i], bf[i])).epsilon(1e-6).margin(1e-5));
+            const double expected = std::atan2(static_cast<double>(turtlelib::cross(af[i], bf[i])),
+                                               static_cast<double>(turtlelib::dot(af[i], bf[i])));
+            REQUIRE(std::abs(angles[i] - expected) <= std::numeric_limits<float>::epsilon()*std::abs(expected));
+        }
+    }
+    turtlelib::set_simd_level(turtlelib::detected_simd_level());
+}
+
+/// \brief batch normalize_angle, deg2rad and rad2deg give the scalar results to the bit, in place too
+TEST_CASE("angle batch","[batch]"){
+    const double PI = turtlelib::PI;
+    //An odd count leaves a tail for every kernel
+    std::vector<double> in = {0.0, -0.0, PI, -PI, std::nextafter(PI, 4.0), std::nextafter(-PI, -4.0),
+                              2.0*PI, -2.0*PI, 3.0*PI, -5.0*PI, 1e6, -1e9, 1e15, -1e15, INFINITY, NAN};
+    for(int i = 0; i < 101; i++){
+        in.push_back(std::sin(1.3*i)*std::pow(10.0, (i%17) - 3));
+    }
+
+    for(const turtlelib::SimdLevel level : available_levels()){
+        turtlelib::set_simd_level(level);
+        std::vector<double> wrapped(in.size()), rad(in.size()), deg(in.size());
+        turtlelib::normalize_angle(in.data(), wrapped.data(), in.size());
+        turtlelib::deg2rad(in.data(), rad.data(), in.size());
+        turtlelib::rad2deg(in.data(), deg.data(), in.size());
+
+        for(std::size_t i = 0; i < in.size(); i++){
+            const double expected = turtlelib::normalize_angle(in[i]);
+            if(std::isnan(expected)){
+                REQUIRE(std::isnan(wrapped[i]));
+            } else {
+                INFO("angle " << in[i]);
+                REQUIRE(wrapped[i] == expected);
+                REQUIRE(std::signbit(wrapped[i]) == std::signbit(expected));
+            }
+            if(std::isfinite(in[i])){
+                REQUIRE(rad[i] == turtlelib::deg2rad(in[i]));
+                REQUIRE(deg[i] == turtlelib::rad2deg(in[i]));
+            }
+        }
+
+        std::vector<double> in_place = in;
+        turtlelib::normalize_angle(in_place.data(), in_place.data(), in_place.size());
+        REQUIRE(in_place[5] == wrapped[5]);
+        REQUIRE(in_place.back() == wrapped.back());
+    }
+    turtlelib::set_simd_level(turtlelib::detected_simd_level());
+
+    //Single precision: computed in double and rounded, so also to the bit
+    std::vector<float> in_f;
+    for(const double x : in){
+        in_f.push_back(static_cast<float>(x));
+    }
+    for(const turtlelib::SimdLevel level : available_levels()){
+        turtlelib::set_simd_level(level);
+        std::vector<float> wrapped(in_f.size()), rad(in_f.size()), deg(in_f.size());
+        turtlelib::normalize_angle(in_f.data(), wrapped.data(), in_f.size());
+        turtlelib::deg2rad(in_f.data(), rad.data(), in_f.size());
+        turtlelib::rad2deg(in_f.data(), deg.data(), in_f.size());
+
+        for(std::size_t i = 0; i < in_f.size(); i++){
+            const float expected = turtlelib::normalize_angle(in_f[i]);
+            if(std::isnan(expected)){
+                REQUIRE(std::isnan(wrapped[i]));
+            } else {
+                INFO("angle " << in_f[i]);
+                REQUIRE(wrapped[i] == expected);
+                REQUIRE(std::signbit(wrapped[i]) == std::signbit(expected));
+            }
+            if(std::isfinite(in_f[i])){
+                REQUIRE(rad[i] == static_cast<float>(turtlelib::deg2rad(in_f[i])));
+                REQUIRE(deg[i] == static_cast<float>(turtlelib::rad2deg(in_f[i])));
+            }
+        }
+    }
+    turtlelib::set_simd_level(turtlelib::detected_simd_level());
+}
@@ -0,0 +1,147 @@
+/// \file
+/// \brief Testing file for the frame graph
+
+
+#include<memory>
+#include<string>
+#include "turtlelib/frame_graph.hpp"
+#include "catch.hpp"
+
+
+namespace
+{
+    /// \brief check a transform against another
+    void require_close(const turtlelib::Transform2D & tf, const turtlelib::Transform2D & expected){
+        REQUIRE(tf.rotation()==Approx(expected.rotation()).margin(1e-12));
+        REQUIRE(tf.translation().x==Approx(expected.translation().x).margin(1e-12));
+        REQUIRE(tf.translation().y==Approx(expected.translation().y).margin(1e-12));
+    }
+}
+
+/// \brief names map to ids and back
+TEST_CASE("frame graph interning","[frame_graph]"){
+    turtlelib::FrameGraph graph;
+    REQUIRE(graph.intern("world") == 0);
+    REQUIRE(graph.intern("red-base_footprint") == 1);
+    REQUIRE(graph.intern(std::string("world")) == 0);
+    REQUIRE(graph.size() == 2);
+    REQUIRE(graph.find("red-base_footprint") == 1);
+    REQUIRE(graph.find("blue-base_footprint") == turtlelib::no_frame);
+    REQUIRE(graph.name(1) == "red-base_footprint");
+    REQUIRE(graph.parent(1) == turtlelib::no_frame);
+
+    //Many names, so that the storage of the early ones has to stay put
+    for(int i = 0; i < 1000; i++){
+        graph.intern("obstacle" + std::to_string(i));
+    }
+    REQUIRE(graph.find("world") == 0);
+    REQUIRE(graph.find("obstacle999") == 1001);
+}
+
+/// \brief lookups along the tree, across branches, and after updates and re-parenting
+TEST_CASE("frame graph lookup","[frame_graph]"){
+    turtlelib::FrameGraph graph;
+    const turtlelib::Transform2D world_odom({1.0, 2.0}, 0.3);
+    const turtlelib::Transform2D odom_base({-0.5, 4.0}, 2.9);
+    const turtlelib::Transform2D base_scan({0.1, 0.0}, -1.2);
+    const turtlelib::Transform2D world_obstacle({3.0, -1.0}, 0.0);
+    REQUIRE(graph.set_transform("world", "odom", world_odom) == std::errc{});
+    REQUIRE(graph.set_transform("odom", "base_footprint", odom_base) == std::errc{});
+    REQUIRE(graph.set_transform("base_footprint", "base_scan", base_scan) == std::errc{});
+    REQUIRE(graph.set_transform("world", "obstacle", world_obstacle) == std::errc{});
+    const turtlelib::FrameId world = graph.find("world");
+    const turtlelib::FrameId odom = graph.find("odom");
+    const turtlelib::FrameId base = graph.find("base_footprint");
+    const turtlelib::FrameId scan = graph.find("base_scan");
+    const turtlelib::FrameId obstacle = graph.find("obstacle");
+    REQUIRE(graph.parent(scan) == base);
+
+    turtlelib::Transform2D tf;
+    REQUIRE(graph.lookup(world, scan, tf) == std::errc{});
+    require_close(tf, world_odom*odom_base*base_scan);
+    REQUIRE(graph.lookup(scan, world, tf) == std::errc{});
+    require_close(tf, (world_odom*odom_base*base_scan).inv());
+    REQUIRE(graph.lookup("base_scan", "obstacle", tf) == std::errc{});
+    require_close(tf, (world_odom*odom_base*base_scan).inv()*world_obstacle);
+    REQUIRE(graph.lookup(odom, odom, tf) == std::errc{});
+    require_close(tf, turtlelib::Transform2D{});
+
+    //An update shows up below it and nowhere else
+    const turtlelib::Transform2D moved({-0.4, 4.1}, 3.0);
+    REQUIRE(graph.set_transform(odom, base, moved) == std::errc{});
+    REQUIRE(graph.lookup(world, scan, tf) == std::errc{});
+    require_close(tf, world_odom*moved*base_scan);
+    REQUIRE(graph.lookup(obstacle, odom, tf) == std::errc{});
+    require_close(tf, world_obstacle.inv()*world_odom);
+
+    //Updates between lookups, and a lookup of a frame whose ancestors are all stale
+    for(int i = 0; i < 5; i++){
+        REQUIRE(graph.set_transform(world, odom, turtlelib::Transform2D{0.1*i}) == std::errc{});
+        REQUIRE(graph.set_transform(base, scan, turtlelib::Transform2D{{0.0, 0.1*i}}) == std::errc{});
+    }
+    REQUIRE(graph.lookup(scan, base, tf) == std::errc{});
+    require_close(tf, turtlelib::Transform2D{{0.0, 0.4}}.inv());
+    REQUIRE(graph.lookup(world, scan, tf) == std::errc{});
+    require_close(tf, turtlelib::Transform2D{0.4}*moved*turtlelib::Transform2D{{0.0, 0.4}});
+
+    //Re-parenting moves the subtree
+    REQUIRE(graph.set_transform(obstacle, base, odom_base) == std::errc{});
+    REQUIRE(graph.parent(base) == obstacle);
+    REQUIRE(graph.lookup(world, scan, tf) == std::errc{});
+    require_close(tf, world_obstacle*odom_base*turtlelib::Transform2D{{0.0, 0.4}});
+}
+
+/// \brief cycles, unknown frames and separate trees
+TEST_CASE("frame graph errors","[frame_graph]"){
+    turtlelib::FrameGraph graph;
+    REQUIRE(graph.set_transform("a", "b", turtlelib::Transform2D{1.0}) == std::errc{});
+    REQUIRE(graph.set_transform("b", "c", turtlelib::Transform2D{1.0}) == std::errc{});
+    REQUIRE(graph.set_transform("x", "y", turtlelib::Transform2D{1.0}) == std::errc{});
+
+    //A frame under its own descendant, or under itself
+    REQUIRE(graph.set_transform("c", "a", turtlelib::Transform2D{}) == std::errc::invalid_argument);
+    REQUIRE(graph.set_transform("b", "b", turtlelib::Transform2D{}) == std::errc::invalid_argument);
+    REQUIRE(graph.parent(graph.find("a")) == turtlelib::no_frame);
+
+    turtlelib::Transform2D tf;
+    REQUIRE(graph.lookup("c", "y", tf) == std::errc::no_link);
+    REQUIRE(graph.lookup("c", "nowhere", tf) == std::errc::invalid_argument);
+    REQUIRE(graph.lookup(0, 17, tf) == std::errc::invalid_argument);
+    REQUIRE(graph.set_transform(0, 17, tf) == std::errc::invalid_argument);
+
+    //Joining the trees links them
+    REQUIRE(graph.set_transform("c", "x", turtlelib::Transform2D{}) == std::errc{});
+    REQUIRE(graph.lookup("a", "y", tf) == std::errc{});
+    REQUIRE(tf.rotation()==Approx(3.0).margin(1e-12));
+}
+
+/// \brief a copy looks names up in its own storage, after the original is gone
+TEST_CASE("frame graph copy","[frame_graph]"){
+    const turtlelib::Transform2D world_odom({1.0, 2.0}, 0.3);
+    turtlelib::FrameGraph assigned;
+    assigned.intern("stale");
+    std::unique_ptr<turtlelib::FrameGraph> original = std::make_unique<turtlelib::FrameGraph>();
+    REQUIRE(original->set_transform("world", "odom", world_odom) == std::errc{});
+    for(int i = 0; i < 100; i++){
+        original->intern("obstacle" + std::to_string(i));
+    }
+    turtlelib::FrameGraph copy(*original);
+    assigned = *original;
+    original.reset();
+
+    for(const turtlelib::FrameGraph * graph : {&copy, &assigned}){
+        REQUIRE(graph->size() == 102);
+        REQUIRE(graph->find("odom") == 1);
+        REQUIRE(graph->find("obstacle99") == 101);
+        REQUIRE(graph->find("stale") == turtlelib::no_frame);
+        turtlelib::Transform2D tf;
+        REQUIRE(graph->lookup("world", "odom", tf) == std::errc{});
+        require_close(tf, world_odom);
+    }
+
+    //The copy grows on its own, and a moved graph keeps working
+    REQUIRE(copy.intern("new") == 102);
+    turtlelib::FrameGraph moved(std::move(copy));
+    REQUIRE(moved.find("new") == 102);
+    REQUIRE(moved.find("world") == 0);
+}
@@ -0,0 +1,142 @@
+/// \file
+/// \brief Testing file for the pose stream codec
+
+
+#include<algorithm>
+#include<cmath>
+#include<vector>
+#include "turtlelib/pose_codec.hpp"
+#include "catch.hpp"
+
+
+namespace
+{
+    /// \brief a 600 Hz stream that turns several times, crossing +-PI, with a jump in time and position
+    std::vector<turtlelib::StampedPose> test_poses(std::size_t n){
+        std::vector<turtlelib::StampedPose> poses(n);
+        for(std::size_t i = 0; i < n; i++){
+            const double t = i/600.0;
+            poses[i].stamp_ns = static_cast<std::int64_t>(i)*1666667 + (i > n/2 ? 5000000000 : 0);
+            poses[i].theta = turtlelib::detail::wrap_angle(0.9*t);
+            poses[i].x = 0.2*t + (i > n/2 ? 12.5 : 0.0);
+            poses[i].y = std::sin(0.1*t) - 40.0;
+        }
+        return poses;
+    }
+
+    /// \brief check decoded poses against the originals, to half the resolution
+    void require_close(const turtlelib::StampedPose & decoded, const turtlelib::StampedPose & pose,
+                       const turtlelib::PoseCodecConfig & config){
+        REQUIRE(decoded.stamp_ns == pose.stamp_ns);
+        REQUIRE(decoded.theta > -turtlelib::PI);
+        REQUIRE(decoded.theta <= turtlelib::PI);
+        REQUIRE(turtlelib::detail::wrap_angle(decoded.theta - pose.theta)==Approx(0.0).margin(0.5001*config.angle_resolution));
+        REQUIRE(decoded.x==Approx(pose.x).margin(0.5001*config.position_resolution));
+        REQUIRE(decoded.y==Approx(pose.y).margin(0.5001*config.position_resolution));
+    }
+}
+
+/// \brief encode and decode whole, by ranges across blocks, and one pose at a time
+TEST_CASE("pose codec round trip","[pose_codec]"){
+    turtlelib::PoseCodecConfig config;
+    config.position_resolution = 1e-4;
+    config.angle_resolution = 1e-5;
+    config.block_size = 100;
+    const std::vector<turtlelib::StampedPose> poses = test_poses(1051);
+
+    turtlelib::PoseEncoder encoder(config);
+    REQUIRE(encoder.append(poses.data(), 500) == std::errc{});
+    for(std::size_t i = 500; i < poses.size(); i++){
+        REQUIRE(encoder.append(poses[i]) == std::errc{});
+    }
+    const std::vector<std::uint8_t> & bytes = encoder.finish();
+    REQUIRE(encoder.size() == poses.size());
+    REQUIRE(encoder.append(poses[0]) == std::errc::invalid_argument);
+    //A smooth stream needs a few bits per field, against 32 bytes per pose uncompressed
+    REQUIRE(bytes.size() < 4*poses.size());
+
+    turtlelib::PoseDecoder decoder;
+    REQUIRE(decoder.open(bytes.data(), bytes.size()) == std::errc{});
+    REQUIRE(decoder.size() == poses.size());
+    REQUIRE(decoder.blocks() == 11);
+    REQUIRE(decoder.config().block_size == 100);
+
+    std::vector<turtlelib::StampedPose> decoded(poses.size());
+    REQUIRE(decoder.decode(0, poses.size(), decoded.data()) == std::errc{});
+    for(std::size_t i = 0; i < poses.size(); i++){
+        require_close(decoded[i], poses[i], config);
+    }
+
+    //Ranges starting and ending inside blocks give the same poses
+    std::vector<turtlelib::StampedPose> range(300);
+    REQUIRE(decoder.decode(150, 300, range.data()) == std::errc{});
+    for(std::size_t i = 0; i < range.size(); i++){
+        REQUIRE(range[i].stamp_ns == decoded[150 + i].stamp_ns);
+        REQUIRE(range[i].x == decoded[150 + i].x);
+    }
+    for(const std::size_t i : {0, 1, 2, 99, 100, 101, 526, 1049, 1050}){
+        turtlelib::StampedPose pose;
+        REQUIRE(decoder.decode(i, 1, &pose) == std::errc{});
+        REQUIRE(pose.theta == decoded[i].theta);
+        REQUIRE(pose.y == decoded[i].y);
+    }
+    REQUIRE(decoder.decode(1050, 2, range.data()) == std::errc::invalid_argument);
+    REQUIRE(decoder.decode(1051, 0, range.data()) == std::errc{});
+}
+
+/// \brief short streams, and values the encoder rejects
+TEST_CASE("pose codec edge cases","[pose_codec]"){
+    turtlelib::PoseCodecConfig config;
+    config.block_size = 1;
+
+    //Empty, and blocks of one pose
+    for(const std::size_t n : {0, 1, 2, 3}){
+        const std::vector<turtlelib::StampedPose> poses = test_poses(n);
+        turtlelib::PoseEncoder encoder(config);
+        REQUIRE(encoder.append(poses.data(), n) == std::errc{});
+        const std::vector<std::uint8_t> & bytes = encoder.finish();
+        turtlelib::PoseDecoder decoder;
+        REQUIRE(decoder.open(bytes.data(), bytes.size()) == std::errc{});
+        REQUIRE(decoder.size() == n);
+        std::vector<turtlelib::StampedPose> decoded(n);
+        REQUIRE(decoder.decode(0, n, decoded.data()) == std::errc{});
+        for(std::size_t i = 0; i < n; i++){
+            require_close(decoded[i], poses[i], config);
+        }
+    }
+
+    //Out of range for the resolution, infinite, or not a number
+    turtlelib::PoseEncoder encoder;
+    REQUIRE(encoder.append({0, 0.0, 1e12, 0.0}) == std::errc::value_too_large);
+    REQUIRE(encoder.append({0, 0.0, 0.0, INFINITY}) == std::errc::value_too_large);
+    REQUIRE(encoder.append({0, NAN, 0.0, 0.0}) == std::errc::invalid_argument);
+    REQUIRE(encoder.append({-5, 1.0, 1e8, -1e8}) == std::errc{});
+    REQUIRE(encoder.size() == 1);
+}
+
+/// \brief streams that are truncated, of another version, or not streams at all
+TEST_CASE("pose codec validation","[pose_codec]"){
+    turtlelib::PoseEncoder encoder;
+    const std::vector<turtlelib::StampedPose> poses = test_poses(2000);
+    encoder.append(poses.data(), poses.size());
+    std::vector<std::uint8_t> bytes = encoder.finish();
+
+    turtlelib::PoseDecoder decoder;
+    REQUIRE(decoder.open(bytes.data(), 40) == std::errc::invalid_argument);
+    REQUIRE(decoder.open(bytes.data(), bytes.size() - 1) == std::errc::invalid_argument);
+    const std::uint8_t text[] = "deg: 90 x: 3 y: 5\ndeg: 90 x: 3 y: 5\n";
+    REQUIRE(decoder.open(text, sizeof(text)) == std::errc::invalid_argument);
+
+    std::vector<std::uint8_t> other_version = bytes;
+    other_version[8] = 2;
+    REQUIRE(decoder.open(other_version.data(), other_version.size()) == std::errc::not_supported);
+
+    //The offset of the first block pointing into the header
+    std::vector<std::uint8_t> corrupt = bytes;
+    REQUIRE(decoder.open(corrupt.data(), corrupt.size()) == std::errc{});
+    REQUIRE(decoder.blocks() == 2);
+    std::fill_n(corrupt.end() - 16 - 2*8, 8, 0);
+    std::vector<turtlelib::StampedPose> decoded(poses.size());
+    REQUIRE(decoder.decode(0, 10, decoded.data()) == std::errc::invalid_argument);
+    REQUIRE(decoder.decode(1024, 10, decoded.data()) == std::errc{});
+}
@@ -0,0 +1,188 @@
+/// \file
+/// \brief Testing file for the binary pose log
+
+
+#include<cstdio>
+#include<string>
+#include<vector>
+#include<unistd.h>
+#include "turtlelib/pose_log.hpp"
+#include "catch.hpp"
+
+
+namespace
+{
+    /// \brief a unique file name in /tmp, removed when the object goes out of scope
+    struct TempFile
+    {
+        TempFile()
+        {
+            char name[] = "/tmp/turtlelib_pose_log_XXXXXX";
+            const int fd = mkstemp(name);
+            close(fd);
+            path = name;
+        }
+
+        ~TempFile()
+        {
+            std::remove(path.c_str());
+        }
+
+        std::string path;
+    };
+
+    /// \brief a record with every field derived from i
+    turtlelib::PoseRecord test_record(std::size_t i){
+        return turtlelib::make_record(1000000*static_cast<std::int64_t>(i),
+                                      turtlelib::Transform2D({0.01*i, -0.02*i}, 1e-3*i),
+                                      turtlelib::Twist2D{{0.1, 0.2*i, -0.3}});
+    }
+}
+
+/// \brief records written, appended and read back through the mapping
+TEST_CASE("pose log round trip","[pose_log]"){
+    TempFile file;
+    {
+        turtlelib::PoseLogWriter writer(16);
+        REQUIRE(writer.open(file.path.c_str()) == std::errc{});
+        for(std::size_t i = 0; i < 50; i++){
+            REQUIRE(writer.append(test_record(i)) == std::errc{});
+        }
+    }
+    {
+        //Reopening appends after the existing records, in bulk this time
+        std::vector<turtlelib::PoseRecord> more;
+        for(std::size_t i = 50; i < 100; i++){
+            more.push_back(test_record(i));
+        }
+        turtlelib::PoseLogWriter writer(16);
+        REQUIRE(writer.open(file.path.c_str()) == std::errc{});
+        REQUIRE(writer.append(more.data(), 10) == std::errc{});
+        REQUIRE(writer.append(more.data() + 10, 40) == std::errc{});
+        REQUIRE(writer.close() == std::errc{});
+    }
+
+    turtlelib::PoseLogReader reader;
+    REQUIRE(reader.open(file.path.c_str()) == std::errc{});
+    REQUIRE(reader.header().version == turtlelib::pose_log_version);
+    REQUIRE(reader.size() == 100);
+    std::size_t i = 0;
+    for(const turtlelib::PoseRecord & record : reader){
+        const turtlelib::PoseRecord expected = test_record(i++);
+        REQUIRE(record.stamp_ns == expected.stamp_ns);
+        REQUIRE(record.theta == expected.theta);
+        REQUIRE(record.x == expected.x);
+        REQUIRE(record.ydot == expected.ydot);
+    }
+    REQUIRE(reader[42].pose().rotation()==Approx(0.042).margin(1e-15));
+    REQUIRE(reader[42].twist().xdot()==Approx(8.4).margin(1e-15));
+
+    //Moving the reader moves the mapping
+    turtlelib::PoseLogReader moved(std::move(reader));
+    REQUIRE(moved.size() == 100);
+    REQUIRE(reader.size() == 0);
+}
+
+/// \brief files that are not pose logs, and a partial record left at the end
+TEST_CASE("pose log validation","[pose_log]"){
+    TempFile file;
+    turtlelib::PoseLogReader reader;
+
+    //Too short to hold a header
+    REQUIRE(reader.open(file.path.c_str()) == std::errc::invalid_argument);
+    REQUIRE(reader.open("/nonexistent/pose.log") == std::errc::no_such_file_or_directory);
+
+    //Not a pose log
+    {
+        std::FILE * f = std::fopen(file.path.c_str(), "wb");
+        const char text[] = "deg: 90 x: 3 y: 5\ndeg: 90 x: 3 y: 5\n";
+        std::fwrite(text, 1, sizeof(text), f);
+        std::fclose(f);
+    }
+    REQUIRE(reader.open(file.path.c_str()) == std::errc::invalid_argument);
+    turtlelib::PoseLogWriter writer;
+    REQUIRE(writer.open(file.path.c_str()) == std::errc::invalid_argument);
+    REQUIRE(!writer.is_open());
+
+    //A log with half a record at the end: readers skip it and writers cut it off
+    std::remove(file.path.c_str());
+    REQUIRE(writer.open(file.path.c_str()) == std::errc{});
+    writer.append(test_record(0));
+    writer.close();
+    {
+        std::FILE * f = std::fopen(file.path.c_str(), "ab");
+        std::fwrite("partial", 1, 7, f);
+        std::fclose(f);
+    }
+    REQUIRE(reader.open(file.path.c_str()) == std::errc{});
+    REQUIRE(reader.size() == 1);
+    REQUIRE(writer.open(file.path.c_str()) == std::errc{});
+    writer.append(test_record(1));
+    writer.close();
+    REQUIRE(reader.open(file.path.c_str()) == std::errc{});
+    REQUIRE(reader.size() == 2);
+    REQUIRE(reader[1].stamp_ns == 1000000);
+}
+
+/// \brief records that could not be written stay buffered and the error is returned
+TEST_CASE("pose log keeps records on failure","[pose_log]"){
+    TempFile file;
+    turtlelib::PoseLogWriter writer(4);
+    REQUIRE(writer.append(test_record(0)) == std::errc{});
+    REQUIRE(writer.append(test_record(1)) == std::errc{});
+    REQUIRE(writer.flush() == std::errc::bad_file_descriptor);
+    REQUIRE(writer.close() == std::errc::bad_file_descriptor);
+    const std::vector<turtlelib::PoseRecord> more = {test_record(2), test_record(3), test_record(4), test_record(5)};
+    REQUIRE(writer.append(more.data(), more.size()) == std::errc::bad_file_descriptor);
+
+    //Once a file is open, the kept records reach it in order
+    REQUIRE(writer.open(file.path.c_str()) == std::errc{});
+    REQUIRE(writer.close() == std::errc{});
+    turtlelib::PoseLogReader reader;
+    REQUIRE(reader.open(file.path.c_str()) == std::errc{});
+    REQUIRE(reader.size() == 6);
+    for(std::size_t i = 0; i < reader.size(); i++){
+        REQUIRE(reader[i].stamp_ns == test_record(i).stamp_ns);
+    }
+}
+
+/// \brief single appends after a failed flush keep retrying it, and the buffer drains once a write succeeds
+TEST_CASE("pose log retries a failed flush","[pose_log]"){
+    TempFile file;
+    turtlelib::PoseLogWriter writer(4);
+    for(std::size_t i = 0; i < 3; i++){
+        REQUIRE(writer.append(test_record(i)) == std::errc{});
+    }
+    //No file is open, so the full buffer fails to flush, and so does every append after it
+    for(std::size_t i = 3; i < 8; i++){
+        REQUIRE(writer.append(test_record(i)) == std::errc::bad_file_descriptor);
+    }
+
+    //Once a file is open, the next append writes everything kept
+    REQUIRE(writer.open(file.path.c_str()) == std::errc{});
+    REQUIRE(writer.append(test_record(8)) == std::errc{});
+    {
+        turtlelib::PoseLogReader reader;
+        REQUIRE(reader.open(file.path.c_str()) == std::errc{});
+        REQUIRE(reader.size() == 9);
+    }
+
+    //and the buffer is back to one write per capacity records
+    for(std::size_t i = 9; i < 12; i++){
+        REQUIRE(writer.append(test_record(i)) == std::errc{});
+    }
+    {
+        turtlelib::PoseLogReader reader;
+        REQUIRE(reader.open(file.path.c_str()) == std::errc{});
+        REQUIRE(reader.size() == 9);
+    }
+    REQUIRE(writer.append(test_record(12)) == std::errc{});
+    REQUIRE(writer.close() == std::errc{});
+
+    turtlelib::PoseLogReader reader;
+    REQUIRE(reader.open(file.path.c_str()) == std::errc{});
+    REQUIRE(reader.size() == 13);
+    for(std::size_t i = 0; i < reader.size(); i++){
+        REQUIRE(reader[i].stamp_ns == test_record(i).stamp_ns);
+    }
+}
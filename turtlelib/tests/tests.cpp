@@ -3,6 +3,8 @@
 
 
 #define CATCH_CONFIG_MAIN //Source (11/12): https://stackoverflow.com/questions/50580339/catch2-undefined-reference-to
+#include<cmath>
+#include<limits>
 #include<sstream>
 #include<iostream>
 #include "turtlelib/rigid2d.hpp"
@@ -273,4 +275,486 @@ TEST_CASE("operator*","[transform]"){
     REQUIRE(2.4==Approx(t_transform2.translation().x).margin(.01));
     REQUIRE(3.5==Approx(t_transform2.translation().y).margin(.01));
 
-}
\ No newline at end of file
+}
+
+/// \brief composing a transform with its inverse gives the identity
+TEST_CASE("inv() composition","[transform]"){
+    //Create a transform with both rotation and translation
+    turtlelib::Vector2D v1;
+    v1.x=-0.7;
+    v1.y=3.1;
+    turtlelib::Transform2D t_transform1(v1, 2.3);
+
+    //Compose on both sides with the inverse
+    turtlelib::Transform2D left = t_transform1.inv()*t_transform1;
+    turtlelib::Transform2D right = t_transform1*t_transform1.inv();
+
+    //Compare to the identity
+    REQUIRE(0==Approx(left.rotation()).margin(1e-12));
+    REQUIRE(0==Approx(left.translation().x).margin(1e-12));
+    REQUIRE(0==Approx(left.translation().y).margin(1e-12));
+    REQUIRE(0==Approx(right.rotation()).margin(1e-12));
+    REQUIRE(0==Approx(right.translation().x).margin(1e-12));
+    REQUIRE(0==Approx(right.translation().y).margin(1e-12));
+
+}
+
+/// \brief composition of rotated transforms
+TEST_CASE("operator* rotation and translation","[transform]"){
+    //T_ab rotates by 90 degrees and translates by (0,1), T_bc by 90 degrees and (1,0)
+    turtlelib::Transform2D t_ab({0.0, 1.0}, turtlelib::PI/2);
+    turtlelib::Transform2D t_bc({1.0, 0.0}, turtlelib::PI/2);
+
+    turtlelib::Transform2D t_ac = t_ab*t_bc;
+
+    //Compare to the frame_main sample run: deg: 180 x: 0 y: 2
+    REQUIRE(turtlelib::PI==Approx(t_ac.rotation()).margin(1e-9));
+    REQUIRE(0==Approx(t_ac.translation().x).margin(1e-9));
+    REQUIRE(2==Approx(t_ac.translation().y).margin(1e-9));
+
+}
+
+
+/// \brief compile-time composition of the fixed turtlebot3 burger mounting chain
+TEST_CASE("constexpr frame chain","[transform]"){
+    //base_footprint -> base_link -> base_scan offsets from turtlebot3_burger.urdf.xacro
+    constexpr turtlelib::Transform2D t_footprint_link{turtlelib::Vector2D{0.0, 0.0}};
+    constexpr turtlelib::Transform2D t_link_scan{turtlelib::Vector2D{-0.032, 0.0}};
+    constexpr turtlelib::Transform2D t_footprint_scan = t_footprint_link*t_link_scan;
+    constexpr turtlelib::Transform2D t_scan_footprint = t_footprint_scan.inv();
+
+    //A point 1m ahead of the scanner, expressed in base_footprint
+    constexpr turtlelib::Vector2D p_footprint = t_footprint_scan(turtlelib::Vector2D{1.0, 0.0});
+    static_assert(turtlelib::almost_equal(p_footprint.x, 0.968), "scan offset failed");
+    static_assert(turtlelib::almost_equal(t_scan_footprint.translation().x, 0.032), "scan inverse failed");
+
+    //A rotated mount folds at compile time as well
+    constexpr turtlelib::Transform2D t_mount{turtlelib::Vector2D{0.1, -0.2}, turtlelib::PI/2};
+    constexpr turtlelib::Vector2D p_mount = t_mount(turtlelib::Vector2D{1.0, 0.0});
+    static_assert(turtlelib::almost_equal(p_mount.x, 0.1), "rotated mount failed");
+    static_assert(turtlelib::almost_equal(p_mount.y, 0.8), "rotated mount failed");
+
+    //Twist adjoint at compile time
+    constexpr turtlelib::Twist2D twist_scan = t_footprint_scan(turtlelib::Twist2D{{1.0, 0.0, 0.0}});
+    static_assert(turtlelib::almost_equal(twist_scan.tw[2], 0.032), "adjoint failed");
+
+    //The compile-time results match the runtime ones
+    turtlelib::Transform2D t_runtime({0.1, -0.2}, turtlelib::PI/2);
+    REQUIRE(t_runtime(turtlelib::Vector2D{1.0, 0.0}).x==Approx(p_mount.x).margin(1e-12));
+    REQUIRE(t_runtime(turtlelib::Vector2D{1.0, 0.0}).y==Approx(p_mount.y).margin(1e-12));
+
+}
+
+
+/// \brief named components and arithmetic on Twist2D
+TEST_CASE("Twist2D arithmetic","[twist]"){
+    //Build twists through the named accessors
+    turtlelib::Twist2D a;
+    a.thetadot() = 1.0;
+    a.xdot() = -2.0;
+    a.ydot() = 0.5;
+    turtlelib::Twist2D b{{0.5, 1.0, 1.5}};
+
+    //The named accessors alias the tw array
+    REQUIRE(a.tw[1]==-2.0);
+    REQUIRE(a[2]==0.5);
+
+    turtlelib::Twist2D sum = a + b;
+    turtlelib::Twist2D diff = a - b;
+    turtlelib::Twist2D scaled = 2.0*a;
+    turtlelib::Twist2D neg = -b;
+
+    REQUIRE(sum.thetadot()==Approx(1.5));
+    REQUIRE(sum.xdot()==Approx(-1.0));
+    REQUIRE(sum.ydot()==Approx(2.0));
+    REQUIRE(diff.thetadot()==Approx(0.5));
+    REQUIRE(diff.xdot()==Approx(-3.0));
+    REQUIRE(diff.ydot()==Approx(-1.0));
+    REQUIRE(scaled.xdot()==Approx(-4.0));
+    REQUIRE((a*2.0).ydot()==Approx(1.0));
+    REQUIRE(neg.thetadot()==Approx(-0.5));
+
+    //The adjoint is linear in the twist
+    turtlelib::Transform2D tf({0.3, -0.4}, 0.9);
+    turtlelib::Twist2D lhs = tf(a + 3.0*b);
+    turtlelib::Twist2D rhs = tf(a) + 3.0*tf(b);
+    REQUIRE(lhs.thetadot()==Approx(rhs.thetadot()).margin(1e-12));
+    REQUIRE(lhs.xdot()==Approx(rhs.xdot()).margin(1e-12));
+    REQUIRE(lhs.ydot()==Approx(rhs.ydot()).margin(1e-12));
+
+}
+
+
+/// \brief arithmetic, products and normalization on Vector2D, with negative components
+TEST_CASE("Vector2D arithmetic","[vector]"){
+    const turtlelib::Vector2D a{-3.0, 4.0};
+    const turtlelib::Vector2D b{2.0, -0.5};
+
+    REQUIRE((a + b).x==Approx(-1.0));
+    REQUIRE((a + b).y==Approx(3.5));
+    REQUIRE((a - b).x==Approx(-5.0));
+    REQUIRE((a - b).y==Approx(4.5));
+    REQUIRE((-a).x==Approx(3.0));
+    REQUIRE((2.0*a).y==Approx(8.0));
+    REQUIRE((b*-2.0).x==Approx(-4.0));
+    turtlelib::Vector2D c = a;
+    c += b;
+    c -= 2.0*b;
+    c *= 0.5;
+    REQUIRE(c.x==Approx(-2.5));
+    REQUIRE(c.y==Approx(2.25));
+
+    REQUIRE(turtlelib::dot(a, b)==Approx(-8.0));
+    REQUIRE(turtlelib::cross(a, b)==Approx(-6.5));
+    REQUIRE(turtlelib::cross(b, a)==Approx(6.5));
+    REQUIRE(turtlelib::magnitude(a)==Approx(5.0));
+
+    //normalize keeps the sign of every component
+    for(const turtlelib::Vector2D v : {turtlelib::Vector2D{-3.0, -4.0}, turtlelib::Vector2D{3.0, -4.0},
+                                       turtlelib::Vector2D{-3.0, 4.0}, turtlelib::Vector2D{0.0, -2.0}}){
+        const turtlelib::Vector2D u = v.normalize();
+        REQUIRE(u.x==Approx(v.x/turtlelib::magnitude(v)).margin(1e-15));
+        REQUIRE(u.y==Approx(v.y/turtlelib::magnitude(v)).margin(1e-15));
+        REQUIRE(std::signbit(u.x) == std::signbit(v.x));
+        REQUIRE(std::signbit(u.y) == std::signbit(v.y));
+        REQUIRE(turtlelib::magnitude(u)==Approx(1.0).margin(1e-15));
+        REQUIRE(turtlelib::dot(u, v)==Approx(turtlelib::magnitude(v)).margin(1e-15));
+    }
+
+    //Signed angles, counterclockwise positive
+    REQUIRE(turtlelib::angle(turtlelib::Vector2D{1.0, 0.0}, turtlelib::Vector2D{0.0, 1.0})==Approx(turtlelib::PI/2));
+    REQUIRE(turtlelib::angle(turtlelib::Vector2D{1.0, 0.0}, turtlelib::Vector2D{0.0, -1.0})==Approx(-turtlelib::PI/2));
+    REQUIRE(turtlelib::angle(turtlelib::Vector2D{-1.0, -1.0}, turtlelib::Vector2D{1.0, 1.0})==Approx(turtlelib::PI));
+    REQUIRE(turtlelib::angle(a, 3.0*a)==Approx(0.0).margin(1e-15));
+
+    //Usable in constant expressions
+    constexpr turtlelib::Vector2D u = turtlelib::Vector2D{-6.0, 8.0}.normalize();
+    static_assert(u.x < 0.0 && u.y > 0.0, "normalize lost a sign");
+    REQUIRE(u.x==Approx(-0.6).margin(1e-15));
+    REQUIRE(u.y==Approx(0.8).margin(1e-15));
+
+}
+
+
+/// \brief integrating a pure translation twist
+TEST_CASE("integrate_twist translation","[twist]"){
+    turtlelib::Twist2D twist{{0.0, 1.0, 2.0}};
+    turtlelib::Transform2D tf = turtlelib::integrate_twist(twist, 0.5);
+
+    REQUIRE(0==Approx(tf.rotation()).margin(1e-12));
+    REQUIRE(0.5==Approx(tf.translation().x).margin(1e-12));
+    REQUIRE(1.0==Approx(tf.translation().y).margin(1e-12));
+
+}
+
+/// \brief integrating a pure rotation twist
+TEST_CASE("integrate_twist rotation","[twist]"){
+    turtlelib::Twist2D twist{{-1.24, 0.0, 0.0}};
+    turtlelib::Transform2D tf = turtlelib::integrate_twist(twist);
+
+    REQUIRE(-1.24==Approx(tf.rotation()).margin(1e-12));
+    REQUIRE(0==Approx(tf.translation().x).margin(1e-12));
+    REQUIRE(0==Approx(tf.translation().y).margin(1e-12));
+
+}
+
+/// \brief integrating a twist with rotation and translation follows an arc
+TEST_CASE("integrate_twist arc","[twist]"){
+    //Quarter circle of radius 1: theta_dot = pi/2, x_dot = pi/2
+    turtlelib::Twist2D twist{{turtlelib::PI/2, turtlelib::PI/2, 0.0}};
+    turtlelib::Transform2D tf = turtlelib::integrate_twist(twist);
+
+    REQUIRE(turtlelib::PI/2==Approx(tf.rotation()).margin(1e-12));
+    REQUIRE(1.0==Approx(tf.translation().x).margin(1e-12));
+    REQUIRE(1.0==Approx(tf.translation().y).margin(1e-12));
+
+    //Same result from many small exact steps
+    turtlelib::Transform2D steps;
+    for(int i = 0; i < 1000; i++){
+        steps*=turtlelib::integrate_twist(twist, 1e-3);
+    }
+    REQUIRE(tf.rotation()==Approx(steps.rotation()).margin(1e-9));
+    REQUIRE(tf.translation().x==Approx(steps.translation().x).margin(1e-9));
+    REQUIRE(tf.translation().y==Approx(steps.translation().y).margin(1e-9));
+
+}
+
+/// \brief log inverts integrate_twist, including near zero and near pi
+TEST_CASE("log","[twist]"){
+    const double angles[] = {0.0, 1e-9, -3e-7, 1e-3, 0.8, -2.5, 3.1, turtlelib::PI - 1e-9};
+    for(const double w : angles){
+        turtlelib::Twist2D twist{{w, 0.7, -1.9}};
+        turtlelib::Twist2D back = turtlelib::log(turtlelib::integrate_twist(twist));
+
+        REQUIRE(twist.thetadot()==Approx(back.thetadot()).margin(1e-12));
+        REQUIRE(twist.xdot()==Approx(back.xdot()).margin(1e-9));
+        REQUIRE(twist.ydot()==Approx(back.ydot()).margin(1e-9));
+    }
+
+    //The small angle branch is continuous with the exact one
+    turtlelib::Transform2D below = turtlelib::integrate_twist(turtlelib::Twist2D{{0.999e-6, 1.0, 1.0}});
+    turtlelib::Transform2D above = turtlelib::integrate_twist(turtlelib::Twist2D{{1.001e-6, 1.0, 1.0}});
+    REQUIRE(below.translation().x==Approx(above.translation().x).margin(1e-11));
+    REQUIRE(below.translation().y==Approx(above.translation().y).margin(1e-11));
+
+}
+
+
+/// \brief explicit chains are evaluated lazily and match step by step composition
+TEST_CASE("operator* chain","[transform]"){
+    const turtlelib::Transform2D t_ab({0.0, 1.0}, turtlelib::PI/2);
+    const turtlelib::Transform2D t_bc({1.0, 0.0}, turtlelib::PI/2);
+    const turtlelib::Transform2D t_cd({-0.5, 2.0}, -0.3);
+
+    //Step by step
+    turtlelib::Transform2D t_ad = t_ab;
+    t_ad*=t_bc;
+    t_ad*=t_cd;
+
+    //Applying the chain to a point and a twist
+    const turtlelib::Vector2D v{0.7, -1.1};
+    const turtlelib::Vector2D v_a = turtlelib::chain(t_ab, t_bc, t_cd)(v);
+    REQUIRE(t_ad(v).x==Approx(v_a.x).margin(1e-12));
+    REQUIRE(t_ad(v).y==Approx(v_a.y).margin(1e-12));
+
+    const turtlelib::Twist2D twist{{0.4, 1.0, -2.0}};
+    const turtlelib::Twist2D twist_a = turtlelib::chain(t_ab, turtlelib::chain(t_bc, t_cd))(twist);
+    REQUIRE(t_ad(twist).xdot()==Approx(twist_a.xdot()).margin(1e-12));
+    REQUIRE(t_ad(twist).ydot()==Approx(twist_a.ydot()).margin(1e-12));
+
+    //Assigning the chain, including to one of its own operands, and extending it with operator*
+    turtlelib::Transform2D t = t_ab;
+    t = turtlelib::chain(t, t_bc)*t_cd;
+    REQUIRE(t_ad.rotation()==Approx(t.rotation()).margin(1e-12));
+    REQUIRE(t_ad.translation().x==Approx(t.translation().x).margin(1e-12));
+    REQUIRE(t_ad.translation().y==Approx(t.translation().y).margin(1e-12));
+
+    //Expressions hold copies, so keeping one past its operands is safe
+    auto lazy = turtlelib::chain(turtlelib::Transform2D(0.1), turtlelib::Transform2D({1.0, 0.0}));
+    const turtlelib::Transform2D evaluated = lazy.eval();
+    REQUIRE(evaluated.translation().x==Approx(std::cos(0.1)).margin(1e-12));
+    REQUIRE(evaluated.inv().translation().x==Approx(-1.0).margin(1e-12));
+
+    //Chains fold at compile time too
+    constexpr turtlelib::Vector2D p = turtlelib::chain(turtlelib::Transform2D{turtlelib::Vector2D{1.0, 0.0}},
+                                                       turtlelib::Transform2D{turtlelib::Vector2D{0.0, 2.0}})(turtlelib::Vector2D{1.0, 1.0});
+    static_assert(turtlelib::almost_equal(p.x, 2.0) && turtlelib::almost_equal(p.y, 3.0), "fused chain failed");
+
+}
+
+/// \brief a plain product is a Transform2D, so auto and compound assignment work as before
+TEST_CASE("operator* auto","[transform]"){
+    const turtlelib::Transform2D a({0.0, 1.0}, 0.4);
+    const turtlelib::Transform2D b({2.0, -1.0}, -1.1);
+    const turtlelib::Transform2D c({0.5, 0.5}, 2.0);
+
+    auto t = a*b;
+    static_assert(std::is_same<decltype(t), turtlelib::Transform2D>::value, "a*b must be a Transform2D");
+    t*=c;
+    turtlelib::Transform2D expected = a;
+    expected*=b;
+    expected*=c;
+    REQUIRE(t.rotation()==Approx(expected.rotation()).margin(1e-12));
+    REQUIRE(t.translation().x==Approx(expected.translation().x).margin(1e-12));
+    REQUIRE(t.translation().y==Approx(expected.translation().y).margin(1e-12));
+
+    //A product of temporaries outlives them
+    auto u = turtlelib::Transform2D({1.0, 0.0}, 0.0)*turtlelib::Transform2D(turtlelib::PI/2);
+    REQUIRE(u.translation().x==Approx(1.0).margin(1e-12));
+    REQUIRE(u.rotation()==Approx(turtlelib::PI/2).margin(1e-12));
+}
+
+/// \brief single precision transforms match double precision to float accuracy
+TEST_CASE("float transforms","[transform]"){
+    const turtlelib::Transform2Df tf_f({1.5f, -0.25f}, 0.7f);
+    const turtlelib::Transform2D tf_d({1.5, -0.25}, 0.7);
+
+    const turtlelib::Vector2Df v_f = (tf_f*tf_f.inv()*tf_f)(turtlelib::Vector2Df{2.0f, 3.0f});
+    const turtlelib::Vector2D v_d = tf_d(turtlelib::Vector2D{2.0, 3.0});
+    REQUIRE(v_f.x==Approx(v_d.x).margin(1e-5));
+    REQUIRE(v_f.y==Approx(v_d.y).margin(1e-5));
+
+    const turtlelib::Twist2Df twist_f{{0.5f, 0.2f, 0.0f}};
+    const turtlelib::Transform2Df step = turtlelib::integrate_twist(twist_f, 0.1);
+    const turtlelib::Twist2Df back = turtlelib::log(step);
+    REQUIRE(back.thetadot()==Approx(0.05).margin(1e-6));
+    REQUIRE(back.xdot()==Approx(0.02).margin(1e-6));
+
+    stringstream ss;
+    ss << tf_f;
+    turtlelib::Transform2Df read;
+    ss >> read;
+    REQUIRE(read.rotation()==Approx(0.7).margin(1e-5));
+    REQUIRE(read.translation().x==Approx(1.5).margin(1e-5));
+}
+
+namespace
+{
+    /// \brief a dual number a + b*eps with eps^2 = 0; b carries the derivative
+    struct Dual
+    {
+        double a = 0.0;
+        double b = 0.0;
+
+        Dual() = default;
+        Dual(double a, double b = 0.0) : a(a), b(b) {}
+    };
+
+    Dual operator+(Dual l, Dual r) { return {l.a + r.a, l.b + r.b}; }
+    Dual operator-(Dual l, Dual r) { return {l.a - r.a, l.b - r.b}; }
+    Dual operator-(Dual d) { return {-d.a, -d.b}; }
+    Dual operator*(Dual l, Dual r) { return {l.a*r.a, l.a*r.b + l.b*r.a}; }
+    Dual operator/(Dual l, Dual r) { return {l.a/r.a, (l.b*r.a - l.a*r.b)/(r.a*r.a)}; }
+    Dual & operator+=(Dual & l, Dual r) { return l = l + r; }
+    Dual & operator-=(Dual & l, Dual r) { return l = l - r; }
+    bool operator<(Dual l, Dual r) { return l.a < r.a; }
+    bool operator>(Dual l, Dual r) { return l.a > r.a; }
+    bool operator<=(Dual l, Dual r) { return l.a <= r.a; }
+    bool operator>=(Dual l, Dual r) { return l.a >= r.a; }
+    Dual sin(Dual d) { return {std::sin(d.a), std::cos(d.a)*d.b}; }
+    Dual cos(Dual d) { return {std::cos(d.a), -std::sin(d.a)*d.b}; }
+    Dual abs(Dual d) { return d.a < 0.0 ? -d : d; }
+}
+
+/// \brief transforms over a dual number type give exact derivatives
+TEST_CASE("dual number transforms","[transform]"){
+    //d/dth of R(th)*[1 0] + p is [-sin(th) cos(th)]
+    const double th = 0.4;
+    const turtlelib::BasicTransform2D<Dual> tf({Dual{0.5}, Dual{-1.0}}, Dual{th, 1.0});
+    const turtlelib::BasicVector2D<Dual> v = tf(turtlelib::BasicVector2D<Dual>{Dual{1.0}, Dual{0.0}});
+    REQUIRE(v.x.a==Approx(0.5 + std::cos(th)).margin(1e-12));
+    REQUIRE(v.x.b==Approx(-std::sin(th)).margin(1e-12));
+    REQUIRE(v.y.b==Approx(std::cos(th)).margin(1e-12));
+
+    //Composition and rotation() carry the derivative through
+    const turtlelib::BasicTransform2D<Dual> twice = tf*tf;
+    REQUIRE(twice.rotation().a==Approx(2.0*th).margin(1e-12));
+    REQUIRE(twice.rotation().b==Approx(2.0).margin(1e-12));
+
+    //d/dt of integrate_twist at t = 0 is the twist itself
+    const turtlelib::BasicTwist2D<Dual> twist{{Dual{0.3}, Dual{1.0}, Dual{-0.2}}};
+    const turtlelib::BasicTransform2D<Dual> step = turtlelib::integrate_twist(twist, Dual{1e-3, 1.0});
+    REQUIRE(step.translation().x.b==Approx(1.0).margin(1e-3));
+    REQUIRE(step.translation().y.b==Approx(-0.2).margin(1e-3));
+}
+
+/// \brief the stored angle stays in (-PI, PI] and consistent with the stored cosine and sine
+TEST_CASE("rotation angle wrap","[transform]"){
+    //Construction wraps
+    REQUIRE(turtlelib::Transform2D(-turtlelib::PI).rotation()==Approx(turtlelib::PI).margin(1e-15));
+    REQUIRE(turtlelib::Transform2D(3*turtlelib::PI).rotation()==Approx(turtlelib::PI).margin(1e-12));
+    REQUIRE(turtlelib::Transform2D(10.0).rotation()==Approx(10.0 - 4*turtlelib::PI).margin(1e-12));
+    REQUIRE(turtlelib::Transform2D(-7.0).rotation()==Approx(-7.0 + 2*turtlelib::PI).margin(1e-12));
+
+    //Inverting a half turn keeps it at PI
+    REQUIRE(turtlelib::Transform2D(turtlelib::PI).inv().rotation()==Approx(turtlelib::PI).margin(1e-15));
+
+    //Many compositions, crossing PI in both directions
+    const double steps[] = {0.7, -0.7, 3.1, -3.1};
+    for(const double step : steps){
+        const turtlelib::Transform2D inc({0.1, 0.0}, step);
+        turtlelib::Transform2D tf;
+        for(int i = 0; i < 1000; i++){
+            tf*=inc;
+            const double th = tf.rotation();
+            REQUIRE(th > -turtlelib::PI);
+            REQUIRE(th <= turtlelib::PI);
+            //Compare on the circle, atan2 may land on the other side of the cut
+            const double diff = std::remainder(th - std::atan2(tf.rotation_sin(), tf.rotation_cos()), 2*turtlelib::PI);
+            REQUIRE(diff==Approx(0.0).margin(1e-11));
+            REQUIRE(tf.inv().rotation()==Approx(th == turtlelib::PI ? th : -th).margin(1e-15));
+        }
+    }
+
+    //Twist integration and log agree with the stored angle
+    const turtlelib::Transform2D arc = turtlelib::integrate_twist(turtlelib::Twist2D{{4.0, 1.0, 0.0}});
+    REQUIRE(arc.rotation()==Approx(4.0 - 2*turtlelib::PI).margin(1e-12));
+    REQUIRE(turtlelib::log(arc).thetadot()==Approx(4.0 - 2*turtlelib::PI).margin(1e-12));
+}
+
+/// \brief over a long chain the cosine and sine drift from the stored angle, and off the unit circle, only by
+/// the rounding of each composition (about 1e-10 after 1e6); PoseAccumulator puts them back
+TEST_CASE("rotation consistency","[transform]"){
+    const turtlelib::Transform2D inc({0.01, 0.0}, 0.0012345);
+    turtlelib::Transform2D tf;
+    for(int i = 1; i <= 1000000; i++){
+        tf*=inc;
+        if(i%1000 == 0){
+            const double th = tf.rotation();
+            const double diff = std::remainder(th - std::atan2(tf.rotation_sin(), tf.rotation_cos()), 2*turtlelib::PI);
+            REQUIRE(diff==Approx(0.0).margin(1e-9));
+            const double norm = tf.rotation_cos()*tf.rotation_cos() + tf.rotation_sin()*tf.rotation_sin();
+            REQUIRE(norm==Approx(1.0).margin(1e-9));
+        }
+    }
+
+    //A half turn and its inverse agree on the side of the cut
+    const turtlelib::Transform2D half = turtlelib::Transform2D(turtlelib::PI/2)*turtlelib::Transform2D(turtlelib::PI/2);
+    REQUIRE(half.rotation() == turtlelib::PI);
+    REQUIRE(half.inv().rotation() == turtlelib::PI);
+    REQUIRE(std::atan2(half.inv().rotation_sin(), half.inv().rotation_cos()) == turtlelib::PI);
+}
+
+/// \brief normalize_angle at the ends of the interval, at multiples of PI, far out of range, and against a long double reference
+TEST_CASE("normalize_angle","[angle]"){
+    const double PI = turtlelib::PI;
+    const double inf = std::numeric_limits<double>::infinity();
+
+    //Zero keeps its sign, the interval is open at -PI and closed at PI
+    REQUIRE(turtlelib::normalize_angle(0.0) == 0.0);
+    REQUIRE(std::signbit(turtlelib::normalize_angle(-0.0)));
+    REQUIRE(turtlelib::normalize_angle(PI) == PI);
+    REQUIRE(turtlelib::normalize_angle(-PI) == PI);
+    REQUIRE(turtlelib::normalize_angle(std::nextafter(PI, 0.0)) == std::nextafter(PI, 0.0));
+    REQUIRE(turtlelib::normalize_angle(std::nextafter(-PI, 0.0)) == std::nextafter(-PI, 0.0));
+    //Just past either end lands next to the other end, or on PI when that is the nearest double
+    REQUIRE(std::abs(turtlelib::normalize_angle(std::nextafter(PI, 4.0)))==Approx(PI).margin(1e-15));
+    REQUIRE(std::abs(turtlelib::normalize_angle(std::nextafter(-PI, -4.0)))==Approx(PI).margin(1e-15));
+
+    //Multiples of 2PI, one ulp either side, and odd multiples of PI
+    for(double k = 1.0; k < 2e6; k = k*3.0 + 1.0){
+        for(const double sign : {1.0, -1.0}){
+            const double turn = sign*k*2.0*PI;
+            REQUIRE(turtlelib::normalize_angle(turn)==Approx(0.0).margin(2e-15*k));
+            REQUIRE(turtlelib::normalize_angle(std::nextafter(turn, inf))==Approx(0.0).margin(2e-15*k));
+            REQUIRE(turtlelib::normalize_angle(std::nextafter(turn, -inf))==Approx(0.0).margin(2e-15*k));
+            const double r = turtlelib::normalize_angle(turn + sign*PI);
+            REQUIRE(std::abs(r)==Approx(PI).margin(2e-15*k));
+        }
+    }
+
+    //A dense sweep of both signs, every result in range and on the circle where the reference is
+    const long double two_pi = 6.283185307179586476925286766559L;
+    for(double x = 1e-3; x < 1e15; x *= 1.0003){
+        for(const double a : {x, -x}){
+            const double r = turtlelib::normalize_angle(a);
+            REQUIRE(r > -PI);
+            REQUIRE(r <= PI);
+            long double diff = r - std::remainder(static_cast<long double>(a), two_pi);
+            diff = diff > PI ? diff - two_pi : (diff < -PI ? diff + two_pi : diff);
+            REQUIRE(static_cast<double>(diff)==Approx(0.0).margin(1e-15 + 4e-16*x));
+        }
+    }
+
+    //Not a number in, not a number out
+    REQUIRE(std::isnan(turtlelib::normalize_angle(inf)));
+    REQUIRE(std::isnan(turtlelib::normalize_angle(-inf)));
+    REQUIRE(std::isnan(turtlelib::normalize_angle(std::numeric_limits<double>::quiet_NaN())));
+
+    //The same for wrap_angle, which Transform2D uses
+    REQUIRE(turtlelib::detail::wrap_angle(-PI) == PI);
+    REQUIRE(turtlelib::detail::wrap_angle(1e9)==Approx(std::remainder(1e9, 2.0*PI)).margin(1e-6));
+
+    //Single precision, computed in double and rounded
+    for(float x = -1000.0f; x < 1000.0f; x += 0.37f){
+        const float r = turtlelib::normalize_angle(x);
+        REQUIRE(r >= -static_cast<float>(PI));
+        REQUIRE(r <= static_cast<float>(PI));
+        REQUIRE(r == static_cast<float>(turtlelib::normalize_angle(static_cast<double>(x))));
+    }
+
+    //Degrees
+    REQUIRE(turtlelib::deg2rad(180.0) == PI);
+    REQUIRE(turtlelib::rad2deg(PI) == 180.0);
+    REQUIRE(turtlelib::rad2deg(turtlelib::deg2rad(-33.0))==Approx(-33.0).margin(1e-13));
+}
@@ -0,0 +1,215 @@
+/// \file
+/// \brief Testing file for parsing rigid2d types from text
+
+
+#include<cmath>
+#include<iomanip>
+#include<sstream>
+#include<string>
+#include<vector>
+#include "turtlelib/text_io.hpp"
+#include "catch.hpp"
+
+
+/// \brief vectors in both formats, with and without brackets
+TEST_CASE("parse Vector2D","[text_io]"){
+    turtlelib::Vector2D v;
+    const std::string text = "  [1.5 -2e-3]\n3 +4";
+    const char * last = text.data() + text.size();
+
+    auto result = turtlelib::parse(text.data(), last, v);
+    REQUIRE(result.ec == std::errc{});
+    REQUIRE(v.x == 1.5);
+    REQUIRE(v.y == -2e-3);
+    REQUIRE(*result.ptr == '\n');
+
+    result = turtlelib::parse(result.ptr, last, v);
+    REQUIRE(result.ec == std::errc{});
+    REQUIRE(v.x == 3.0);
+    REQUIRE(v.y == 4.0);
+    REQUIRE(result.ptr == last);
+
+    //End of input and malformed text are errors, and leave the vector alone
+    REQUIRE(turtlelib::parse(result.ptr, last, v).ec == std::errc::invalid_argument);
+    REQUIRE(turtlelib::parse(std::string_view("[1 2"), v).ec == std::errc::invalid_argument);
+    REQUIRE(turtlelib::parse(std::string_view("1 x"), v).ec == std::errc::invalid_argument);
+    REQUIRE(turtlelib::parse(std::string_view("1 1e999"), v).ec == std::errc::result_out_of_range);
+    REQUIRE(v.x == 3.0);
+    REQUIRE(v.y == 4.0);
+}
+
+/// \brief twists and transforms in both formats
+TEST_CASE("parse Twist2D and Transform2D","[text_io]"){
+    turtlelib::Twist2D twist;
+    REQUIRE(turtlelib::parse(std::string_view("[1 -2 3]"), twist).ec == std::errc{});
+    REQUIRE(twist.xdot() == -2.0);
+    REQUIRE(turtlelib::parse(std::string_view("0.5\t0.25\n0.125"), twist).ec == std::errc{});
+    REQUIRE(twist.ydot() == 0.125);
+
+    turtlelib::Transform2D tf;
+    const std::string labelled = "deg: 90 x: 3 y: 5\n";
+    auto result = turtlelib::parse(labelled.data(), labelled.data() + labelled.size(), tf);
+    REQUIRE(result.ec == std::errc{});
+    REQUIRE(tf.rotation()==Approx(turtlelib::PI/2).margin(1e-12));
+    REQUIRE(tf.translation().x == 3.0);
+    REQUIRE(tf.translation().y == 5.0);
+
+    REQUIRE(turtlelib::parse(std::string_view("-45 1 2"), tf).ec == std::errc{});
+    REQUIRE(tf.rotation()==Approx(-turtlelib::PI/4).margin(1e-12));
+    REQUIRE(tf.translation().y == 2.0);
+
+    //A wrong label points at the offending character
+    const std::string bad = "deg: 90 y: 3 x: 5";
+    result = turtlelib::parse(bad.data(), bad.data() + bad.size(), tf);
+    REQUIRE(result.ec == std::errc::invalid_argument);
+    REQUIRE(result.ptr == bad.data() + 8);
+    REQUIRE(tf.translation().y == 2.0);
+
+    turtlelib::Transform2Df tf_f;
+    REQUIRE(turtlelib::parse(std::string_view("deg: 30 x: 0.5 y: 0.25"), tf_f).ec == std::errc{});
+    REQUIRE(tf_f.translation().x == 0.5f);
+}
+
+/// \brief the stream operators accept the same formats and report errors with failbit
+TEST_CASE("stream extraction","[text_io]"){
+    std::istringstream is("deg: 90 x: 0 y: 1\n  [1 2] -1 -2\n1 2 3 [4 5 6] deg: 1 x: oops");
+    turtlelib::Transform2D tf;
+    turtlelib::Vector2D v;
+    turtlelib::Twist2D twist;
+
+    is >> tf;
+    REQUIRE(tf.rotation()==Approx(turtlelib::PI/2).margin(1e-12));
+    REQUIRE(tf.translation().y == 1.0);
+    is >> v;
+    REQUIRE(v.y == 2.0);
+    is >> v;
+    REQUIRE(v.x == -1.0);
+    is >> twist;
+    REQUIRE(twist.ydot() == 3.0);
+    is >> twist;
+    REQUIRE(twist.thetadot() == 4.0);
+    REQUIRE(is.good());
+
+    is >> tf;
+    REQUIRE(is.fail());
+    REQUIRE(tf.translation().y == 1.0);
+}
+
+/// \brief extraction stops at the end of a number and leaves the rest in the stream
+TEST_CASE("stream extraction stops at the number","[text_io]"){
+    //Trailing letters stay for the next read, whether or not the read succeeds
+    std::istringstream is("1.5abc 2");
+    turtlelib::Vector2D v;
+    is >> v;
+    REQUIRE(is.fail());
+    is.clear();
+    std::string rest;
+    is >> rest;
+    REQUIRE(rest == "abc");
+
+    //A dangling exponent and a partial "infinity" are not part of the number, and are put back
+    std::istringstream exponent("1 2e end");
+    exponent >> v;
+    REQUIRE(v.y == 2.0);
+    exponent >> rest;
+    REQUIRE(rest == "e");
+
+    std::istringstream infinite("[inf -Infinity] nano 1");
+    infinite >> v;
+    REQUIRE(infinite.good());
+    REQUIRE(std::isinf(v.x));
+    REQUIRE(v.y < 0.0);
+    infinite >> v;
+    REQUIRE(infinite.fail());
+    REQUIRE(std::isinf(v.x));
+    infinite.clear();
+    infinite >> rest;
+    REQUIRE(rest == "o");
+}
+
+/// \brief formatted values read back exactly
+TEST_CASE("format round trip","[text_io]"){
+    char buf[turtlelib::max_record_chars];
+    char * const last = buf + sizeof(buf);
+
+    const turtlelib::Vector2D v{0.1, -1.0/3.0};
+    auto result = turtlelib::format(buf, last, v);
+    REQUIRE(result.ec == std::errc{});
+    turtlelib::Vector2D v_read;
+    REQUIRE(turtlelib::parse(buf, result.ptr, v_read).ptr == result.ptr);
+    REQUIRE(v_read.x == v.x);
+    REQUIRE(v_read.y == v.y);
+
+    const turtlelib::Twist2D twist{{-1e-300, 2.0/7.0, 123456.789}};
+    result = turtlelib::format(buf, last, twist);
+    REQUIRE(std::string(buf, result.ptr) == "[-1e-300 0.2857142857142857 123456.789]");
+    turtlelib::Twist2D twist_read;
+    turtlelib::parse(buf, result.ptr, twist_read);
+    REQUIRE(twist_read.tw == twist.tw);
+
+    const turtlelib::Transform2D tf({-0.0123456789, 1e10/3.0}, 2.0);
+    result = turtlelib::format(buf, last, tf);
+    turtlelib::Transform2D tf_read;
+    turtlelib::parse(buf, result.ptr, tf_read);
+    REQUIRE(tf_read.translation().x == tf.translation().x);
+    REQUIRE(tf_read.translation().y == tf.translation().y);
+    REQUIRE(tf_read.rotation()==Approx(tf.rotation()).margin(1e-15));
+
+    //A buffer that is too small
+    REQUIRE(turtlelib::format(buf, buf + 10, tf).ec == std::errc::value_too_large);
+}
+
+/// \brief formatting an array writes whole records only
+TEST_CASE("format span","[text_io]"){
+    const std::vector<turtlelib::Vector2D> points = {{1.0, 2.0}, {3.0, 4.0}, {5.0, 6.0}};
+    char buf[16];
+    std::size_t written = 0;
+    auto result = turtlelib::format(buf, buf + sizeof(buf), points.data(), points.size(), written);
+    REQUIRE(result.ec == std::errc::value_too_large);
+    REQUIRE(written == 2);
+    REQUIRE(std::string(buf, result.ptr) == "[1 2]\n[3 4]\n");
+
+    char big[64];
+    result = turtlelib::format(big, big + sizeof(big), points.data(), points.size(), written);
+    REQUIRE(result.ec == std::errc{});
+    REQUIRE(written == 3);
+
+    //Read them back
+    std::vector<turtlelib::Vector2D> read;
+    for(const char * p = turtlelib::skip_space(big, result.ptr); p != result.ptr; p = turtlelib::skip_space(p, result.ptr)){
+        turtlelib::Vector2D v;
+        p = turtlelib::parse(p, result.ptr, v).ptr;
+        read.push_back(v);
+    }
+    REQUIRE(read.size() == 3);
+    REQUIRE(read[2].y == 6.0);
+}
+
+/// \brief the stream operators write to the stream they are given
+TEST_CASE("stream insertion","[text_io]"){
+    std::ostringstream os;
+    os << turtlelib::Twist2D{{1.0, 0.5, -2.0}} << " " << turtlelib::Vector2Df{0.1f, 2.0f};
+    REQUIRE(os.str() == "[1 0.5 -2] [0.1 2]");
+}
+
+/// \brief width, fill, adjustment, precision and floatfield apply as for a double
+TEST_CASE("stream insertion flags","[text_io]"){
+    std::ostringstream os;
+    os << std::setw(12) << turtlelib::Vector2D{1.0, 0.5} << "|";
+    os << std::left << std::setfill('*') << std::setw(10) << turtlelib::Vector2D{1.0, 2.0} << "|";
+    os << turtlelib::Vector2D{3.0, 4.0} << "|";
+    REQUIRE(os.str() == "     [1 0.5]|[1 2]*****|[3 4]|");
+
+    std::ostringstream fixed;
+    fixed << std::fixed << std::setprecision(2) << turtlelib::Twist2D{{1.0, 1.0/3.0, -2.5}};
+    REQUIRE(fixed.str() == "[1.00 0.33 -2.50]");
+
+    std::ostringstream general;
+    general << std::setprecision(3) << turtlelib::Vector2D{1.0/3.0, 12345.0};
+    REQUIRE(general.str() == "[0.333 1.23e+04]");
+
+    std::ostringstream bad;
+    bad.setstate(std::ios_base::failbit);
+    bad << turtlelib::Vector2D{1.0, 2.0};
+    REQUIRE(bad.str().empty());
+}
@@ -0,0 +1,149 @@
+/// \file
+/// \brief Testing file for trajectory reconstruction
+
+
+#include<algorithm>
+#include<vector>
+#include "turtlelib/trajectory.hpp"
+#include "catch.hpp"
+
+
+namespace
+{
+    /// \brief a wandering sequence of small increments, like logged odometry
+    std::vector<turtlelib::Transform2D> test_increments(std::size_t n){
+        std::vector<turtlelib::Transform2D> increments;
+        increments.reserve(n);
+        for(std::size_t i = 0; i < n; i++){
+            increments.emplace_back(turtlelib::Vector2D{0.01 + 1e-4*(i%17), 2e-4*(i%5) - 4e-4}, 0.003*std::sin(1e-3*i));
+        }
+        return increments;
+    }
+}
+
+/// \brief the parallel scan matches the serial fold
+TEST_CASE("build_trajectory parallel","[trajectory]"){
+    const std::vector<turtlelib::Transform2D> increments = test_increments(1000000);
+
+    //Serial fold
+    std::vector<turtlelib::Transform2D> serial(increments.size());
+    turtlelib::Transform2D pose;
+    for(std::size_t i = 0; i < increments.size(); i++){
+        pose*=increments[i];
+        serial[i] = pose;
+    }
+
+    for(const unsigned threads : {1u, 3u, 8u}){
+        std::vector<turtlelib::Transform2D> poses(increments.size());
+        turtlelib::build_trajectory(increments.data(), poses.data(), increments.size(), threads);
+
+        //Check every pose near block boundaries and a stride through the rest
+        for(std::size_t i = 0; i < poses.size(); i += (i % 125000 < 3 || i % 125000 > 124996) ? 1 : 997){
+            REQUIRE(serial[i].rotation_cos()==Approx(poses[i].rotation_cos()).margin(1e-9));
+            REQUIRE(serial[i].rotation_sin()==Approx(poses[i].rotation_sin()).margin(1e-9));
+            REQUIRE(serial[i].translation().x==Approx(poses[i].translation().x).margin(1e-9));
+            REQUIRE(serial[i].translation().y==Approx(poses[i].translation().y).margin(1e-9));
+        }
+        REQUIRE(serial.back().translation().x==Approx(poses.back().translation().x).margin(1e-9));
+        REQUIRE(serial.back().translation().y==Approx(poses.back().translation().y).margin(1e-9));
+    }
+
+}
+
+/// \brief short and in-place inputs
+TEST_CASE("build_trajectory in place","[trajectory]"){
+    std::vector<turtlelib::Transform2D> poses = test_increments(100);
+    const std::vector<turtlelib::Transform2D> increments = poses;
+    turtlelib::build_trajectory(poses.data(), poses.data(), poses.size(), 4);
+
+    turtlelib::Transform2D pose;
+    for(std::size_t i = 0; i < increments.size(); i++){
+        pose*=increments[i];
+        REQUIRE(pose.translation().x==Approx(poses[i].translation().x).margin(1e-12));
+        REQUIRE(pose.translation().y==Approx(poses[i].translation().y).margin(1e-12));
+    }
+
+    //Nothing to do for an empty trajectory
+    turtlelib::build_trajectory(poses.data(), poses.data(), 0);
+
+}
+
+/// \brief relative-pose queries against composing the span by hand
+TEST_CASE("TrajectoryIndex relative","[trajectory]"){
+    const std::vector<turtlelib::Transform2D> increments = test_increments(300);
+
+    //Build half of the index at once and append the rest, crossing several capacity doublings
+    turtlelib::TrajectoryIndex index(increments.data(), 37);
+    for(std::size_t k = 37; k < increments.size(); k++){
+        index.append(increments[k]);
+    }
+    REQUIRE(index.size() == increments.size());
+
+    const std::size_t pairs[][2] = {{0, 0}, {0, 300}, {5, 6}, {17, 250}, {128, 256}, {299, 300}, {250, 17}, {300, 0}};
+    for(const auto & pair : pairs){
+        const std::size_t i = pair[0];
+        const std::size_t j = pair[1];
+
+        //Compose the span directly
+        turtlelib::Transform2D expected;
+        for(std::size_t k = std::min(i, j); k < std::max(i, j); k++){
+            expected*=increments[k];
+        }
+        if(i > j){
+            expected = expected.inv();
+        }
+
+        const turtlelib::Transform2D result = index.relative(i, j);
+        REQUIRE(expected.rotation()==Approx(result.rotation()).margin(1e-12));
+        REQUIRE(expected.translation().x==Approx(result.translation().x).margin(1e-12));
+        REQUIRE(expected.translation().y==Approx(result.translation().y).margin(1e-12));
+    }
+
+    //pose(i) is relative to the start
+    REQUIRE(index.pose(0).translation().x==Approx(0.0).margin(1e-15));
+    REQUIRE(index.pose(2).translation().x==Approx((increments[0]*increments[1]).translation().x).margin(1e-15));
+
+}
+
+/// \brief an empty index only knows the start pose
+TEST_CASE("TrajectoryIndex empty","[trajectory]"){
+    turtlelib::TrajectoryIndex index;
+    REQUIRE(index.size() == 0);
+    REQUIRE(index.relative(0, 0).translation().x==Approx(0.0).margin(1e-15));
+
+    index.append(turtlelib::Transform2D{turtlelib::Vector2D{1.0, 2.0}});
+    REQUIRE(index.relative(1, 0).translation().y==Approx(-2.0).margin(1e-15));
+
+}
+
+/// \brief the accumulator keeps the rotation on the unit circle and agrees with the plain fold
+TEST_CASE("PoseAccumulator","[trajectory]"){
+    const std::vector<turtlelib::Transform2D> increments = test_increments(200000);
+
+    turtlelib::Transform2D plain;
+    turtlelib::PoseAccumulator acc(64);
+    turtlelib::PoseAccumulator never(0);
+    REQUIRE(acc.interval() == 64);
+    for(const turtlelib::Transform2D & inc : increments){
+        plain*=inc;
+        acc*=inc;
+        never*=inc;
+    }
+
+    //Without re-projection the accumulator is the plain fold
+    REQUIRE(never.pose().translation().x == plain.translation().x);
+    REQUIRE(never.pose().rotation() == plain.rotation());
+
+    const turtlelib::Transform2D & pose = acc.pose();
+    REQUIRE(pose.rotation_cos()*pose.rotation_cos() + pose.rotation_sin()*pose.rotation_sin()==Approx(1.0).margin(1e-15));
+    REQUIRE(pose.rotation()==Approx(std::atan2(pose.rotation_sin(), pose.rotation_cos())).margin(1e-15));
+    REQUIRE(pose.rotation()==Approx(plain.rotation()).margin(1e-10));
+    REQUIRE(pose.translation().x==Approx(plain.translation().x).margin(1e-9));
+    REQUIRE(pose.translation().y==Approx(plain.translation().y).margin(1e-9));
+
+    //Re-projecting an exact rotation changes nothing
+    turtlelib::PoseAccumulator start(turtlelib::Transform2D({1.0, 2.0}, 0.5), 1);
+    start.reproject();
+    REQUIRE(start.pose().rotation()==Approx(0.5).margin(1e-15));
+    REQUIRE(start.pose().translation().y == 2.0);
+}
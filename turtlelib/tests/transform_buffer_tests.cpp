@@ -0,0 +1,120 @@
+/// \file
+/// \brief Testing file for the transform buffer
+
+
+#include<atomic>
+#include<cmath>
+#include<thread>
+#include<vector>
+#include "turtlelib/transform_buffer.hpp"
+#include "catch.hpp"
+
+
+namespace
+{
+    /// \brief a robot driving a circle at a constant twist, turning through +-PI every 2 s
+    turtlelib::Transform2D circle(std::int64_t stamp_ns){
+        return turtlelib::integrate_twist(turtlelib::Twist2D{{turtlelib::PI, 0.5, 0.0}}, stamp_ns*1e-9);
+    }
+
+    /// \brief check a transform against another
+    void require_close(const turtlelib::Transform2D & tf, const turtlelib::Transform2D & expected, double margin){
+        REQUIRE(tf.rotation_cos()==Approx(expected.rotation_cos()).margin(margin));
+        REQUIRE(tf.rotation_sin()==Approx(expected.rotation_sin()).margin(margin));
+        REQUIRE(tf.translation().x==Approx(expected.translation().x).margin(margin));
+        REQUIRE(tf.translation().y==Approx(expected.translation().y).margin(margin));
+    }
+}
+
+/// \brief exact samples, SE(2) interpolation between them, extrapolation after them, and the limits
+TEST_CASE("transform buffer lookup","[transform_buffer]"){
+    turtlelib::TransformBuffer buffer(100, 50000000);
+    REQUIRE(buffer.capacity() == 128);
+    REQUIRE(buffer.size() == 0);
+    turtlelib::Transform2D tf;
+    REQUIRE(buffer.lookup(0, tf) == std::errc::result_out_of_range);
+
+    //Samples every 10 ms, 3 s of them, so the ring has wrapped
+    const std::int64_t period = 10000000;
+    for(std::int64_t k = 0; k < 300; k++){
+        REQUIRE(buffer.push(k*period, circle(k*period)) == std::errc{});
+    }
+    REQUIRE(buffer.size() == 128);
+    REQUIRE(buffer.push(299*period, circle(0)) == std::errc::invalid_argument);
+    REQUIRE(buffer.push(100, circle(0)) == std::errc::invalid_argument);
+
+    //Samples come back as pushed
+    REQUIRE(buffer.lookup(250*period, tf) == std::errc{});
+    REQUIRE(tf.rotation() == circle(250*period).rotation());
+    REQUIRE(tf.translation().x == circle(250*period).translation().x);
+    REQUIRE(buffer.lookup(172*period, tf) == std::errc{});
+    REQUIRE(tf.translation().y == circle(172*period).translation().y);
+
+    //The constant twist makes interpolation exact, through the turns past +-PI
+    for(std::int64_t t = 172*period; t < 299*period; t += 1234567){
+        REQUIRE(buffer.lookup(t, tf) == std::errc{});
+        require_close(tf, circle(t), 1e-12);
+    }
+
+    //Extrapolation up to the horizon, and no further
+    REQUIRE(buffer.lookup(299*period + 50000000, tf) == std::errc{});
+    require_close(tf, circle(299*period + 50000000), 1e-12);
+    REQUIRE(buffer.lookup(299*period + 50000001, tf) == std::errc::result_out_of_range);
+
+    //Before the oldest sample kept
+    REQUIRE(buffer.lookup(171*period, tf) == std::errc::result_out_of_range);
+    REQUIRE(buffer.lookup(0, tf) == std::errc::result_out_of_range);
+
+    //One sample can be looked up but not extrapolated
+    turtlelib::TransformBuffer one(1);
+    REQUIRE(one.capacity() == 2);
+    REQUIRE(one.push(-5, circle(0)) == std::errc{});
+    REQUIRE(one.lookup(-5, tf) == std::errc{});
+    REQUIRE(one.lookup(-4, tf) == std::errc::result_out_of_range);
+}
+
+/// \brief readers looking up while the writer wraps the ring see only whole, correct samples
+TEST_CASE("transform buffer concurrent","[transform_buffer]"){
+    turtlelib::TransformBuffer buffer(16, 0);
+    const std::int64_t period = 1000000;
+    const std::int64_t samples = 200000;
+    REQUIRE(buffer.push(0, circle(0)) == std::errc{});
+
+    std::atomic<bool> done{false};
+    std::atomic<std::int64_t> latest{0};
+    std::vector<std::thread> readers;
+    std::vector<int> bad(3, 0);
+    std::vector<int> found(3, 0);
+    for(std::size_t r = 0; r < bad.size(); r++){
+        readers.emplace_back([&, r]{
+            std::int64_t offset = 0;
+            while(!done.load() || found[r] < 100){
+                //Between the samples, on the newest, and behind the oldest as the writer overtakes
+                offset = (offset + 777777) % (20*period);
+                const std::int64_t t = latest.load() - offset;
+                turtlelib::Transform2D tf;
+                if(buffer.lookup(t, tf) == std::errc{}){
+                    const turtlelib::Transform2D expected = circle(t);
+                    bad[r] += std::abs(tf.translation().x - expected.translation().x) > 1e-9;
+                    bad[r] += std::abs(tf.rotation_sin() - expected.rotation_sin()) > 1e-9;
+                    found[r]++;
+                }
+            }
+        });
+    }
+    for(std::int64_t k = 1; k < samples; k++){
+        buffer.push(k*period, circle(k*period));
+        latest = k*period;
+        if(k % 1000 == 0){
+            std::this_thread::yield();
+        }
+    }
+    done = true;
+    for(std::thread & reader : readers){
+        reader.join();
+    }
+    for(std::size_t r = 0; r < bad.size(); r++){
+        REQUIRE(bad[r] == 0);
+        REQUIRE(found[r] >= 100);
+    }
+}